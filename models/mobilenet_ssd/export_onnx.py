@@ -0,0 +1,444 @@
+#!/usr/bin/env python3
+"""
+Exports the Caffe MobileNet-SSD to ONNX and quantizes it to INT8.
+
+Writes the networks loaded by the ONNX Runtime backend (MODEL_ONNX_FILE) and by the INT8 option of either backend
+(MODEL_QUANTIZED_ONNX_FILE). Both take the Nx3xHxW float blob made by the Preprocessor and produce the 1x1xNx7
+output of Caffe's DetectionOutput layer, one [batchId, classId, confidence, left, top, right, bottom] row per
+detection with coordinates relative to the frame.
+
+Caffe's PriorBox and DetectionOutput layers have no ONNX equivalent, so the network is rebuilt from the prototxt and
+the weights read through OpenCV, and the detection output is appended in the form the INT8 network's backend runs:
+  opencv       PriorBox and DetectionOutput nodes, which OpenCV's ONNX importer maps to its own SSD layers
+  onnxruntime  priors, box decoding and NonMaxSuppression in standard ONNX operators
+The full precision network is only run by ONNX Runtime and always takes the second form. Either way, the priors
+follow the input size, so any input size set in the settings works.
+
+Only the convolutions and their activations are quantized, calibrated on frames of the given videos.
+
+Requires numpy, onnx, onnxruntime and opencv-python.
+"""
+import argparse
+import glob
+import os
+import re
+
+import cv2
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+import onnxruntime
+from onnxruntime.quantization import CalibrationDataReader, QuantFormat, QuantType, quantize_static
+
+MODEL_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# The PriorBox parameters Caffe takes several values of, passed to OpenCV as lists
+REPEATED_PRIOR_PARAMETERS = ("min_size", "max_size", "aspect_ratio", "variance")
+
+# Keep in sync with Preprocessor.h
+INPUT_SCALE_FACTOR = 0.007843
+INPUT_MEAN = 127.5
+
+
+def parse_prototxt(text):
+    """Parses a Caffe prototxt into nested dicts, every field holding the list of its values."""
+    text = re.sub(r"#[^\n]*", "", text)
+    tokens = re.findall(r'"[^"]*"|[{}]|[^\s{}:"]+', text)
+
+    def parse_value(token):
+        if token.startswith('"'):
+            return token[1:-1]
+        for convert in (int, float):
+            try:
+                return convert(token)
+            except ValueError:
+                pass
+        return {"true": True, "false": False}.get(token, token)
+
+    def parse_message(pos):
+        message = {}
+        while pos < len(tokens) and tokens[pos] != "}":
+            key = tokens[pos]
+            if tokens[pos + 1] == "{":
+                value, pos = parse_message(pos + 2)
+                pos += 1
+            else:
+                value, pos = parse_value(tokens[pos + 1]), pos + 2
+            message.setdefault(key, []).append(value)
+        return message, pos
+
+    return parse_message(0)[0]
+
+
+def field(message, key, default=None):
+    """Returns the first value of a field, or the default if the field is not set."""
+    return message.get(key, [default])[0]
+
+
+class Graph:
+    """Collects the nodes and initializers of an ONNX graph, naming intermediate tensors uniquely."""
+
+    def __init__(self, prefix):
+        self.prefix = prefix
+        self.nodes = []
+        self.initializers = []
+        self.count = 0
+
+    def name(self, hint):
+        self.count += 1
+        return "%s/%s_%d" % (self.prefix, hint, self.count)
+
+    def constant(self, array, hint="const"):
+        name = self.name(hint)
+        self.initializers.append(numpy_helper.from_array(np.asarray(array), name))
+        return name
+
+    def ints(self, values):
+        return self.constant(np.array(values, dtype=np.int64))
+
+    def floats(self, values):
+        return self.constant(np.array(values, dtype=np.float32))
+
+    def node(self, op, inputs, output=None, outputs=1, **attributes):
+        names = [output or self.name(op.lower())] if outputs == 1 else [self.name(op.lower()) for _ in range(outputs)]
+        self.nodes.append(helper.make_node(op, inputs, names, name=self.name(op), **attributes))
+        return names[0] if outputs == 1 else names
+
+    def slice(self, tensor, start, end, axis):
+        return self.node("Slice", [tensor, self.ints([start]), self.ints([end]), self.ints([axis])])
+
+
+def build_body(prototxt, net):
+    """
+    Rebuilds the network up to the inputs of its DetectionOutput layer, with the weights loaded by OpenCV.
+    Returns the ONNX model and the DetectionOutput layer, with its location and confidence inputs and the PriorBox
+    layers of its priors paired with the feature maps they are computed for. The feature maps are outputs of the
+    model, so they keep their names when it is quantized.
+    """
+    layers = parse_prototxt(prototxt)["layer"]
+    graph = Graph("body")
+    tensors = {"data": "data"}
+    priorBoxes = {}
+    detection = None
+
+    for layer in layers:
+        kind = field(layer, "type")
+        name = field(layer, "name")
+        bottoms = layer.get("bottom", [])
+        top = field(layer, "top")
+
+        # The priors only depend on the input and feature map sizes and are appended with the detection output
+        if kind == "PriorBox":
+            priorBoxes[top] = (layer, tensors[bottoms[0]])
+            continue
+
+        if kind == "Concat" and all(bottom in priorBoxes for bottom in bottoms):
+            priorBoxes[top] = [priorBoxes[bottom] for bottom in bottoms]
+            continue
+
+        if kind == "DetectionOutput":
+            detection = layer
+            continue
+
+        inputs = [tensors[bottom] for bottom in bottoms]
+
+        # In-place layers write a new tensor, ONNX tensors are assigned once
+        output = graph.name(top) if top in tensors else top
+
+        if kind == "Convolution":
+            param = field(layer, "convolution_param")
+            kernel = field(param, "kernel_size")
+            pad = field(param, "pad", 0)
+            stride = field(param, "stride", 1)
+            dilation = field(param, "dilation", 1)
+            layerId = net.getLayerId(name)
+            inputs.append(graph.constant(net.getParam(layerId, 0).astype(np.float32), name + "/weights"))
+            if field(param, "bias_term", True):
+                inputs.append(graph.constant(net.getParam(layerId, 1).reshape(-1).astype(np.float32), name + "/bias"))
+            graph.node("Conv", inputs, output, kernel_shape=[kernel, kernel], pads=[pad] * 4, strides=[stride, stride],
+                       dilations=[dilation, dilation], group=field(param, "group", 1))
+        elif kind == "ReLU":
+            slope = field(field(layer, "relu_param", {}), "negative_slope", 0.0)
+            if slope:
+                graph.node("LeakyRelu", inputs, output, alpha=slope)
+            else:
+                graph.node("Relu", inputs, output)
+        elif kind == "Permute":
+            graph.node("Transpose", inputs, output, perm=field(layer, "permute_param")["order"])
+        elif kind == "Flatten":
+            graph.node("Flatten", inputs, output, axis=field(field(layer, "flatten_param", {}), "axis", 1))
+        elif kind == "Concat":
+            graph.node("Concat", inputs, output, axis=field(field(layer, "concat_param", {}), "axis", 1))
+        elif kind == "Reshape":
+            shape = field(field(layer, "reshape_param"), "shape")["dim"]
+            graph.node("Reshape", inputs + [graph.ints(shape)], output)
+        elif kind == "Softmax":
+            graph.node("Softmax", inputs, output, axis=field(field(layer, "softmax_param", {}), "axis", 1))
+        else:
+            raise ValueError("Unsupported layer %s of type %s" % (name, kind))
+
+        tensors[top] = output
+
+    if detection is None:
+        raise ValueError("The network has no DetectionOutput layer")
+
+    loc, conf, priors = detection["bottom"]
+    detection = (detection, tensors[loc], tensors[conf], priorBoxes[priors])
+    features = sorted(set(feature for _, feature in detection[3]))
+
+    model = helper.make_model(
+        helper.make_graph(graph.nodes, "MobileNet-SSD",
+                          [helper.make_tensor_value_info("data", TensorProto.FLOAT, ["batch", 3, "height", "width"])],
+                          [helper.make_tensor_value_info(tensor, TensorProto.FLOAT, None)
+                           for tensor in [detection[1], detection[2]] + features],
+                          graph.initializers),
+        opset_imports=[helper.make_opsetid("", 13)])
+
+    return model, detection
+
+
+def prior_boxes(graph, param, feature):
+    """
+    Computes the priors of a PriorBox layer from the sizes of the input and of its feature map, as Caffe does.
+    Returns the Px4 [left, top, right, bottom] priors relative to the input and their Px4 variances.
+    """
+    if any(key in param for key in ("step", "step_h", "step_w", "img_size", "img_h", "img_w")):
+        raise ValueError("Only priors spread evenly over the feature map are computed")
+
+    ratios = [1.0]
+    for ratio in param.get("aspect_ratio", []):
+        if all(abs(ratio - other) > 1e-6 for other in ratios):
+            ratios.append(ratio)
+            if field(param, "flip", True):
+                ratios.append(1.0 / ratio)
+
+    # The boxes at every location in pixels, in Caffe's order
+    sizes = []
+    maxSizes = param.get("max_size", [])
+    for index, minSize in enumerate(param["min_size"]):
+        sizes.append((minSize, minSize))
+        if maxSizes:
+            sizes.append((np.sqrt(minSize * maxSizes[index]),) * 2)
+        sizes.extend((minSize * np.sqrt(ratio), minSize / np.sqrt(ratio)) for ratio in ratios[1:])
+
+    featureShape = graph.node("Shape", [feature])
+    inputShape = graph.node("Shape", ["data"])
+    offset = field(param, "offset", 0.5)
+
+    def dimension(shape, axis):
+        return graph.node("Gather", [shape, graph.constant(np.array(axis, dtype=np.int64))], axis=0)
+
+    def centers(count):
+        positions = graph.node("Cast", [graph.node("Range", [graph.constant(np.array(0, dtype=np.int64)), count,
+                                                             graph.constant(np.array(1, dtype=np.int64))])], to=TensorProto.FLOAT)
+        return graph.node("Div", [graph.node("Add", [positions, graph.floats(offset)]), graph.node("Cast", [count], to=TensorProto.FLOAT)])
+
+    def halves(values, axis):
+        size = graph.node("Cast", [dimension(inputShape, axis)], to=TensorProto.FLOAT)
+        return graph.node("Reshape", [graph.node("Div", [graph.floats(values), size]), graph.ints([1, 1, -1])])
+
+    rows, columns = dimension(featureShape, 2), dimension(featureShape, 3)
+    x = graph.node("Reshape", [centers(columns), graph.ints([1, -1, 1])])
+    y = graph.node("Reshape", [centers(rows), graph.ints([-1, 1, 1])])
+    halfWidths = halves([width / 2 for width, _ in sizes], 3)
+    halfHeights = halves([height / 2 for _, height in sizes], 2)
+
+    # Rows x columns x boxes x 4, flattened in Caffe's order
+    grid = graph.node("Concat", [graph.node("Unsqueeze", [rows, graph.ints([0])]),
+                                 graph.node("Unsqueeze", [columns, graph.ints([0])]), graph.ints([len(sizes)])], axis=0)
+    corners = [graph.node("Unsqueeze", [graph.node("Expand", [graph.node(op, [center, half]), grid]), graph.ints([3])])
+               for op, center, half in (("Sub", x, halfWidths), ("Sub", y, halfHeights), ("Add", x, halfWidths), ("Add", y, halfHeights))]
+    boxes = graph.node("Reshape", [graph.node("Concat", corners, axis=3), graph.ints([-1, 4])])
+
+    if field(param, "clip", False):
+        boxes = graph.node("Clip", [boxes, graph.floats(0.0), graph.floats(1.0)])
+
+    variance = param.get("variance", [0.1])
+    variances = graph.node("Expand", [graph.floats([variance * 4 if len(variance) == 1 else variance]), graph.node("Shape", [boxes])])
+
+    return boxes, variances
+
+
+def add_detection_output(model, detection, target):
+    """Replaces the outputs of the body with the 1x1xNx7 detection output, in the form the target runtime runs."""
+    layer, loc, conf, priorBoxes = detection
+    param = field(layer, "detection_output_param")
+    nms = field(param, "nms_param", {})
+    classes = field(param, "num_classes")
+    background = field(param, "background_label_id", 0)
+    threshold = field(param, "confidence_threshold", 0.0)
+    graph = Graph("detection_out")
+
+    if target == "opencv":
+        # OpenCV's ONNX importer creates its own PriorBox and DetectionOutput layers from these nodes, with Caffe's
+        # parameters as attributes
+        priors = []
+        for prior, feature in priorBoxes:
+            attributes = {key: values if key in REPEATED_PRIOR_PARAMETERS else values[0]
+                          for key, values in field(prior, "prior_box_param").items()}
+            priors.append(graph.node("PriorBox", [feature, "data"], **attributes))
+
+        graph.node("DetectionOutput", [loc, conf, graph.node("Concat", priors, axis=2)], "detection_out",
+                   num_classes=classes, share_location=field(param, "share_location", True), background_label_id=background,
+                   nms_threshold=field(nms, "nms_threshold", 0.45), top_k=field(nms, "top_k", -1),
+                   code_type=field(param, "code_type", "CENTER_SIZE"), keep_top_k=field(param, "keep_top_k", -1),
+                   confidence_threshold=threshold)
+    else:
+        if background != 0 or field(param, "code_type", "CENTER_SIZE") != "CENTER_SIZE":
+            raise ValueError("Only CENTER_SIZE boxes with background class 0 are decoded")
+
+        priors = [prior_boxes(graph, field(prior, "prior_box_param"), feature) for prior, feature in priorBoxes]
+        boxes = graph.node("Concat", [boxes for boxes, _ in priors], axis=0)
+        variances = graph.node("Concat", [variances for _, variances in priors], axis=0)
+        minimums, maximums = graph.slice(boxes, 0, 2, 1), graph.slice(boxes, 2, 4, 1)
+        priorSizes = graph.node("Sub", [maximums, minimums])
+        priorCenters = graph.node("Mul", [graph.node("Add", [minimums, maximums]), graph.floats(0.5)])
+
+        # Center-size decoding, as Caffe's DetectionOutput does it
+        offsets = graph.node("Mul", [graph.node("Reshape", [loc, graph.ints([0, -1, 4])]), variances])
+        centers = graph.node("Add", [graph.node("Mul", [graph.slice(offsets, 0, 2, 2), priorSizes]), priorCenters])
+        halves = graph.node("Mul", [graph.node("Exp", [graph.slice(offsets, 2, 4, 2)]),
+                                    graph.node("Mul", [priorSizes, graph.floats(0.5)])])
+        decoded = graph.node("Concat", [graph.node("Sub", [centers, halves]), graph.node("Add", [centers, halves])], axis=2)
+
+        # Scores per class without the background, 1xCxP as NonMaxSuppression takes them
+        scores = graph.node("Transpose", [graph.node("Reshape", [conf, graph.ints([0, -1, classes])])], perm=[0, 2, 1])
+        scores = graph.slice(scores, 1, classes, 1)
+
+        # Boxes are [left, top, right, bottom] rather than [top, left, bottom, right], which gives the same overlaps
+        selected = graph.node("NonMaxSuppression", [decoded, scores, graph.ints([field(nms, "top_k", 100)]),
+                                                    graph.floats([field(nms, "nms_threshold", 0.45)]), graph.floats([threshold])])
+
+        # Keep the most confident detections over every class, keep_top_k for each frame of the batch on average
+        confidences = graph.node("GatherND", [scores, selected])
+        frames = graph.slice(graph.node("Shape", ["data"]), 0, 1, 0)
+        count = graph.node("Min", [graph.node("Shape", [confidences]),
+                                   graph.node("Mul", [frames, graph.ints([field(param, "keep_top_k", 100)])])])
+        confidences, kept = graph.node("TopK", [confidences, count], outputs=2)
+        selected = graph.node("Gather", [selected, kept], axis=0)
+
+        batch = graph.node("Cast", [graph.slice(selected, 0, 1, 1)], to=TensorProto.FLOAT)
+        labels = graph.node("Add", [graph.node("Cast", [graph.slice(selected, 1, 2, 1)], to=TensorProto.FLOAT), graph.floats([1])])
+        corners = graph.node("GatherND", [decoded, graph.node("Concat", [graph.slice(selected, 0, 1, 1), graph.slice(selected, 2, 3, 1)], axis=1)])
+        rows = graph.node("Concat", [batch, labels, graph.node("Unsqueeze", [confidences, graph.ints([1])]), corners], axis=1)
+        graph.node("Reshape", [rows, graph.ints([1, 1, -1, 7])], "detection_out")
+
+    model.graph.node.extend(graph.nodes)
+    model.graph.initializer.extend(graph.initializers)
+    del model.graph.output[:]
+    model.graph.output.append(helper.make_tensor_value_info("detection_out", TensorProto.FLOAT, [1, 1, "detections", 7]))
+
+    # The checker rejects PriorBox and DetectionOutput, which are not ONNX operators
+    if target != "opencv":
+        onnx.checker.check_model(model)
+
+    return model
+
+
+def check_batch(path, target, blobs):
+    """
+    Runs two frames through an exported network in one batch, as the detectors do when tiling or batching requests.
+    Returns false if the runtime rejects the batch or mixes up its frames.
+    """
+    batch = np.concatenate([blobs[0], blobs[-1]])
+
+    try:
+        if target == "opencv":
+            net = cv2.dnn.readNetFromONNX(path)
+            net.setInput(batch)
+            output = net.forward()
+        else:
+            session = onnxruntime.InferenceSession(path, providers=["CPUExecutionProvider"])
+            output = session.run(None, {"data": batch})[0]
+    except Exception as error:
+        print("%s rejected a batch of two frames: %s" % (path, error))
+        return False
+
+    # Caffe's DetectionOutput answers a frame without detections with a single row of batch -1
+    if output.shape[-1] != 7 or not np.isin(output.reshape(-1, 7)[:, 0], [-1, 0, 1]).all():
+        print("%s produced a %s output for a batch of two frames" % (path, output.shape))
+        return False
+
+    return True
+
+
+class FrameReader(CalibrationDataReader):
+    """Feeds evenly spaced frames of the calibration videos to the quantizer, preprocessed as the Preprocessor does."""
+
+    def __init__(self, videos, count, size):
+        self.blobs = []
+        perVideo = max(count // max(len(videos), 1), 1)
+
+        for video in videos:
+            capture = cv2.VideoCapture(video)
+            total = int(capture.get(cv2.CAP_PROP_FRAME_COUNT)) or perVideo
+            step = max(total // perVideo, 1)
+
+            for index in range(0, total, step):
+                capture.set(cv2.CAP_PROP_POS_FRAMES, index)
+                read, frame = capture.read()
+                if not read or len(self.blobs) >= count:
+                    break
+                self.blobs.append(cv2.dnn.blobFromImage(frame, INPUT_SCALE_FACTOR, size, INPUT_MEAN))
+
+        if not self.blobs:
+            raise ValueError("No calibration frames could be read")
+
+        self.iterator = iter(self.blobs)
+
+    def get_next(self):
+        blob = next(self.iterator, None)
+        return None if blob is None else {"data": blob}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--prototxt", default=os.path.join(MODEL_DIR, "MobileNetSSD_deploy.prototxt"))
+    parser.add_argument("--caffemodel", default=os.path.join(MODEL_DIR, "MobileNetSSD_deploy.caffemodel"))
+    parser.add_argument("--output", default=os.path.join(MODEL_DIR, "MobileNetSSD_deploy.onnx"),
+                        help="the full precision network, MODEL_ONNX_FILE")
+    parser.add_argument("--quantized-output", default=os.path.join(MODEL_DIR, "MobileNetSSD_deploy_int8.onnx"),
+                        help="the INT8 network, MODEL_QUANTIZED_ONNX_FILE")
+    parser.add_argument("--target", choices=["onnxruntime", "opencv"], default="opencv",
+                        help="the backend the INT8 network runs on, the full precision one always runs on ONNX Runtime")
+    parser.add_argument("--width", type=int, default=300, help="the input width calibration frames are resized to")
+    parser.add_argument("--height", type=int, default=300, help="the input height calibration frames are resized to")
+    parser.add_argument("--calibration-frames", type=int, default=200)
+    parser.add_argument("videos", nargs="*", help="videos to calibrate on, every test_videos/*.mp4 by default")
+    args = parser.parse_args()
+
+    videos = args.videos or sorted(glob.glob(os.path.join(MODEL_DIR, "..", "..", "test_videos", "*.mp4")))
+
+    with open(args.prototxt) as file:
+        prototxt = file.read()
+
+    body, detection = build_body(prototxt, cv2.dnn.readNetFromCaffe(args.prototxt, args.caffemodel))
+    onnx.checker.check_model(body)
+
+    # Calibrate and quantize the network without its detection output, which stays in float and which ONNX Runtime
+    # cannot run in OpenCV's form
+    bodyFile = args.quantized_output + ".body.onnx"
+    quantizedFile = args.quantized_output + ".body_int8.onnx"
+    onnx.save(body, bodyFile)
+    frames = FrameReader(videos, args.calibration_frames, (args.width, args.height))
+    quantize_static(bodyFile, quantizedFile, frames,
+                    quant_format=QuantFormat.QOperator, op_types_to_quantize=["Conv", "Relu"], per_channel=True,
+                    activation_type=QuantType.QUInt8, weight_type=QuantType.QInt8)
+
+    onnx.save(add_detection_output(body, detection, "onnxruntime"), args.output)
+    onnx.save(add_detection_output(onnx.load(quantizedFile), detection, args.target), args.quantized_output)
+
+    os.remove(bodyFile)
+    os.remove(quantizedFile)
+
+    # The OpenCV detector falls back to one forward pass per frame if its network rejects batches
+    for path, target in ((args.output, "onnxruntime"), (args.quantized_output, args.target)):
+        if not check_batch(path, target, frames.blobs) and target == "opencv":
+            print("The OpenCV detector will detect tiles and batched requests one frame at a time")
+
+    print("Wrote %s and %s (%s), output 1x1xNx7 [batchId, classId, confidence, left, top, right, bottom]"
+          % (args.output, args.quantized_output, args.target))
+
+
+if __name__ == "__main__":
+    main()
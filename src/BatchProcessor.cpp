@@ -0,0 +1,684 @@
+/**
+ * @file BatchProcessor.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Counts people in recorded video files from the command line, without a GUI
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "BatchProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <iostream>
+#include <utility>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QSettings>
+
+#include "FramePool.h"
+#include "ModelRegistry.h"
+#include "VideoSource.h"
+
+/**
+ * @brief Constructs a new BatchProcessor object.
+ */
+BatchProcessor::BatchProcessor() {
+    decoderOptions = { 0, VideoDecoder::AutoThreads };
+}
+
+/**
+ * @brief Destructs a BatchProcessor object.
+ */
+BatchProcessor::~BatchProcessor() {
+
+}
+
+/**
+ * @brief Parses the command line, processes every given file and writes the event log and summary.
+ * @param arguments the application's command line arguments.
+ * @return the process exit code, zero if every file was processed and the outputs were written.
+ */
+int BatchProcessor::run(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Counts people entering and exiting in recorded video files.");
+    parser.addHelpOption();
+    parser.addOption({ "batch", "Process the given files without a GUI." });
+    parser.addOption({ { "o", "output" }, "Directory to write events.csv and summary.csv to.", "directory", "." });
+    parser.addOption({ { "d", "direction" }, "Enter direction: up, down, left or right (defaults to the saved setting).", "direction" });
+    parser.addOption({ "compare", "Process every file with the full precision and the INT8-quantized detector and write "
+                                  "comparison.csv and latency.csv instead (defaults to " DEFAULT_COMPARISON_DIRECTORY "/*.mp4)." });
+    parser.addOption({ "calibrate", "Replay the given sample clips with every tracker algorithm, write calibration.csv and "
+                                    "recommend the cheapest algorithm meeting the target accuracy." });
+    parser.addOption({ "target", "Count accuracy the recommended tracker algorithm must reach, between 0 and 1.", "accuracy",
+                       QString::number(DEFAULT_CALIBRATION_TARGET) });
+    parser.addOption({ "expected", "True number of people entering and exiting in the sample clips, measured against "
+                                   "instead of the most robust algorithm.", "entered,exited" });
+    parser.addOption({ "apply", "Save the recommended tracker algorithm to the settings." });
+    parser.addOption({ "decoder-threads", "Number of threads decoding each file, 0 for one per core (defaults to the saved setting).", "threads" });
+    parser.addOption({ "decoder-mode", "How decoding is split between threads: auto, frame or slice (defaults to the saved setting).", "mode" });
+    parser.addPositionalArgument("files", "The video files to process.", "files...");
+    parser.process(arguments);
+
+    const bool compare = parser.isSet("compare");
+    QStringList files = parser.positionalArguments();
+
+    // The comparison runs over the test videos unless told otherwise
+    if (files.isEmpty() && compare) {
+        const QDir directory(DEFAULT_COMPARISON_DIRECTORY);
+
+        for (const auto& name : directory.entryList({ "*.mp4" }, QDir::Files, QDir::Name)) {
+            files.append(directory.filePath(name));
+        }
+    }
+
+    if (files.isEmpty()) {
+        std::cerr << "No video files given." << std::endl;
+        return 1;
+    }
+
+    // Use the saved tracker settings unless overridden on the command line
+    QSettings settings;
+    auto enterDirection = static_cast<ObjectTracker::EnterDirection>(settings.value("tracker/enterDirection").toUInt());
+
+    if (parser.isSet("direction")) {
+        const QStringList directions = { "up", "down", "left", "right" };
+        const int index = directions.indexOf(parser.value("direction").toLower());
+
+        if (index < 0) {
+            std::cerr << "Unknown enter direction: " << parser.value("direction").toStdString() << std::endl;
+            return 1;
+        }
+
+        enterDirection = static_cast<ObjectTracker::EnterDirection>(index);
+    }
+
+    decoderOptions.threads = settings.value("capture/decoderThreads", 0).toInt();
+    decoderOptions.mode = static_cast<VideoDecoder::ThreadMode>(settings.value("capture/decoderThreadMode", VideoDecoder::AutoThreads).toUInt());
+
+    if (parser.isSet("decoder-threads")) {
+        bool valid = false;
+        decoderOptions.threads = parser.value("decoder-threads").toInt(&valid);
+
+        if (!valid || decoderOptions.threads < 0) {
+            std::cerr << "Invalid number of decoder threads: " << parser.value("decoder-threads").toStdString() << std::endl;
+            return 1;
+        }
+    }
+
+    if (parser.isSet("decoder-mode")) {
+        const QStringList modes = { "auto", "frame", "slice" };
+        const int index = modes.indexOf(parser.value("decoder-mode").toLower());
+
+        if (index < 0) {
+            std::cerr << "Unknown decoder threading mode: " << parser.value("decoder-mode").toStdString() << std::endl;
+            return 1;
+        }
+
+        decoderOptions.mode = static_cast<VideoDecoder::ThreadMode>(index);
+    }
+
+    if (decoderOptions.mode != VideoDecoder::AutoThreads && !VideoDecoder::isLibavAvailable()) {
+        std::cerr << "Built without FFmpeg's libraries, only the number of decoder threads applies." << std::endl;
+    }
+
+    const QDir output(parser.value("output"));
+
+    if (!output.exists() && !QDir().mkpath(output.path())) {
+        std::cerr << "Could not create output directory: " << output.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    bool succeeded = true;
+
+    if (parser.isSet("calibrate")) {
+        int expectedEntered = -1;
+        int expectedExited = -1;
+
+        if (parser.isSet("expected")) {
+            const QStringList expected = parser.value("expected").split(",");
+
+            if (expected.size() != 2) {
+                std::cerr << "Expected counts must be given as entered,exited: " << parser.value("expected").toStdString() << std::endl;
+                return 1;
+            }
+
+            expectedEntered = expected[0].toInt();
+            expectedExited = expected[1].toInt();
+        }
+
+        if (!calibrate(files, enterDirection, expectedEntered, expectedExited)) {
+            return 1;
+        }
+
+        const double target = parser.value("target").toDouble();
+        const int recommended = recommend(target);
+        const auto& calibration = calibrations[recommended];
+        const auto name = TrackedObject::getAlgorithmName(calibration.algorithm);
+
+        if (calibration.accuracy < target) {
+            std::cout << "No tracker algorithm reaches the target accuracy, the most accurate one is " << name << std::endl;
+        } else {
+            std::cout << "Recommended tracker algorithm: " << name << " (" << calibration.objectFrameTime
+                      << " ms per object per frame, accuracy " << calibration.accuracy << ")" << std::endl;
+        }
+
+        if (parser.isSet("apply")) {
+            settings.setValue("tracker/algorithm", static_cast<int>(calibration.algorithm));
+        }
+
+        return writeCalibration(output.filePath("calibration.csv").toStdString(), recommended) ? 0 : 1;
+    }
+
+    if (compare) {
+        // Both trackers share every setting except the network they detect with
+        ObjectTracker reference;
+        configure(reference, enterDirection);
+        reference.setQuantizedDetector(false);
+
+        ObjectTracker quantized;
+        configure(quantized, enterDirection);
+        quantized.setQuantizedDetector(true);
+
+        // Without the INT8 model both trackers would run the same network
+        if (!reference.resolveDetector() || !quantized.resolveDetector()) {
+            std::cerr << "The models to compare are not available, see the README for how to export them." << std::endl;
+            return 1;
+        }
+
+        // Warm both networks up front, so neither comparison includes its one-time initialization
+        ModelRegistry::instance().warmUp(reference.getDetectorOptions(), reference.getInputSize());
+        ModelRegistry::instance().warmUp(quantized.getDetectorOptions(), quantized.getInputSize());
+
+        for (const auto& file : files) {
+            succeeded = compareFile(file, reference, quantized) && succeeded;
+        }
+
+        succeeded = writeComparison(output.filePath("comparison.csv").toStdString()) && succeeded;
+        succeeded = writeLatencies(output.filePath("latency.csv").toStdString()) && succeeded;
+
+        return succeeded ? 0 : 1;
+    }
+
+    ObjectTracker tracker;
+    configure(tracker, enterDirection);
+    ModelRegistry::instance().warmUp(tracker.getDetectorOptions(), tracker.getInputSize());
+
+    for (const auto& file : files) {
+        tracker.reset();
+        succeeded = processFile(file, tracker) && succeeded;
+    }
+
+    succeeded = writeEventLog(output.filePath("events.csv").toStdString()) && succeeded;
+    succeeded = writeSummary(output.filePath("summary.csv").toStdString()) && succeeded;
+    succeeded = writeTrackingTimes(output.filePath("tracking.csv").toStdString(), tracker) && succeeded;
+
+    return succeeded ? 0 : 1;
+}
+
+/**
+ * @brief Applies the saved tracker settings to a tracker used for batch processing.
+ * @param tracker the tracker to configure.
+ * @param enterDirection the enter direction to use.
+ */
+void BatchProcessor::configure(ObjectTracker& tracker, const ObjectTracker::EnterDirection enterDirection) {
+    tracker.loadSettings();
+    tracker.setEnterDirection(enterDirection);
+
+    // Detect on the frame being processed, so counts do not depend on how fast the machine is
+    tracker.setDetectionMode(ObjectTracker::SynchronousDetection);
+
+    // Only track and count, no drawing or image conversion
+    tracker.setRenderMode(ObjectTracker::NoRendering);
+
+    // Files are processed one at a time, every tracker detects on the same frames so their results can be compared
+    tracker.setStaggeredDetection(false);
+
+    // A missing INT8 or ONNX model falls back to the full precision one, without changing the saved settings
+    tracker.resolveDetector();
+
+    // Files are processed as fast as possible, without deadlines, so nothing is ever degraded
+    auto budget = tracker.getBudget();
+    budget.enabled = false;
+    tracker.setBudget(budget);
+}
+
+/**
+ * @brief Processes a video file once with the full precision and once with the quantized detector.
+ * @param filepath the video file to process.
+ * @param reference the tracker detecting with the full precision network.
+ * @param quantized the tracker detecting with the quantized network.
+ * @return true if the file could be opened, false otherwise.
+ */
+bool BatchProcessor::compareFile(const QString& filepath, ObjectTracker& reference, ObjectTracker& quantized) {
+    Comparison comparison;
+
+    reference.reset();
+
+    if (!processFile(filepath, reference, &comparison.referenceLatencies)) {
+        return false;
+    }
+
+    comparison.reference = summaries.back();
+
+    quantized.reset();
+
+    if (!processFile(filepath, quantized, &comparison.quantizedLatencies)) {
+        return false;
+    }
+
+    comparison.quantized = summaries.back();
+    comparisons.push_back(std::move(comparison));
+
+    const auto& result = comparisons.back();
+    std::cout << result.reference.file << ": entered " << result.reference.entered << " -> " << result.quantized.entered
+              << ", exited " << result.reference.exited << " -> " << result.quantized.exited
+              << ", p95 latency " << percentile(result.referenceLatencies, 0.95) << " ms -> "
+              << percentile(result.quantizedLatencies, 0.95) << " ms" << std::endl;
+
+    return true;
+}
+
+/**
+ * @brief Replays sample clips with every tracker algorithm, measuring their cost and count accuracy.
+ * Counts are compared with the expected counts if given, or else with those of the most robust algorithm (CSRT).
+ * Objects are updated sequentially, so the measured time is the cost of one object rather than the parallel wall time.
+ * @param files the sample clips to replay.
+ * @param enterDirection the enter direction to use.
+ * @param expectedEntered the true number of people entering in all clips, negative if unknown.
+ * @param expectedExited the true number of people exiting in all clips, negative if unknown.
+ * @return true if every clip could be opened.
+ */
+bool BatchProcessor::calibrate(const QStringList& files, const ObjectTracker::EnterDirection enterDirection, const int expectedEntered, const int expectedExited) {
+    const std::vector<TrackedObject::Algorithm> algorithms = { TrackedObject::OpticalFlowTracker, TrackedObject::MosseTracker, TrackedObject::KcfTracker,
+                                                               TrackedObject::CsrtTracker };
+
+    for (const auto algorithm : algorithms) {
+        ObjectTracker tracker;
+        configure(tracker, enterDirection);
+        tracker.setTrackerAlgorithm(algorithm);
+        tracker.setParallelTracking(false);
+        ModelRegistry::instance().warmUp(tracker.getDetectorOptions(), tracker.getInputSize());
+
+        Calibration calibration = { algorithm, {}, 0, 0 };
+
+        for (const auto& file : files) {
+            tracker.reset();
+
+            if (!processFile(file, tracker)) {
+                return false;
+            }
+
+            calibration.summaries.push_back(summaries.back());
+        }
+
+        double time = 0;
+        unsigned long long objectFrames = 0;
+        const auto times = tracker.getTrackingTimes();
+
+        for (std::size_t count = 1; count < times.size(); count++) {
+            time += times[count].total;
+            objectFrames += count * times[count].frames;
+        }
+
+        calibration.objectFrameTime = objectFrames > 0 ? time / objectFrames : 0;
+        calibrations.push_back(std::move(calibration));
+    }
+
+    // Count errors of each clip against the truth, or against the most robust algorithm, which comes last
+    const auto& reference = calibrations.back().summaries;
+
+    for (auto& calibration : calibrations) {
+        double errors = 0;
+        double total = 0;
+
+        if (expectedEntered >= 0 && expectedExited >= 0) {
+            unsigned int entered = 0;
+            unsigned int exited = 0;
+
+            for (const auto& summary : calibration.summaries) {
+                entered += summary.entered;
+                exited += summary.exited;
+            }
+
+            errors = std::abs(static_cast<int>(entered) - expectedEntered) + std::abs(static_cast<int>(exited) - expectedExited);
+            total = expectedEntered + expectedExited;
+        } else {
+            for (std::size_t i = 0; i < calibration.summaries.size(); i++) {
+                errors += std::abs(static_cast<int>(calibration.summaries[i].entered) - static_cast<int>(reference[i].entered))
+                          + std::abs(static_cast<int>(calibration.summaries[i].exited) - static_cast<int>(reference[i].exited));
+                total += reference[i].entered + reference[i].exited;
+            }
+        }
+
+        calibration.accuracy = std::max(0.0, 1.0 - errors / std::max(total, 1.0));
+
+        std::cout << TrackedObject::getAlgorithmName(calibration.algorithm) << ": " << calibration.objectFrameTime
+                  << " ms per object per frame, accuracy " << calibration.accuracy << std::endl;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the cheapest calibrated tracker algorithm reaching the target accuracy.
+ * If none reaches it, returns the most accurate one instead, the cheapest among equally accurate ones.
+ * @param target the count accuracy to reach, between 0 and 1.
+ * @return the index of the recommended calibration.
+ */
+int BatchProcessor::recommend(const double target) const {
+    int best = 0;
+
+    for (std::size_t i = 1; i < calibrations.size(); i++) {
+        const auto& current = calibrations[i];
+        const auto& chosen = calibrations[best];
+        const bool currentMeets = current.accuracy >= target;
+        const bool chosenMeets = chosen.accuracy >= target;
+
+        if (currentMeets != chosenMeets) {
+            best = currentMeets ? static_cast<int>(i) : best;
+        } else if (!currentMeets && current.accuracy != chosen.accuracy) {
+            best = current.accuracy > chosen.accuracy ? static_cast<int>(i) : best;
+        } else if (current.objectFrameTime < chosen.objectFrameTime) {
+            best = static_cast<int>(i);
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Decodes and tracks every frame of a video file as fast as possible, recording enter/exit events.
+ * @param filepath the video file to process.
+ * @param tracker the tracker to process the frames with, reset beforehand.
+ * @param latencies if given, receives the time spent processing each frame in milliseconds, excluding decoding.
+ * @return true if the file could be opened, false otherwise.
+ */
+bool BatchProcessor::processFile(const QString& filepath, ObjectTracker& tracker, std::vector<double> *latencies) {
+    VideoDecoder capture;
+    capture.setOptions(decoderOptions);
+
+    if (!capture.open(filepath.toStdString())) {
+        std::cerr << "Could not open video file: " << filepath.toStdString() << std::endl;
+        return false;
+    }
+
+    // Event times are given in video time, fall back to the default rate if the file does not report one
+    double fps = capture.get(cv::CAP_PROP_FPS);
+
+    if (!std::isfinite(fps) || fps <= 0) {
+        fps = DEFAULT_CAPTURE_FPS;
+    }
+
+    Summary summary = { filepath.toStdString(), 0, 0, 0, 0, 0, 0 };
+
+    // The tracker's counters span every file, only count the frames skipped in this one
+    const auto skippedBefore = tracker.getSkippedFrameCount();
+
+    // Record events against the frame currently being processed
+    unsigned int frameNumber = 0;
+
+    auto entered = QObject::connect(&tracker, &ObjectTracker::personEntered, [&](const QString& line) {
+        events.push_back({ summary.file, frameNumber, frameNumber / fps, true, line.toStdString() });
+        summary.entered++;
+    });
+
+    auto exited = QObject::connect(&tracker, &ObjectTracker::personExited, [&](const QString& line) {
+        events.push_back({ summary.file, frameNumber, frameNumber / fps, false, line.toStdString() });
+        summary.exited++;
+    });
+
+    // Frames are processed synchronously, a second buffer lets decoding reuse memory without waiting
+    FramePool pool(2);
+    pool.reserve(cv::Size(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                          static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT))), CV_8UC3);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    QElapsedTimer frameClock;
+
+    while (true) {
+        FrameHandle frame = pool.acquire();
+
+        if (frame.isNull() || !capture.read(frame.mat())) {
+            break;
+        }
+
+        frameClock.start();
+        tracker.processFrame(std::move(frame));
+
+        if (latencies != nullptr) {
+            latencies->push_back(frameClock.nsecsElapsed() / 1e6);
+        }
+
+        frameNumber++;
+    }
+
+    QObject::disconnect(entered);
+    QObject::disconnect(exited);
+
+    summary.frames = frameNumber;
+    summary.skipped = tracker.getSkippedFrameCount() - skippedBefore;
+    summary.seconds = clock.nsecsElapsed() / 1e9;
+    summary.decodeSeconds = capture.getDecodeTime();
+    summaries.push_back(summary);
+
+    std::cout << summary.file << ": " << summary.frames << " frames in " << summary.seconds << " s ("
+              << (summary.seconds > 0 ? summary.frames / summary.seconds : 0) << " fps, "
+              << summary.skipped << " skipped without motion), "
+              << summary.entered << " entered, " << summary.exited << " exited" << std::endl;
+
+    // Decoding is reported on its own, a decode rate close to the overall rate means the file is decode-bound
+    std::cout << summary.file << ": decoded in " << summary.decodeSeconds << " s (" << capture.getDecodeRate() << " fps) with "
+              << capture.getBackendName() << " on " << capture.getThreadCount() << " threads" << std::endl;
+
+    return true;
+}
+
+/**
+ * @brief Writes every recorded enter/exit event to a csv file.
+ * Each row holds the file, the frame number, the video time in seconds, the event and the line it was counted across.
+ * @param filename the name of the csv file to write.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeEventLog(const std::string& filename) const {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write event log: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "file,frame,time,event,line\n";
+
+    for (const auto& event : events) {
+        writeOutput << event.file << "," << event.frame << "," << event.time << ","
+                    << (event.entered ? "entered" : "exited") << "," << event.line << "\n";
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Writes the totals of every processed file to a csv file.
+ * Each row holds the file, the number of frames, the number of frames skipped without motion, the number of people entered and exited,
+ * the processing time in seconds and the resulting processing rate, and the part of it spent decoding and the resulting decoding rate.
+ * @param filename the name of the csv file to write.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeSummary(const std::string& filename) const {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write summary: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "file,frames,skipped,entered,exited,seconds,fps,decode_seconds,decode_fps\n";
+
+    for (const auto& summary : summaries) {
+        writeOutput << summary.file << "," << summary.frames << "," << summary.skipped << "," << summary.entered << "," << summary.exited << ","
+                    << summary.seconds << "," << (summary.seconds > 0 ? summary.frames / summary.seconds : 0) << ","
+                    << summary.decodeSeconds << "," << (summary.decodeSeconds > 0 ? summary.frames / summary.decodeSeconds : 0) << "\n";
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Writes the time a tracker spent updating objects per frame to a csv file.
+ * Each row holds the number of objects in a frame, the number of such frames and the mean and longest time in milliseconds.
+ * @param filename the name of the csv file to write.
+ * @param tracker the tracker to write the times of.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeTrackingTimes(const std::string& filename, const ObjectTracker& tracker) {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write tracking times: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "objects,frames,mean_ms,max_ms\n";
+
+    const auto times = tracker.getTrackingTimes();
+
+    for (std::size_t count = 0; count < times.size(); count++) {
+        if (times[count].frames > 0) {
+            writeOutput << count << "," << times[count].frames << "," << times[count].total / times[count].frames << ","
+                        << times[count].longest << "\n";
+        }
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Writes the latency and count statistics of every compared file to a csv file.
+ * Each file gets a row per network holding its frame latencies in milliseconds (mean, median, 95th percentile
+ * and maximum), its counts and the difference of its counts from those of the full precision network.
+ * @param filename the name of the csv file to write.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeComparison(const std::string& filename) const {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write comparison: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "file,model,frames,mean_ms,p50_ms,p95_ms,max_ms,entered,exited,entered_delta,exited_delta\n";
+
+    for (const auto& comparison : comparisons) {
+        const auto& reference = comparison.reference;
+
+        for (const bool quantized : { false, true }) {
+            const auto& summary = quantized ? comparison.quantized : comparison.reference;
+            const auto& latencies = quantized ? comparison.quantizedLatencies : comparison.referenceLatencies;
+            const double mean = latencies.empty() ? 0 : std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+
+            writeOutput << summary.file << "," << (quantized ? "int8" : "fp32") << "," << summary.frames << ","
+                        << mean << "," << percentile(latencies, 0.5) << "," << percentile(latencies, 0.95) << ","
+                        << percentile(latencies, 1.0) << "," << summary.entered << "," << summary.exited << ","
+                        << static_cast<int>(summary.entered) - static_cast<int>(reference.entered) << ","
+                        << static_cast<int>(summary.exited) - static_cast<int>(reference.exited) << "\n";
+        }
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Writes the processing time of every frame of every compared file to a csv file.
+ * Each row holds the file, the frame number and the time in milliseconds taken by each network.
+ * @param filename the name of the csv file to write.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeLatencies(const std::string& filename) const {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write latencies: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "file,frame,fp32_ms,int8_ms\n";
+
+    for (const auto& comparison : comparisons) {
+        const auto frames = std::min(comparison.referenceLatencies.size(), comparison.quantizedLatencies.size());
+
+        for (std::size_t i = 0; i < frames; i++) {
+            writeOutput << comparison.reference.file << "," << i << "," << comparison.referenceLatencies[i] << ","
+                        << comparison.quantizedLatencies[i] << "\n";
+        }
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Writes the cost and count accuracy of every calibrated tracker algorithm to a csv file.
+ * @param filename the name of the csv file to write.
+ * @param recommended the index of the recommended calibration.
+ * @return true if the file could be written.
+ */
+bool BatchProcessor::writeCalibration(const std::string& filename, const int recommended) const {
+    std::ofstream writeOutput(filename);
+
+    if (!writeOutput.is_open()) {
+        std::cerr << "Could not write calibration: " << filename << std::endl;
+        return false;
+    }
+
+    writeOutput << "tracker,frames,ms_per_object_frame,entered,exited,accuracy,recommended\n";
+
+    for (std::size_t i = 0; i < calibrations.size(); i++) {
+        const auto& calibration = calibrations[i];
+
+        unsigned int frames = 0;
+        unsigned int entered = 0;
+        unsigned int exited = 0;
+
+        for (const auto& summary : calibration.summaries) {
+            frames += summary.frames;
+            entered += summary.entered;
+            exited += summary.exited;
+        }
+
+        writeOutput << TrackedObject::getAlgorithmName(calibration.algorithm) << "," << frames << "," << calibration.objectFrameTime << ","
+                    << entered << "," << exited << "," << calibration.accuracy << "," << (static_cast<int>(i) == recommended ? 1 : 0) << "\n";
+    }
+
+    writeOutput.close();
+    return true;
+}
+
+/**
+ * @brief Returns the value below which the given fraction of values fall.
+ * @param values the values, taken by copy since they are partially sorted.
+ * @param fraction the fraction between 0 and 1, 0.5 for the median.
+ * @return the percentile, or zero if there are no values.
+ */
+double BatchProcessor::percentile(std::vector<double> values, const double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+
+    const auto index = std::min(static_cast<std::size_t>(fraction * values.size()), values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+
+    return values[index];
+}
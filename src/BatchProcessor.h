@@ -0,0 +1,135 @@
+/**
+ * @file BatchProcessor.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Counts people in recorded video files from the command line, without a GUI
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <string>
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#include "ObjectTracker.h"
+#include "VideoDecoder.h"
+
+/**
+ * The directory whose .mp4 files are compared when no files are given to the comparison mode.
+ */
+#define DEFAULT_COMPARISON_DIRECTORY "test_videos"
+
+/**
+ * The default count accuracy, between 0 and 1, a tracker algorithm must reach to be recommended by the calibration.
+ */
+#define DEFAULT_CALIBRATION_TARGET 0.95
+
+/**
+ * @brief Class that counts people in recorded video files without a GUI.
+ * Files are decoded and tracked as fast as the CPU allows, without real-time pacing, drawing or display.
+ * Every enter/exit event is written to an event log and per-file totals, including the decoding throughput, are written to a summary.
+ * The time spent tracking each frame is written by the number of people in the frame.
+ * In comparison mode, every file is processed with both the full precision and the INT8-quantized detector
+ * instead, and their per-frame latencies and counts are written side by side. In calibration mode, sample
+ * clips are replayed with every tracker algorithm to recommend the cheapest one counting accurately enough.
+ */
+class BatchProcessor {
+    public:
+        /**
+         * A single enter or exit event.
+         */
+        struct Event {
+            std::string file;
+            unsigned int frame;
+            double time;
+            bool entered;
+            // The name of the line or zone the person was counted across
+            std::string line;
+        };
+
+        /**
+         * The totals for a single processed file.
+         */
+        struct Summary {
+            std::string file;
+            unsigned int frames;
+            unsigned long long skipped;
+            unsigned int entered;
+            unsigned int exited;
+            double seconds;
+            // The part of the processing time spent decoding, in seconds
+            double decodeSeconds;
+        };
+
+        /**
+         * The results of processing a single file with the full precision and with the quantized detector.
+         */
+        struct Comparison {
+            Summary reference;
+            Summary quantized;
+            std::vector<double> referenceLatencies;
+            std::vector<double> quantizedLatencies;
+        };
+
+        /**
+         * The results of replaying the sample clips with a single tracker algorithm.
+         */
+        struct Calibration {
+            TrackedObject::Algorithm algorithm;
+            std::vector<Summary> summaries;
+            // The mean time spent updating one object in one frame, in milliseconds
+            double objectFrameTime;
+            // How closely the counts match the reference counts, between 0 and 1
+            double accuracy;
+        };
+
+        BatchProcessor();
+
+        ~BatchProcessor();
+
+        int run(const QStringList& arguments);
+
+        bool processFile(const QString& filepath, ObjectTracker& tracker, std::vector<double> *latencies = nullptr);
+
+        bool compareFile(const QString& filepath, ObjectTracker& reference, ObjectTracker& quantized);
+
+        bool calibrate(const QStringList& files, const ObjectTracker::EnterDirection enterDirection, const int expectedEntered, const int expectedExited);
+
+        int recommend(const double target) const;
+
+        bool writeEventLog(const std::string& filename) const;
+
+        bool writeSummary(const std::string& filename) const;
+
+        static bool writeTrackingTimes(const std::string& filename, const ObjectTracker& tracker);
+
+        bool writeComparison(const std::string& filename) const;
+
+        bool writeLatencies(const std::string& filename) const;
+
+        bool writeCalibration(const std::string& filename, const int recommended) const;
+
+    private:
+        static void configure(ObjectTracker& tracker, const ObjectTracker::EnterDirection enterDirection);
+
+        static double percentile(std::vector<double> values, const double fraction);
+
+        /**
+         * How the video files are decoded, archives are often decode-bound.
+         */
+        VideoDecoder::Options decoderOptions;
+
+        std::vector<Event> events;
+
+        std::vector<Summary> summaries;
+
+        std::vector<Comparison> comparisons;
+
+        std::vector<Calibration> calibrations;
+};
+
+#endif // BATCHPROCESSOR_H
@@ -0,0 +1,230 @@
+/**
+ * @file BudgetGovernor.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Degrades the work done per frame step by step when processing exceeds its CPU budget
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "BudgetGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs a new BudgetGovernor object, disabled and at full quality.
+ */
+BudgetGovernor::BudgetGovernor() {
+    budget = { false, DEFAULT_FRAME_DEADLINE, DEFAULT_CPU_SHARE };
+    steps = 0;
+    skippedFrames = 0;
+    reset();
+}
+
+/**
+ * @brief Destructs a BudgetGovernor object.
+ */
+BudgetGovernor::~BudgetGovernor() {
+
+}
+
+/**
+ * @brief Returns the name of a step of the degradation ladder, for logs and display.
+ * @param level the step.
+ * @return the name of the step.
+ */
+std::string BudgetGovernor::getLevelName(const BudgetGovernor::Level level) {
+    switch (level) {
+        case ReducedDetectionRate:
+            return "Reduced Detection Rate";
+        case ReducedInputSize:
+            return "Reduced Input Size";
+        case CheaperTracker:
+            return "Cheaper Tracker";
+        case SkippedFrames:
+            return "Skipped Frames";
+        default:
+            return "Full Quality";
+    }
+}
+
+/**
+ * @brief Returns the budget processing is kept within.
+ * @return the budget.
+ */
+BudgetGovernor::Budget BudgetGovernor::getBudget() const {
+    return budget;
+}
+
+/**
+ * @brief Sets the budget processing is kept within. Disabling the governor restores full quality.
+ * @param budget the budget to set.
+ */
+void BudgetGovernor::setBudget(const BudgetGovernor::Budget& budget) {
+    if (!budget.enabled && this->budget.enabled) {
+        reset();
+    }
+
+    this->budget = budget;
+}
+
+/**
+ * @brief Returns the current step of the degradation ladder.
+ * @return the current step.
+ */
+BudgetGovernor::Level BudgetGovernor::getLevel() const {
+    return level;
+}
+
+/**
+ * @brief Returns the average time spent per frame as a fraction of the budget. Above one, the budget is exceeded.
+ * Frames being skipped leave the processed ones the time of the skipped ones too.
+ * @return the load.
+ */
+double BudgetGovernor::getLoad() const {
+    const double available = budget.deadline * budget.share * (level == SkippedFrames ? GOVERNOR_SKIP_RATIO : 1);
+    return available > 0 ? averageTotal / available : 0.0;
+}
+
+/**
+ * @brief Returns the average time spent detecting per processed frame.
+ * @return the average detection time, in milliseconds.
+ */
+double BudgetGovernor::getDetectionTime() const {
+    return averageDetection;
+}
+
+/**
+ * @brief Returns the average time spent tracking per processed frame.
+ * @return the average tracking time, in milliseconds.
+ */
+double BudgetGovernor::getTrackingTime() const {
+    return averageTracking;
+}
+
+/**
+ * @brief Returns the number of steps taken down or up the ladder so far.
+ * @return the number of steps.
+ */
+unsigned long long BudgetGovernor::getStepCount() const {
+    return steps;
+}
+
+/**
+ * @brief Returns the number of frames skipped to stay within the budget so far.
+ * @return the number of skipped frames.
+ */
+unsigned long long BudgetGovernor::getSkippedFrameCount() const {
+    return skippedFrames;
+}
+
+/**
+ * @brief Returns the factor the detection interval is stretched by at the current step.
+ * @return the factor, one at full detection rate.
+ */
+int BudgetGovernor::getIntervalScale() const {
+    return level >= ReducedDetectionRate ? GOVERNOR_INTERVAL_SCALE : 1;
+}
+
+/**
+ * @brief Returns the detector input size to use at the current step.
+ * @param size the configured input size.
+ * @return the configured size, or a smaller one kept to the networks' stride once the input size is lowered.
+ */
+cv::Size BudgetGovernor::getInputSize(const cv::Size size) const {
+    if (level < ReducedInputSize) {
+        return size;
+    }
+
+    const auto scale = [](const int length) {
+        const int scaled = static_cast<int>(std::lround(length * GOVERNOR_INPUT_SCALE / GOVERNOR_INPUT_ALIGNMENT)) * GOVERNOR_INPUT_ALIGNMENT;
+        return std::min(std::max(scaled, GOVERNOR_INPUT_ALIGNMENT), length);
+    };
+
+    return cv::Size(scale(size.width), scale(size.height));
+}
+
+/**
+ * @brief Returns the tracker algorithm to use at the current step.
+ * @param algorithm the configured algorithm.
+ * @return the configured algorithm, or GOVERNOR_CHEAP_TRACKER instead of a costlier one once a cheaper tracker is selected.
+ */
+TrackedObject::Algorithm BudgetGovernor::getAlgorithm(const TrackedObject::Algorithm algorithm) const {
+    const bool costly = algorithm == TrackedObject::KcfTracker || algorithm == TrackedObject::CsrtTracker;
+    return level >= CheaperTracker && costly ? GOVERNOR_CHEAP_TRACKER : algorithm;
+}
+
+/**
+ * @brief Returns whether the next frame should be skipped. Called once for every frame.
+ * @return true if the frame should be skipped to stay within the budget.
+ */
+bool BudgetGovernor::shouldSkip() {
+    if (level < SkippedFrames) {
+        return false;
+    }
+
+    const bool skip = frameCount++ % GOVERNOR_SKIP_RATIO != 0;
+    skippedFrames += skip ? 1 : 0;
+
+    return skip;
+}
+
+/**
+ * @brief Records the time spent on a processed frame and takes a step down or up the ladder if needed.
+ * @param total the time spent on the whole frame, in milliseconds.
+ * @param detection the time spent detecting in the frame, in milliseconds.
+ * @param tracking the time spent tracking in the frame, in milliseconds.
+ * @return true if a step was taken, getLevel() then returns the new step.
+ */
+bool BudgetGovernor::frameProcessed(const double total, const double detection, const double tracking) {
+    if (!budget.enabled || budget.deadline <= 0) {
+        return false;
+    }
+
+    const double deadline = budget.deadline * (level == SkippedFrames ? GOVERNOR_SKIP_RATIO : 1);
+
+    averageTotal += (total - averageTotal) * GOVERNOR_SMOOTHING;
+    averageDetection += (detection - averageDetection) * GOVERNOR_SMOOTHING;
+    averageTracking += (tracking - averageTracking) * GOVERNOR_SMOOTHING;
+    missedShare += ((total > deadline ? 1.0 : 0.0) - missedShare) * GOVERNOR_SMOOTHING;
+
+    const double load = getLoad();
+    const bool overloaded = load > 1.0 || missedShare > GOVERNOR_MAX_MISSED_SHARE;
+
+    overloadedFrames = overloaded ? overloadedFrames + 1 : 0;
+    relaxedFrames = load < GOVERNOR_RECOVER_LOAD && !overloaded ? relaxedFrames + 1 : 0;
+
+    const Level previous = level;
+
+    if (overloadedFrames >= GOVERNOR_OVERLOAD_FRAMES && level < SkippedFrames) {
+        level = static_cast<Level>(level + 1);
+    } else if (relaxedFrames >= GOVERNOR_RECOVER_FRAMES && level > FullQuality) {
+        level = static_cast<Level>(level - 1);
+    }
+
+    if (level == previous) {
+        return false;
+    }
+
+    // Give the new step a full period before judging it
+    overloadedFrames = 0;
+    relaxedFrames = 0;
+    frameCount = 0;
+    steps++;
+
+    return true;
+}
+
+/**
+ * @brief Returns to full quality and forgets the recorded times. The step and skipped frame counts are kept.
+ */
+void BudgetGovernor::reset() {
+    level = FullQuality;
+    averageTotal = 0;
+    averageDetection = 0;
+    averageTracking = 0;
+    missedShare = 0;
+    overloadedFrames = 0;
+    relaxedFrames = 0;
+    frameCount = 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file BudgetGovernor.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Degrades the work done per frame step by step when processing exceeds its CPU budget
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef BUDGETGOVERNOR_H
+#define BUDGETGOVERNOR_H
+
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "TrackedObject.h"
+
+/**
+ * The default time available to process a frame, in milliseconds. One frame at 24 frames per second.
+ */
+#define DEFAULT_FRAME_DEADLINE 41.0
+
+/**
+ * The default share of the frame deadline processing may use on average, leaving the rest for decoding and display.
+ */
+#define DEFAULT_CPU_SHARE 0.8
+
+/**
+ * The weight of the latest frame in the running averages of the processing times.
+ */
+#define GOVERNOR_SMOOTHING 0.0625
+
+/**
+ * The largest share of recent frames allowed to miss the deadline before the budget counts as exceeded.
+ */
+#define GOVERNOR_MAX_MISSED_SHARE 0.1
+
+/**
+ * The average load, as a fraction of the budget, below which work is restored.
+ */
+#define GOVERNOR_RECOVER_LOAD 0.5
+
+/**
+ * The number of frames the budget must stay exceeded before degrading a further step.
+ * At least one detection interval, so the averages reflect the previous step before the next is taken.
+ */
+#define GOVERNOR_OVERLOAD_FRAMES 30
+
+/**
+ * The number of frames the load must stay low before restoring a step. Longer than degrading, so steps do not flap.
+ */
+#define GOVERNOR_RECOVER_FRAMES 240
+
+/**
+ * The factor the detection interval is stretched by once the detection rate is lowered.
+ */
+#define GOVERNOR_INTERVAL_SCALE 2
+
+/**
+ * The factor the detector's input size is scaled by once it is lowered.
+ */
+#define GOVERNOR_INPUT_SCALE 0.75
+
+/**
+ * Detector input sizes are kept to multiples of this, the stride of the detection networks.
+ */
+#define GOVERNOR_INPUT_ALIGNMENT 32
+
+/**
+ * The cheapest tracker algorithm, used for objects once a cheaper tracker is selected.
+ */
+#define GOVERNOR_CHEAP_TRACKER TrackedObject::MosseTracker
+
+/**
+ * Once frames are skipped, only one frame out of this many is processed.
+ */
+#define GOVERNOR_SKIP_RATIO 2
+
+/**
+ * @brief Class that keeps the processing of a stream within its CPU budget by degrading work step by step.
+ * The time spent on every frame, and on its detection and tracking stages, is averaged and compared with the
+ * budget, a share of the frame deadline. While the budget is exceeded, or too many frames miss the deadline, the
+ * governor degrades one step at a time down a ladder: detect less often, detect on a smaller input, track with a
+ * cheaper algorithm, and finally skip frames. Once the load stays low for a while, steps are restored in reverse.
+ * Each step is logged. Frames are then processed late by a bounded amount instead of queuing up behind each other,
+ * so counts keep flowing during peaks.
+ */
+class BudgetGovernor {
+    public:
+        /**
+         * The steps of the degradation ladder, each including the ones before.
+         */
+        enum Level {
+            FullQuality,
+            ReducedDetectionRate,
+            ReducedInputSize,
+            CheaperTracker,
+            SkippedFrames
+        };
+
+        /**
+         * The budget processing is kept within.
+         */
+        struct Budget {
+            bool enabled;
+            // The time available to process a frame, in milliseconds
+            double deadline;
+            // The share of the deadline processing may use on average
+            double share;
+        };
+
+        BudgetGovernor();
+
+        ~BudgetGovernor();
+
+        static std::string getLevelName(const Level level);
+
+        Budget getBudget() const;
+
+        void setBudget(const Budget& budget);
+
+        Level getLevel() const;
+
+        double getLoad() const;
+
+        double getDetectionTime() const;
+
+        double getTrackingTime() const;
+
+        unsigned long long getStepCount() const;
+
+        unsigned long long getSkippedFrameCount() const;
+
+        int getIntervalScale() const;
+
+        cv::Size getInputSize(const cv::Size size) const;
+
+        TrackedObject::Algorithm getAlgorithm(const TrackedObject::Algorithm algorithm) const;
+
+        bool shouldSkip();
+
+        bool frameProcessed(const double total, const double detection, const double tracking);
+
+        void reset();
+
+    private:
+        Budget budget;
+
+        Level level;
+
+        /**
+         * The running averages of the time spent per processed frame, and on its stages, in milliseconds.
+         */
+        double averageTotal;
+        double averageDetection;
+        double averageTracking;
+
+        /**
+         * The running average share of processed frames that missed the deadline.
+         */
+        double missedShare;
+
+        /**
+         * The number of consecutive frames the budget was exceeded, or the load stayed low.
+         */
+        int overloadedFrames;
+        int relaxedFrames;
+
+        /**
+         * The number of frames seen since frames started being skipped, to pick which to skip.
+         */
+        unsigned long long frameCount;
+
+        unsigned long long steps;
+        unsigned long long skippedFrames;
+};
+
+#endif // BUDGETGOVERNOR_H
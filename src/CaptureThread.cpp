@@ -0,0 +1,90 @@
+/**
+ * @file CaptureThread.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Thread which decodes frames from a video capture into a frame queue
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "CaptureThread.h"
+
+#include <QElapsedTimer>
+
+/**
+ * The time in milliseconds to wait for a free pool buffer before checking for interruption again.
+ */
+#define POOL_WAIT_INTERVAL 50
+
+/**
+ * @brief Constructs a new CaptureThread object.
+ * @param capture the opened capture to decode frames from.
+ * @param converter the converter delivering frames in the processed resolution and pixel format.
+ * @param pool the pool providing the buffers to decode into.
+ * @param queue the queue to push decoded frames into.
+ * @param parent the parent Qt object of this object.
+ */
+CaptureThread::CaptureThread(VideoDecoder *capture, FrameConverter *converter, FramePool *pool, FrameQueue *queue, QObject *parent) : QThread(parent) {
+    this->capture = capture;
+    this->converter = converter;
+    this->pool = pool;
+    this->queue = queue;
+    frameInterval = 0;
+}
+
+/**
+ * @brief Destructs a CaptureThread object, stopping the thread if it is still running.
+ */
+CaptureThread::~CaptureThread() {
+    requestInterruption();
+    queue->close();
+    wait();
+}
+
+/**
+ * @brief Sets the time between two decoded frames. Must be called while the thread is not running.
+ * @param interval the frame interval in milliseconds, zero to decode as fast as possible.
+ */
+void CaptureThread::setFrameInterval(const int interval) {
+    frameInterval = interval;
+}
+
+/**
+ * @brief Decodes frames until interrupted or the capture runs out of frames.
+ * A frameQueued signal is emitted for every frame accepted by the queue.
+ */
+void CaptureThread::run() {
+    QElapsedTimer clock;
+    clock.start();
+
+    qint64 nextFrameTime = 0;
+
+    while (!isInterruptionRequested()) {
+        // Wait for a free buffer, every buffer may still be held by the queue or the processing chain
+        FrameHandle frame = pool->acquire(POOL_WAIT_INTERVAL);
+
+        if (frame.isNull()) {
+            continue;
+        }
+
+        if (!converter->read(*capture, frame.mat())) {
+            break;
+        }
+
+        if (queue->push(frame)) {
+            emit frameQueued();
+        }
+
+        // Pace the decoding to the source frame rate, resynchronizing if we fell behind
+        if (frameInterval > 0) {
+            nextFrameTime += frameInterval;
+
+            const qint64 remaining = nextFrameTime - clock.elapsed();
+
+            if (remaining > 0) {
+                msleep(remaining);
+            } else {
+                nextFrameTime = clock.elapsed();
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file CaptureThread.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Thread which decodes frames from a video capture into a frame queue
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef CAPTURETHREAD_H
+#define CAPTURETHREAD_H
+
+#include <QThread>
+
+#include <opencv2/opencv.hpp>
+
+#include "FrameConverter.h"
+#include "FramePool.h"
+#include "FrameQueue.h"
+#include "VideoDecoder.h"
+
+/**
+ * @brief Thread which decodes frames from a video capture into a frame queue.
+ * Decoding runs off the GUI thread so a slow decode or a busy consumer never stalls the UI.
+ * Frames are decoded into pooled buffers, paced to the source frame rate and handed over through a bounded FrameQueue.
+ */
+class CaptureThread : public QThread {
+    Q_OBJECT
+
+    public:
+        CaptureThread(VideoDecoder *capture, FrameConverter *converter, FramePool *pool, FrameQueue *queue, QObject *parent = 0);
+
+        ~CaptureThread();
+
+        void setFrameInterval(const int interval);
+
+    signals:
+        void frameQueued();
+
+    protected:
+        void run() override;
+
+    private:
+        /**
+         * The capture to decode from. Owned by the VideoSource and only touched by this thread while it runs.
+         */
+        VideoDecoder *capture;
+
+        /**
+         * Converts decoded frames to the resolution and pixel format they are processed in.
+         */
+        FrameConverter *converter;
+
+        /**
+         * The pool providing the buffers frames are decoded into.
+         */
+        FramePool *pool;
+
+        /**
+         * The queue decoded frames are pushed into.
+         */
+        FrameQueue *queue;
+
+        /**
+         * The time between two frames in milliseconds. Zero disables pacing.
+         */
+        int frameInterval;
+};
+
+#endif // CAPTURETHREAD_H
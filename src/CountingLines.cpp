@@ -0,0 +1,306 @@
+/**
+ * @file CountingLines.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Lines and zones people are counted across, tested against the recent motion of each tracked object
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "CountingLines.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Returns the text form of the line, as stored in the settings.
+ * The form is "name|x,y x,y ...|line or zone|forward or reversed", with points as fractions of the region.
+ * @return the text form of the line.
+ */
+QString CountingLines::Line::toString() const {
+    QStringList coordinates;
+
+    for (const auto& point : points) {
+        coordinates << QString("%1,%2").arg(point.x).arg(point.y);
+    }
+
+    return QString("%1|%2|%3|%4").arg(name).arg(coordinates.join(" ")).arg(zone ? "zone" : "line").arg(reversed ? "reversed" : "forward");
+}
+
+/**
+ * @brief Parses the text form of a line.
+ * @param text the text form of the line, see toString().
+ * @param line receives the parsed line.
+ * @return true if the text is a valid line with at least two points, or a zone with at least three.
+ */
+bool CountingLines::Line::fromString(const QString& text, CountingLines::Line& line) {
+    const auto fields = text.split('|');
+
+    if (fields.size() != 4) {
+        return false;
+    }
+
+    line.name = fields[0].trimmed();
+    line.points.clear();
+    line.zone = fields[2].trimmed() == "zone";
+    line.reversed = fields[3].trimmed() == "reversed";
+
+    for (const auto& coordinates : fields[1].simplified().split(' ')) {
+        const auto values = coordinates.split(',');
+        bool xValid = false;
+        bool yValid = false;
+
+        if (values.size() != 2) {
+            return false;
+        }
+
+        line.points.push_back(cv::Point2f(values[0].toFloat(&xValid), values[1].toFloat(&yValid)));
+
+        if (!xValid || !yValid) {
+            return false;
+        }
+    }
+
+    return line.points.size() >= (line.zone ? 3u : 2u);
+}
+
+/**
+ * @brief Parses the text forms of several lines, skipping invalid ones.
+ * @param texts the text forms of the lines.
+ * @return the valid lines, in order.
+ */
+std::vector<CountingLines::Line> CountingLines::Line::fromStrings(const QStringList& texts) {
+    std::vector<Line> lines;
+
+    for (const auto& text : texts) {
+        Line line;
+
+        if (fromString(text, line)) {
+            lines.push_back(line);
+        }
+    }
+
+    return lines;
+}
+
+/**
+ * @brief Returns the text forms of several lines.
+ * @param lines the lines.
+ * @return the text forms of the lines, in order.
+ */
+QStringList CountingLines::Line::toStrings(const std::vector<CountingLines::Line>& lines) {
+    QStringList texts;
+
+    for (const auto& line : lines) {
+        texts << line.toString();
+    }
+
+    return texts;
+}
+
+/**
+ * @brief Constructs an empty CountingLines object, nothing is ever crossed.
+ */
+CountingLines::CountingLines() {
+
+}
+
+/**
+ * @brief Constructs a new CountingLines object for a region of the given size.
+ * @param lines the lines and zones to count across.
+ * @param size the size of the region, in pixels.
+ */
+CountingLines::CountingLines(const std::vector<Line>& lines, const cv::Size size) : lines(lines) {
+    const cv::Point2f scale(static_cast<float>(size.width), static_cast<float>(size.height));
+
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        const auto& line = lines[i];
+        std::vector<cv::Point2f> points;
+
+        for (const auto& point : line.points) {
+            points.push_back(cv::Point2f(point.x * scale.x, point.y * scale.y));
+        }
+
+        std::vector<cv::Point> polyline;
+
+        for (const auto& point : points) {
+            polyline.push_back(cv::Point(cvRound(point.x), cvRound(point.y)));
+        }
+
+        polylines.push_back(polyline);
+
+        // In image coordinates, with y growing downwards, the inside of a zone with a positive signed area
+        // is on the positive side of its segments. Turn zones the other way around so that entering is positive
+        bool flip = line.reversed;
+
+        if (line.zone) {
+            double area = 0;
+
+            for (std::size_t j = 0; j < points.size(); j++) {
+                const auto& next = points[(j + 1) % points.size()];
+                area += points[j].x * next.y - next.x * points[j].y;
+            }
+
+            flip = (area < 0) != line.reversed;
+        }
+
+        if (flip) {
+            std::reverse(points.begin(), points.end());
+        }
+
+        const std::size_t count = line.zone ? points.size() : points.size() - 1;
+
+        for (std::size_t j = 0; j < count; j++) {
+            const auto& start = points[j];
+            const auto& end = points[(j + 1) % points.size()];
+
+            startX.push_back(start.x);
+            startY.push_back(start.y);
+            directionX.push_back(end.x - start.x);
+            directionY.push_back(end.y - start.y);
+            owners.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+/**
+ * @brief Destructs a CountingLines object.
+ */
+CountingLines::~CountingLines() {
+
+}
+
+/**
+ * @brief Returns the number of lines and zones.
+ * @return the number of lines and zones.
+ */
+int CountingLines::getLineCount() const {
+    return static_cast<int>(lines.size());
+}
+
+/**
+ * @brief Returns the number of segments of every line and zone together.
+ * @return the number of segments.
+ */
+int CountingLines::getSegmentCount() const {
+    return static_cast<int>(owners.size());
+}
+
+/**
+ * @brief Returns a line or zone as it was set.
+ * @param line the index of the line.
+ * @return the line.
+ */
+const CountingLines::Line& CountingLines::getLine(const int line) const {
+    return lines[line];
+}
+
+/**
+ * @brief Returns the points of a line or zone in pixels of the region, for drawing.
+ * @param line the index of the line.
+ * @return the points of the line, zones are not closed.
+ */
+const std::vector<cv::Point>& CountingLines::getPolyline(const int line) const {
+    return polylines[line];
+}
+
+/**
+ * @brief Tests a movement against every line and zone.
+ * Nothing is allocated, the caller owns the buffers and reuses them for every object.
+ * A movement touching a segment counts as crossing once it leaves the segment's negative side, so a person passing
+ * exactly through a shared point of two segments, or stopping on a line, is counted once.
+ * @param from the position the object moved from, in pixels of the region.
+ * @param to the position the object moved to.
+ * @param segments receives, for every segment, 1 if the movement entered across it, -1 if it exited and 0 otherwise.
+ * Must hold getSegmentCount() values.
+ * @param lines receives, for every line, the sum of its segments. Positive if the object entered, negative if it exited.
+ * Must hold getLineCount() values.
+ */
+void CountingLines::cross(const cv::Point2f& from, const cv::Point2f& to, int *segments, int *lines) const {
+    const int count = getSegmentCount();
+    const float moveX = to.x - from.x;
+    const float moveY = to.y - from.y;
+
+    const float *ax = startX.data();
+    const float *ay = startY.data();
+    const float *dx = directionX.data();
+    const float *dy = directionY.data();
+
+    // Branch-free over plain arrays, so the compiler can vectorize the loop over segments
+    for (int i = 0; i < count; i++) {
+        // Sides of the segment the movement starts and ends on
+        const float before = dx[i] * (from.y - ay[i]) - dy[i] * (from.x - ax[i]);
+        const float after = dx[i] * (to.y - ay[i]) - dy[i] * (to.x - ax[i]);
+
+        // Sides of the movement the segment starts and ends on
+        const float start = moveX * (ay[i] - from.y) - moveY * (ax[i] - from.x);
+        const float end = moveX * (ay[i] + dy[i] - from.y) - moveY * (ax[i] + dx[i] - from.x);
+
+        const int crossed = ((before > 0) != (after > 0)) & ((start > 0) != (end > 0));
+        segments[i] = crossed * (after > 0 ? 1 : -1);
+    }
+
+    const int lineCount = getLineCount();
+
+    for (int i = 0; i < lineCount; i++) {
+        lines[i] = 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        lines[owners[i]] += segments[i];
+    }
+}
+
+/**
+ * @brief Returns the distance from a point to the nearest line or zone border.
+ * @param point the point, in pixels of the region.
+ * @return the distance in pixels, infinite if there are no lines.
+ */
+float CountingLines::distance(const cv::Point2f& point) const {
+    const int count = getSegmentCount();
+    float nearest = std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i < count; i++) {
+        nearest = std::min(nearest, segmentDistance(i, point));
+    }
+
+    return std::sqrt(nearest);
+}
+
+/**
+ * @brief Returns the distance from a point to a single line or zone border.
+ * @param point the point, in pixels of the region.
+ * @param line the index of the line.
+ * @return the distance in pixels.
+ */
+float CountingLines::distance(const cv::Point2f& point, const int line) const {
+    const int count = getSegmentCount();
+    float nearest = std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i < count; i++) {
+        if (owners[i] == line) {
+            nearest = std::min(nearest, segmentDistance(i, point));
+        }
+    }
+
+    return std::sqrt(nearest);
+}
+
+/**
+ * @brief Returns the squared distance from a point to a segment.
+ * @param segment the index of the segment.
+ * @param point the point, in pixels of the region.
+ * @return the squared distance in pixels.
+ */
+float CountingLines::segmentDistance(const int segment, const cv::Point2f& point) const {
+    const float length = directionX[segment] * directionX[segment] + directionY[segment] * directionY[segment];
+    const float offsetX = point.x - startX[segment];
+    const float offsetY = point.y - startY[segment];
+
+    // Project the point on the segment, clamped to its ends
+    const float t = length > 0 ? std::min(std::max((offsetX * directionX[segment] + offsetY * directionY[segment]) / length, 0.0f), 1.0f) : 0.0f;
+    const float x = offsetX - t * directionX[segment];
+    const float y = offsetY - t * directionY[segment];
+
+    return x * x + y * y;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CountingLines.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Lines and zones people are counted across, tested against the recent motion of each tracked object
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef COUNTINGLINES_H
+#define COUNTINGLINES_H
+
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Lines and zones people are counted across, flattened into segments for fast intersection tests.
+ * Each line is a polyline given in fractions of the region of interest's width and height. A zone is a closed
+ * polyline, entering it means moving into it. Segments are oriented when the lines are built so that crossing
+ * any of them towards its positive side means entering, the test itself then has no special cases.
+ * Built once per change of lines or region, then only read, so it can be shared with renderers on other threads.
+ */
+class CountingLines {
+    public:
+        /**
+         * A line or zone as set by the user.
+         */
+        struct Line {
+            QString name;
+            // The points of the polyline, as fractions of the region's width and height
+            std::vector<cv::Point2f> points;
+            // Whether the last point joins the first, entering then means moving into the zone
+            bool zone;
+            // For lines, whether entering means crossing from the right to the left of the line walked from its first point.
+            // For zones, whether leaving the zone counts as entering
+            bool reversed;
+
+            QString toString() const;
+
+            static bool fromString(const QString& text, Line& line);
+
+            static std::vector<Line> fromStrings(const QStringList& texts);
+
+            static QStringList toStrings(const std::vector<Line>& lines);
+        };
+
+        CountingLines();
+
+        CountingLines(const std::vector<Line>& lines, const cv::Size size);
+
+        ~CountingLines();
+
+        int getLineCount() const;
+
+        int getSegmentCount() const;
+
+        const Line& getLine(const int line) const;
+
+        const std::vector<cv::Point>& getPolyline(const int line) const;
+
+        void cross(const cv::Point2f& from, const cv::Point2f& to, int *segments, int *lines) const;
+
+        float distance(const cv::Point2f& point) const;
+
+        float distance(const cv::Point2f& point, const int line) const;
+
+    private:
+        float segmentDistance(const int segment, const cv::Point2f& point) const;
+
+        std::vector<Line> lines;
+
+        /**
+         * The lines in pixels of the region, for drawing.
+         */
+        std::vector<std::vector<cv::Point>> polylines;
+
+        /**
+         * Every segment of every line, as separate arrays of start points and directions so tests vectorize.
+         */
+        std::vector<float> startX;
+        std::vector<float> startY;
+        std::vector<float> directionX;
+        std::vector<float> directionY;
+
+        /**
+         * The index of the line each segment belongs to.
+         */
+        std::vector<int> owners;
+};
+
+#endif // COUNTINGLINES_H
@@ -0,0 +1,153 @@
+/**
+ * @file DetectionScheduler.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decides on which frames the object tracker runs its detector
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "DetectionScheduler.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs a new DetectionScheduler object. The first frame is always a detection frame.
+ * @param adaptive whether the interval adapts to the scene or stays at FAST_TRACKING_FRAMES.
+ */
+DetectionScheduler::DetectionScheduler(const bool adaptive) {
+    this->adaptive = adaptive;
+    scale = 1;
+    reset();
+}
+
+/**
+ * @brief Destructs a DetectionScheduler object.
+ */
+DetectionScheduler::~DetectionScheduler() {
+
+}
+
+/**
+ * @brief Returns whether the interval adapts to the scene.
+ * @return true if the schedule is adaptive, false if it is fixed.
+ */
+bool DetectionScheduler::isAdaptive() const {
+    return adaptive;
+}
+
+/**
+ * @brief Sets whether the interval adapts to the scene. A fixed schedule returns to FAST_TRACKING_FRAMES.
+ * @param adaptive true for an adaptive schedule, false for a fixed one.
+ */
+void DetectionScheduler::setAdaptive(const bool adaptive) {
+    this->adaptive = adaptive;
+
+    if (!adaptive) {
+        interval = FAST_TRACKING_FRAMES;
+    }
+}
+
+/**
+ * @brief Returns the current number of frames between two detections.
+ * @return the current detection interval, stretched by the interval scale.
+ */
+int DetectionScheduler::getInterval() const {
+    return interval * scale;
+}
+
+/**
+ * @brief Returns the factor the interval is stretched by.
+ * @return the interval scale, one unless detection was slowed down.
+ */
+int DetectionScheduler::getIntervalScale() const {
+    return scale;
+}
+
+/**
+ * @brief Sets the factor the interval is stretched by, whether it is fixed or adaptive.
+ * @param scale the interval scale, at least one.
+ */
+void DetectionScheduler::setIntervalScale(const int scale) {
+    this->scale = std::max(scale, 1);
+}
+
+/**
+ * @brief Returns whether the current frame should be a detection frame.
+ * @return true if at least the current interval has passed since the last detection started.
+ */
+bool DetectionScheduler::isDetectionDue() const {
+    return framesSinceDetection >= getInterval();
+}
+
+/**
+ * @brief Makes the next frame a detection frame, regardless of how many frames passed since the last detection.
+ */
+void DetectionScheduler::expedite() {
+    framesSinceDetection = std::max(framesSinceDetection, getInterval());
+}
+
+/**
+ * @brief Puts off the next detection by a number of frames, once. Used to shift the schedule's phase.
+ * @param frames the number of frames to put the next detection off by.
+ */
+void DetectionScheduler::delay(const int frames) {
+    framesSinceDetection -= frames;
+}
+
+/**
+ * @brief Records that a detection was started on the current frame.
+ */
+void DetectionScheduler::detectionStarted() {
+    framesSinceDetection = 0;
+}
+
+/**
+ * @brief Adapts the interval to the result of a detection.
+ * @param detectedCount the number of people found by the detection.
+ */
+void DetectionScheduler::detectionFinished(const int detectedCount) {
+    if (adaptive) {
+        if (detectedCount != lastDetectedCount) {
+            // People came or went, look again soon
+            interval = MIN_DETECTION_INTERVAL;
+        } else if (detectedCount == 0) {
+            // The scene stays empty, back off
+            interval = std::min(interval * 2, MAX_DETECTION_INTERVAL);
+        } else {
+            // The same people are still there, relax towards the regular interval
+            interval = std::min(interval * 2, FAST_TRACKING_FRAMES);
+        }
+    }
+
+    lastDetectedCount = detectedCount;
+}
+
+/**
+ * @brief Adapts the interval to the health of the trackers after a frame has been processed.
+ * @param lostCount the number of trackers that could not locate their object in this frame.
+ * @param nearThresholdCount the number of objects close to the enter/exit threshold.
+ */
+void DetectionScheduler::frameTracked(const int lostCount, const int nearThresholdCount) {
+    framesSinceDetection++;
+
+    if (!adaptive) {
+        return;
+    }
+
+    if (lostCount > 0) {
+        // A tracker lost its object, recover it as soon as possible
+        interval = MIN_DETECTION_INTERVAL;
+    } else if (nearThresholdCount > 0) {
+        // Someone is about to cross, keep their box accurate
+        interval = std::min(interval, std::max(FAST_TRACKING_FRAMES / 2, MIN_DETECTION_INTERVAL));
+    }
+}
+
+/**
+ * @brief Resets the schedule so the next frame is a detection frame.
+ */
+void DetectionScheduler::reset() {
+    interval = FAST_TRACKING_FRAMES;
+    framesSinceDetection = getInterval();
+    lastDetectedCount = 0;
+}
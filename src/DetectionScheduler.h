@@ -0,0 +1,91 @@
+/**
+ * @file DetectionScheduler.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decides on which frames the object tracker runs its detector
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef DETECTIONSCHEDULER_H
+#define DETECTIONSCHEDULER_H
+
+/**
+ * The number of consecutive frames for which fast object tracking will occur.
+ * After this, a slower, more computationally expensive object detection algorithm is used for one frame.
+ * Used as the fixed interval, and as the interval an adaptive schedule settles at for a steady scene.
+ */
+#define FAST_TRACKING_FRAMES 30
+
+/**
+ * The shortest interval an adaptive schedule uses, when tracks are lost or the number of people changes.
+ */
+#define MIN_DETECTION_INTERVAL 5
+
+/**
+ * The longest interval an adaptive schedule backs off to while the scene stays empty.
+ */
+#define MAX_DETECTION_INTERVAL 120
+
+/**
+ * @brief Class that decides on which frames the object tracker runs its detector.
+ * With a fixed schedule, detection runs every FAST_TRACKING_FRAMES frames. With an adaptive schedule, the
+ * interval backs off while detections keep coming back empty, shrinks to the minimum when trackers lose
+ * their object or the number of detected people changes, and is capped at half of FAST_TRACKING_FRAMES (but no
+ * less than MIN_DETECTION_INTERVAL) while objects are near the threshold. Otherwise it relaxes back towards
+ * FAST_TRACKING_FRAMES.
+ */
+class DetectionScheduler {
+    public:
+        DetectionScheduler(const bool adaptive = false);
+
+        ~DetectionScheduler();
+
+        bool isAdaptive() const;
+
+        void setAdaptive(const bool adaptive);
+
+        int getInterval() const;
+
+        int getIntervalScale() const;
+
+        void setIntervalScale(const int scale);
+
+        bool isDetectionDue() const;
+
+        void expedite();
+
+        void delay(const int frames);
+
+        void detectionStarted();
+
+        void detectionFinished(const int detectedCount);
+
+        void frameTracked(const int lostCount, const int nearThresholdCount);
+
+        void reset();
+
+    private:
+        bool adaptive;
+
+        /**
+         * The current number of frames between two detections.
+         */
+        int interval;
+
+        /**
+         * The factor the interval is stretched by, to detect less often under load.
+         */
+        int scale;
+
+        /**
+         * The number of frames processed since the last detection started.
+         */
+        int framesSinceDetection;
+
+        /**
+         * The number of people found by the previous detection.
+         */
+        int lastDetectedCount;
+};
+
+#endif // DETECTIONSCHEDULER_H
@@ -0,0 +1,197 @@
+/**
+ * @file DetectionSlots.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Process-wide scheduler handing out detection slots to the trackers of every stream in turn
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "DetectionSlots.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs the DetectionSlots object, without a limit on concurrent detections.
+ */
+DetectionSlots::DetectionSlots() {
+    capacity = DEFAULT_DETECTION_SLOTS;
+    active = 0;
+    nextTicket = 0;
+    granted = 0;
+    deferred = 0;
+    clock.start();
+}
+
+/**
+ * @brief Destructs the DetectionSlots object.
+ */
+DetectionSlots::~DetectionSlots() {
+
+}
+
+/**
+ * @brief Returns the scheduler shared by every tracker in the process.
+ * @return the scheduler.
+ */
+DetectionSlots& DetectionSlots::instance() {
+    static DetectionSlots scheduler;
+    return scheduler;
+}
+
+/**
+ * @brief Adds a tracker to the schedule.
+ * @return the identifier of the tracker in the schedule.
+ */
+int DetectionSlots::join() {
+    QMutexLocker locker(&mutex);
+
+    for (std::size_t i = 0; i < clients.size(); i++) {
+        if (!clients[i].joined) {
+            clients[i] = { true, false, 0, 0, 0 };
+            return static_cast<int>(i);
+        }
+    }
+
+    clients.push_back({ true, false, 0, 0, 0 });
+
+    return static_cast<int>(clients.size()) - 1;
+}
+
+/**
+ * @brief Removes a tracker from the schedule, giving back every slot it still holds.
+ * @param client the identifier of the tracker.
+ */
+void DetectionSlots::leave(const int client) {
+    QMutexLocker locker(&mutex);
+
+    active -= clients[client].held;
+    clients[client] = { false, false, 0, 0, 0 };
+}
+
+/**
+ * @brief Returns the phase of a tracker, the offset of its detection frames from those of the first tracker.
+ * Phases are spread evenly over the interval, in the order trackers joined.
+ * @param client the identifier of the tracker.
+ * @param interval the number of frames between two detections of the tracker.
+ * @return the phase, in frames.
+ */
+int DetectionSlots::getPhase(const int client, const int interval) const {
+    QMutexLocker locker(&mutex);
+
+    int rank = 0;
+    int count = 0;
+
+    for (std::size_t i = 0; i < clients.size(); i++) {
+        if (clients[i].joined) {
+            rank += static_cast<int>(i) < client ? 1 : 0;
+            count++;
+        }
+    }
+
+    return count > 0 ? rank * interval / count : 0;
+}
+
+/**
+ * @brief Takes a slot for a detection, without waiting.
+ * A tracker is granted a slot if one is free once every tracker that waited longer got one.
+ * @param client the identifier of the tracker.
+ * @return true if the tracker may detect now and must release() the slot later, false if it must ask again.
+ */
+bool DetectionSlots::tryAcquire(const int client) {
+    QMutexLocker locker(&mutex);
+    auto& self = clients[client];
+
+    if (!self.waiting) {
+        self.waiting = true;
+        self.ticket = nextTicket++;
+    }
+
+    self.asked = clock.elapsed();
+
+    // Trackers that waited longer go first, so one detecting often cannot starve the others.
+    // A tracker that stopped asking, e.g. because its stream paused, no longer holds anyone up
+    int ahead = 0;
+
+    for (const auto& other : clients) {
+        ahead += other.waiting && other.ticket < self.ticket && self.asked - other.asked < DETECTION_SLOT_TIMEOUT ? 1 : 0;
+    }
+
+    if (capacity > 0 && active + ahead >= capacity) {
+        deferred++;
+        return false;
+    }
+
+    self.waiting = false;
+    self.held++;
+    active++;
+    granted++;
+
+    return true;
+}
+
+/**
+ * @brief Stops a tracker from waiting for a slot, when it no longer needs to detect.
+ * @param client the identifier of the tracker.
+ */
+void DetectionSlots::withdraw(const int client) {
+    QMutexLocker locker(&mutex);
+    clients[client].waiting = false;
+}
+
+/**
+ * @brief Gives back a slot taken by tryAcquire(), once the detection's results are applied or dropped.
+ * @param client the identifier of the tracker.
+ */
+void DetectionSlots::release(const int client) {
+    QMutexLocker locker(&mutex);
+
+    if (clients[client].held > 0) {
+        clients[client].held--;
+        active--;
+    }
+}
+
+/**
+ * @brief Returns the maximum number of detections running at once.
+ * @return the maximum number of detections, zero for no limit.
+ */
+int DetectionSlots::getCapacity() const {
+    QMutexLocker locker(&mutex);
+    return capacity;
+}
+
+/**
+ * @brief Sets the maximum number of detections running at once. Slots already held are kept.
+ * @param capacity the maximum number of detections, zero for no limit.
+ */
+void DetectionSlots::setCapacity(const int capacity) {
+    QMutexLocker locker(&mutex);
+    this->capacity = std::max(capacity, 0);
+}
+
+/**
+ * @brief Returns the number of detections currently running.
+ * @return the number of slots held.
+ */
+int DetectionSlots::getActiveCount() const {
+    QMutexLocker locker(&mutex);
+    return active;
+}
+
+/**
+ * @brief Returns the number of slots handed out so far.
+ * @return the number of granted slots.
+ */
+unsigned long long DetectionSlots::getGrantedCount() const {
+    QMutexLocker locker(&mutex);
+    return granted;
+}
+
+/**
+ * @brief Returns the number of times a tracker had to put off its detection because every slot was taken.
+ * @return the number of deferred detections.
+ */
+unsigned long long DetectionSlots::getDeferredCount() const {
+    QMutexLocker locker(&mutex);
+    return deferred;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file DetectionSlots.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Process-wide scheduler handing out detection slots to the trackers of every stream in turn
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef DETECTIONSLOTS_H
+#define DETECTIONSLOTS_H
+
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+/**
+ * The default maximum number of detections running at once, zero for no limit.
+ */
+#define DEFAULT_DETECTION_SLOTS 0
+
+/**
+ * The time after which a tracker waiting for a slot without asking again no longer goes first, in milliseconds.
+ */
+#define DETECTION_SLOT_TIMEOUT 1000
+
+/**
+ * @brief Process-wide scheduler spreading the detections of every tracker over time.
+ * Trackers starting together with the same interval would all detect on the same frames, so each tracker joining
+ * is given a phase, an offset of its detection frames evenly spread over the interval between the trackers.
+ * On top of that, at most a fixed number of detections run at once. A tracker takes a slot before detecting and
+ * gives it back once its detections are applied. Slots are not reserved for anyone, a congested tracker detecting
+ * more often uses the slots idle ones leave free. When trackers compete, the one waiting longest goes first, so
+ * every stream gets its turn. A tracker refused a slot keeps tracking and asks again on its next frame.
+ */
+class DetectionSlots {
+    public:
+        static DetectionSlots& instance();
+
+        int join();
+
+        void leave(const int client);
+
+        int getPhase(const int client, const int interval) const;
+
+        bool tryAcquire(const int client);
+
+        void withdraw(const int client);
+
+        void release(const int client);
+
+        int getCapacity() const;
+
+        void setCapacity(const int capacity);
+
+        int getActiveCount() const;
+
+        unsigned long long getGrantedCount() const;
+
+        unsigned long long getDeferredCount() const;
+
+    private:
+        DetectionSlots();
+
+        ~DetectionSlots();
+
+        DetectionSlots(const DetectionSlots&) = delete;
+
+        DetectionSlots& operator=(const DetectionSlots&) = delete;
+
+        /**
+         * A tracker taking part in the schedule.
+         */
+        struct Client {
+            // Whether the tracker is still taking part, entries of trackers that left are reused
+            bool joined;
+            // Whether the tracker is waiting for a slot
+            bool waiting;
+            // The order the tracker started waiting in, lower waited longer
+            unsigned long long ticket;
+            // The number of slots the tracker holds
+            int held;
+            // When the tracker last asked for a slot, in milliseconds of the scheduler's clock
+            qint64 asked;
+        };
+
+        /**
+         * Guards every member below, slots are taken and given back from every stream's worker thread.
+         */
+        mutable QMutex mutex;
+
+        std::vector<Client> clients;
+
+        /**
+         * The maximum number of detections running at once, zero for no limit.
+         */
+        int capacity;
+
+        /**
+         * The number of slots currently held.
+         */
+        int active;
+
+        /**
+         * The ticket given to the next tracker to start waiting.
+         */
+        unsigned long long nextTicket;
+
+        QElapsedTimer clock;
+
+        /**
+         * The number of slots handed out, and of requests refused because every slot was taken.
+         */
+        unsigned long long granted;
+        unsigned long long deferred;
+};
+
+#endif // DETECTIONSLOTS_H
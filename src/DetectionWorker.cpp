@@ -0,0 +1,50 @@
+/**
+ * @file DetectionWorker.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs person detection in the background on behalf of an object tracker
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "DetectionWorker.h"
+#include "ModelRegistry.h"
+
+/**
+ * @brief Constructs a new DetectionWorker object. Its network is loaded by the first request.
+ * @param parent the parent Qt object of this object.
+ */
+DetectionWorker::DetectionWorker(QObject *parent) : QObject(parent) {
+
+}
+
+/**
+ * @brief Destructs a DetectionWorker object.
+ */
+DetectionWorker::~DetectionWorker() {
+    ModelRegistry::instance().release(detector);
+}
+
+/**
+ * @brief Detects people in a snapshot frame and emits a signal containing their bounding boxes.
+ * @param frame the snapshot frame to detect people in. Must not be modified until the result is emitted.
+ * @param request an identifier for the request, passed back with the result.
+ * @param inputWidth the width of the network input.
+ * @param inputHeight the height of the network input.
+ * @param options the options of the detector to detect with.
+ * @param tiling how the frame is split into tiles.
+ */
+void DetectionWorker::detect(cv::Mat frame, unsigned int request, int inputWidth, int inputHeight, PersonDetector::Options options, PersonDetector::Tiling tiling) {
+    // The result is always emitted, even without a model, so the tracker gives back its detection slot
+    const bool acquired = ModelRegistry::instance().acquire(detector, options, cv::Size(inputWidth, inputHeight));
+    std::vector<cv::Rect> boxes;
+
+    if (acquired) {
+        try {
+            boxes = detector->detectTiled(frame, tiling);
+        } catch (const std::exception& e) {
+            detector->reportFailure(e);
+        }
+    }
+
+    emit detected(boxes, request);
+}
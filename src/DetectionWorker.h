@@ -0,0 +1,50 @@
+/**
+ * @file DetectionWorker.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs person detection in the background on behalf of an object tracker
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef DETECTIONWORKER_H
+#define DETECTIONWORKER_H
+
+#include <memory>
+#include <vector>
+
+#include <QMetaType>
+#include <QObject>
+
+#include <opencv2/opencv.hpp>
+
+#include "PersonDetector.h"
+
+/**
+ * @brief Class that runs person detection in the background on behalf of an object tracker.
+ * Lives on its own thread with its own network. Detection requests and results are exchanged with
+ * queued signals, so the tracker keeps tracking live frames while a snapshot frame is being detected.
+ */
+class DetectionWorker : public QObject {
+    Q_OBJECT
+
+    public:
+        DetectionWorker(QObject *parent = 0);
+
+        ~DetectionWorker();
+
+    public slots:
+        void detect(cv::Mat frame, unsigned int request, int inputWidth, int inputHeight, PersonDetector::Options options, PersonDetector::Tiling tiling);
+
+    signals:
+        void detected(std::vector<cv::Rect> boxes, unsigned int request);
+
+    private:
+        /**
+         * The worker's own detector, acquired from the ModelRegistry by the first request and exchanged when the options change.
+         */
+        std::unique_ptr<PersonDetector> detector;
+};
+
+Q_DECLARE_METATYPE(std::vector<cv::Rect>)
+
+#endif // DETECTIONWORKER_H
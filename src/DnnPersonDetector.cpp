@@ -0,0 +1,124 @@
+/**
+ * @file DnnPersonDetector.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Detects people in a frame using OpenCV's dnn module
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "DnnPersonDetector.h"
+#include "ModelRegistry.h"
+
+#include <iostream>
+
+/**
+ * @brief Constructs a new DnnPersonDetector object, parsing the network from the model held by the ModelRegistry.
+ * @param options the options the detector is created with.
+ */
+DnnPersonDetector::DnnPersonDetector(const PersonDetector::Options& options) : PersonDetector(options) {
+    // The model files are read from disk once per process, every further detector parses them from memory
+    const ModelRegistry::Model& model = ModelRegistry::instance().getModel(options);
+
+    if (options.quantized) {
+        net = cv::dnn::readNetFromONNX(model.weights);
+    } else {
+        net = cv::dnn::readNetFromCaffe(model.architecture, model.weights);
+    }
+
+    net.setPreferableBackend(options.dnnBackend);
+    net.setPreferableTarget(options.dnnTarget);
+
+    layers = net.getUnconnectedOutLayersNames();
+    batching = true;
+}
+
+/**
+ * @brief Destructs a DnnPersonDetector object.
+ */
+DnnPersonDetector::~DnnPersonDetector() {
+
+}
+
+/**
+ * @brief Detects the people in the given frame.
+ * @param frame the 8-bit, 3-channel BGR frame to detect people in.
+ * @param confidences if not null, receives the confidence of each box.
+ * @return the bounding boxes of the detected people, in frame coordinates.
+ */
+std::vector<cv::Rect> DnnPersonDetector::detect(const cv::Mat& frame, std::vector<float> *confidences) {
+    // Create a 4D blob from the frame at the network's input size, reusing the previous blob's memory
+    net.setInput(preprocessor.process(frame));
+
+    // Run a forward pass on the neural network to detect objects
+    std::vector<cv::Mat> output;
+    net.forward(output, layers);
+
+    std::vector<cv::Rect> boxes;
+
+    // Neural network produces output blob with a shape of 1x1xNx7 where N is the number of detections
+    for (const auto& blob : output) {
+        collectPeople((const float *) blob.data, blob.total(), frame.size(), boxes, confidences);
+    }
+
+    return boxes;
+}
+
+/**
+ * @brief Detects the people in each of the given frames with a single forward pass over all of them.
+ * If the quantized network rejects a batch, this and every later batch are detected frame by frame instead.
+ * @param frames the 8-bit, 3-channel BGR frames to detect people in.
+ * @param confidences if not null, receives for each frame the confidence of each of its boxes.
+ * @return for each frame, the bounding boxes of the detected people, in frame coordinates.
+ */
+std::vector<std::vector<cv::Rect>> DnnPersonDetector::detectBatch(const std::vector<cv::Mat>& frames, std::vector<std::vector<float>> *confidences) {
+    std::vector<std::vector<cv::Rect>> results(frames.size());
+
+    if (confidences) {
+        confidences->assign(frames.size(), std::vector<float>());
+    }
+
+    if (frames.empty()) {
+        return results;
+    }
+
+    if (!batching || frames.size() == 1) {
+        return PersonDetector::detectBatch(frames, confidences);
+    }
+
+    // Write every frame into its own item of a single NCHW blob, reusing the previous blob's memory
+    const auto inputSize = preprocessor.getInputSize();
+    const int shape[] = { static_cast<int>(frames.size()), 3, inputSize.height, inputSize.width };
+    batchBlob.create(4, shape, CV_32F);
+
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        preprocessor.process(frames[i], batchBlob, static_cast<int>(i));
+    }
+
+    net.setInput(batchBlob);
+
+    std::vector<cv::Mat> output;
+
+    // Exported networks may have been given a fixed batch size of one, the Caffe network always takes batches
+    try {
+        net.forward(output, layers);
+    } catch (const cv::Exception& e) {
+        if (!options.quantized) {
+            throw;
+        }
+
+        std::cerr << "The INT8 network does not take batches, detecting frame by frame: " << e.err << std::endl;
+        batching = false;
+
+        return PersonDetector::detectBatch(frames, confidences);
+    }
+
+    // Detections of every frame share the output, the batch index of each tells them apart
+    for (const auto& blob : output) {
+        for (std::size_t i = 0; i < frames.size(); i++) {
+            collectPeople((const float *) blob.data, blob.total(), frames[i].size(), results[i], confidences ? &(*confidences)[i] : nullptr,
+                          static_cast<int>(i));
+        }
+    }
+
+    return results;
+}
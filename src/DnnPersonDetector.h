@@ -0,0 +1,67 @@
+/**
+ * @file DnnPersonDetector.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Detects people in a frame using OpenCV's dnn module
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef DNNPERSONDETECTOR_H
+#define DNNPERSONDETECTOR_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "PersonDetector.h"
+
+/**
+ * The path to the .prototxt file containg the network architecture stored in Caffe framework's format.
+ */
+#define MODEL_PROTOTXT_FILE "models/mobilenet_ssd/MobileNetSSD_deploy.prototxt"
+
+/**
+ * The path to the .caffemodel file containing the learned network stored in Caffe framework's format.
+ */
+#define MODEL_CAFFEMODEL_FILE "models/mobilenet_ssd/MobileNetSSD_deploy.caffemodel"
+
+/**
+ * @brief Class that detects people in a frame with the Caffe MobileNet-SSD running on OpenCV's dnn module.
+ * The quantized network is loaded from MODEL_QUANTIZED_ONNX_FILE instead. The network runs on the backend and
+ * target given by the options. OpenCV has no per-network thread count, its forward passes use the process-wide
+ * count set with PersonDetector::setOpenCvThreads().
+ */
+class DnnPersonDetector : public PersonDetector {
+    public:
+        DnnPersonDetector(const Options& options = Options());
+
+        ~DnnPersonDetector();
+
+        std::vector<cv::Rect> detect(const cv::Mat& frame, std::vector<float> *confidences = nullptr) override;
+
+        std::vector<std::vector<cv::Rect>> detectBatch(const std::vector<cv::Mat>& frames, std::vector<std::vector<float>> *confidences = nullptr) override;
+
+    private:
+        /**
+         * The neural network used to detect objects in a frame.
+         */
+        cv::dnn::Net net;
+
+        /**
+         * The names of layers in the neural network with unconnected outputs.
+         * Forward passes are run to compute outputs of these layers.
+         */
+        std::vector<cv::String> layers;
+
+        /**
+         * Reused NCHW blob holding a batch of frames.
+         */
+        cv::Mat batchBlob;
+
+        /**
+         * Whether batches are detected in a single forward pass, cleared if the network rejects a batch.
+         */
+        bool batching;
+};
+
+#endif // DNNPERSONDETECTOR_H
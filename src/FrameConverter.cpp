@@ -0,0 +1,141 @@
+/**
+ * @file FrameConverter.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decodes frames at the resolution and pixel format they are processed in
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "FrameConverter.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs a new FrameConverter object, delivering frames as decoded.
+ */
+FrameConverter::FrameConverter() {
+    format = PixelFormat::BgrFormat;
+    converting = false;
+}
+
+/**
+ * @brief Destructs a FrameConverter object.
+ */
+FrameConverter::~FrameConverter() {
+
+}
+
+/**
+ * @brief Sets the resolution and pixel format frames of an opened capture are delivered in.
+ * Frames are never upscaled. The capture is asked to decode at the target resolution and pixel format, whatever it
+ * does not deliver is converted after decoding.
+ * @param capture the opened capture, must not be read from meanwhile.
+ * @param size the target resolution. An empty size keeps the decoded resolution, a zero width or height keeps the aspect ratio.
+ * @param format the target pixel format.
+ */
+void FrameConverter::configure(VideoDecoder& capture, const cv::Size size, const FrameConverter::PixelFormat format) {
+    cv::Size sourceSize(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    cv::Size targetSize = sourceSize;
+
+    if (sourceSize.area() > 0 && (size.width > 0 || size.height > 0)) {
+        const double scaleX = size.width > 0 ? static_cast<double>(size.width) / sourceSize.width : 0.0;
+        const double scaleY = size.height > 0 ? static_cast<double>(size.height) / sourceSize.height : 0.0;
+
+        // A missing dimension follows the other one, neither grows past the source
+        const double scaleWidth = std::min(scaleX > 0 ? scaleX : scaleY, 1.0);
+        const double scaleHeight = std::min(scaleY > 0 ? scaleY : scaleX, 1.0);
+
+        targetSize = cv::Size(std::max(static_cast<int>(std::lround(sourceSize.width * scaleWidth)), 1),
+                              std::max(static_cast<int>(std::lround(sourceSize.height * scaleHeight)), 1));
+    }
+
+    // Cameras usually switch to a smaller mode and FFmpeg's libraries scale while decoding, OpenCV's file decoders ignore the request
+    if (targetSize != sourceSize) {
+        capture.set(cv::CAP_PROP_FRAME_WIDTH, targetSize.width);
+        capture.set(cv::CAP_PROP_FRAME_HEIGHT, targetSize.height);
+
+        sourceSize = cv::Size(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    }
+
+    // A mode at most as large as the target is used as is
+    if (sourceSize.width <= targetSize.width && sourceSize.height <= targetSize.height) {
+        targetSize = sourceSize;
+    }
+
+    // Only FFmpeg's libraries convert to grayscale while decoding
+    const bool decodedGray = format == PixelFormat::GrayFormat && capture.set(cv::CAP_PROP_FORMAT, CV_8UC1);
+
+    frameSize = targetSize;
+    this->format = format;
+    converting = targetSize != sourceSize || (format != PixelFormat::BgrFormat && !decodedGray);
+
+    decoded.release();
+    resized.release();
+}
+
+/**
+ * @brief Returns the size frames are delivered in.
+ * @return the frame size, empty if the capture did not report its size.
+ */
+cv::Size FrameConverter::getFrameSize() const {
+    return frameSize;
+}
+
+/**
+ * @brief Returns the OpenCV type frames are delivered in.
+ * @return CV_8UC1 for grayscale, CV_8UC3 for BGR.
+ */
+int FrameConverter::getFrameType() const {
+    return format == PixelFormat::GrayFormat ? CV_8UC1 : CV_8UC3;
+}
+
+/**
+ * @brief Returns the pixel format frames are delivered in.
+ * @return the pixel format.
+ */
+FrameConverter::PixelFormat FrameConverter::getPixelFormat() const {
+    return format;
+}
+
+/**
+ * @brief Returns whether decoded frames are converted before being delivered.
+ * @return true if frames are resized or converted after decoding, false if they are delivered as decoded.
+ */
+bool FrameConverter::isConverting() const {
+    return converting;
+}
+
+/**
+ * @brief Decodes the next frame in the target resolution and pixel format.
+ * @param capture the capture to decode from.
+ * @param frame receives the frame. A buffer of the right size and type is written in place.
+ * @return false if the capture has no more frames.
+ */
+bool FrameConverter::read(VideoDecoder& capture, cv::Mat& frame) {
+    if (!converting) {
+        return capture.read(frame);
+    }
+
+    if (!capture.read(decoded)) {
+        return false;
+    }
+
+    const bool resize = frameSize.area() > 0 && decoded.size() != frameSize;
+    const bool convert = decoded.channels() != CV_MAT_CN(getFrameType());
+    const int code = format == PixelFormat::GrayFormat ? cv::COLOR_BGR2GRAY : cv::COLOR_GRAY2BGR;
+
+    // Resize first, so the color conversion only touches the smaller image
+    if (resize && convert) {
+        cv::resize(decoded, resized, frameSize, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(resized, frame, code);
+    } else if (resize) {
+        cv::resize(decoded, frame, frameSize, 0, 0, cv::INTER_AREA);
+    } else if (convert) {
+        cv::cvtColor(decoded, frame, code);
+    } else {
+        decoded.copyTo(frame);
+    }
+
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file FrameConverter.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decodes frames at the resolution and pixel format they are processed in
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef FRAMECONVERTER_H
+#define FRAMECONVERTER_H
+
+#include <opencv2/opencv.hpp>
+
+#include "VideoDecoder.h"
+
+/**
+ * @brief Class that decodes frames from a capture at the resolution and pixel format they are processed in.
+ * The capture is first asked to deliver the target resolution and pixel format itself, which cameras usually do by
+ * switching to a smaller mode and files decoded by FFmpeg's libraries do while decoding. Whatever the capture cannot
+ * deliver is converted right after decoding: a single area resize, and for grayscale a single color conversion of
+ * the already resized image. Every later stage then reads fewer bytes per frame. Without a target, frames are decoded
+ * straight into the caller's buffer.
+ */
+class FrameConverter {
+    public:
+        /**
+         * Enumeration used to specify the pixel format frames are delivered in.
+         */
+        enum PixelFormat {
+            // 8-bit, 3-channel BGR, as decoded by OpenCV
+            BgrFormat,
+            // 8-bit, single-channel grayscale, a third of the bytes per pixel
+            GrayFormat
+        };
+
+        FrameConverter();
+
+        ~FrameConverter();
+
+        void configure(VideoDecoder& capture, const cv::Size size = cv::Size(), const PixelFormat format = BgrFormat);
+
+        cv::Size getFrameSize() const;
+
+        int getFrameType() const;
+
+        PixelFormat getPixelFormat() const;
+
+        bool isConverting() const;
+
+        bool read(VideoDecoder& capture, cv::Mat& frame);
+
+    private:
+        /**
+         * The size and format frames are delivered in.
+         */
+        cv::Size frameSize;
+        PixelFormat format;
+
+        /**
+         * Whether decoded frames need converting, or are decoded straight into the caller's buffer.
+         */
+        bool converting;
+
+        /**
+         * Reused buffers holding the decoded frame and the resized frame before its color conversion.
+         */
+        cv::Mat decoded;
+        cv::Mat resized;
+};
+
+#endif // FRAMECONVERTER_H
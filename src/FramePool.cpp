@@ -0,0 +1,300 @@
+/**
+ * @file FramePool.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Fixed set of recycled frame buffers handed out as reference-counted handles
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "FramePool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+
+/**
+ * A single pooled buffer.
+ */
+struct FramePool::Slot {
+    /**
+     * The buffer itself. Keeps its allocation between uses as long as the frame size and type do not change.
+     */
+    cv::Mat mat;
+
+    /**
+     * The number of handles referring to this buffer.
+     */
+    QAtomicInt references;
+
+    /**
+     * The storage this buffer returns to. Only set while the buffer is in use, keeping the storage alive.
+     */
+    std::shared_ptr<Storage> storage;
+};
+
+/**
+ * The buffers of a pool along with their bookkeeping.
+ */
+struct FramePool::Storage {
+    QMutex mutex;
+
+    /**
+     * Signalled whenever a buffer is returned.
+     */
+    QWaitCondition available;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    /**
+     * Buffers currently not in use. Reserved up front so releasing never allocates.
+     */
+    std::vector<Slot*> freeSlots;
+
+    int inUse = 0;
+    int peakInUse = 0;
+    unsigned long long exhausted = 0;
+
+    /**
+     * @brief Returns a buffer whose last handle was destroyed to the free list.
+     * @param slot the buffer to return.
+     */
+    void release(Slot *slot) {
+        QMutexLocker locker(&mutex);
+        freeSlots.push_back(slot);
+        inUse--;
+        available.wakeOne();
+    }
+};
+
+/**
+ * @brief Constructs a new FramePool object.
+ * @param capacity the number of buffers in the pool (at least one).
+ */
+FramePool::FramePool(const int capacity) {
+    setCapacity(capacity);
+}
+
+/**
+ * @brief Destructs a FramePool object. Buffers still in use are freed once their last handle is destroyed.
+ */
+FramePool::~FramePool() {
+
+}
+
+/**
+ * @brief Takes a buffer from the pool.
+ * @param timeout the time in milliseconds to wait for a buffer if none is available, zero to return immediately.
+ * @return a handle to the buffer, or a null handle if the pool stayed exhausted.
+ */
+FrameHandle FramePool::acquire(const int timeout) {
+    QMutexLocker locker(&storage->mutex);
+
+    if (storage->freeSlots.empty()) {
+        storage->exhausted++;
+
+        if (timeout > 0) {
+            storage->available.wait(&storage->mutex, timeout);
+        }
+
+        if (storage->freeSlots.empty()) {
+            return FrameHandle();
+        }
+    }
+
+    Slot *slot = storage->freeSlots.back();
+    storage->freeSlots.pop_back();
+
+    storage->inUse++;
+    storage->peakInUse = std::max(storage->peakInUse, storage->inUse);
+
+    slot->references.storeRelease(1);
+    slot->storage = storage;
+
+    return FrameHandle(slot);
+}
+
+/**
+ * @brief Allocates every free buffer for the given frame size and type, so decoding never has to.
+ * @param size the frame size.
+ * @param type the OpenCV type of the frames, e.g. CV_8UC3.
+ */
+void FramePool::reserve(const cv::Size size, const int type) {
+    QMutexLocker locker(&storage->mutex);
+
+    for (auto slot : storage->freeSlots) {
+        slot->mat.create(size, type);
+    }
+}
+
+/**
+ * @brief Returns the number of buffers in the pool.
+ * @return the number of buffers in the pool.
+ */
+int FramePool::getCapacity() const {
+    QMutexLocker locker(&storage->mutex);
+    return static_cast<int>(storage->slots.size());
+}
+
+/**
+ * @brief Replaces the pool's buffers with the given number of new ones.
+ * Buffers of the previous set that are still in use stay valid until their last handle is destroyed.
+ * @param capacity the number of buffers in the pool (at least one).
+ */
+void FramePool::setCapacity(const int capacity) {
+    auto resized = std::make_shared<Storage>();
+    const int count = std::max(capacity, 1);
+
+    resized->slots.reserve(count);
+    resized->freeSlots.reserve(count);
+
+    for (int i = 0; i < count; i++) {
+        resized->slots.emplace_back(new Slot);
+        resized->freeSlots.push_back(resized->slots.back().get());
+    }
+
+    storage = resized;
+}
+
+/**
+ * @brief Returns the number of buffers currently referred to by at least one handle.
+ * @return the number of buffers in use.
+ */
+int FramePool::getInUseCount() const {
+    QMutexLocker locker(&storage->mutex);
+    return storage->inUse;
+}
+
+/**
+ * @brief Returns the highest number of buffers in use at once since the counters were last reset.
+ * A peak equal to the capacity means the pool was too small at some point.
+ * @return the peak number of buffers in use.
+ */
+int FramePool::getPeakInUseCount() const {
+    QMutexLocker locker(&storage->mutex);
+    return storage->peakInUse;
+}
+
+/**
+ * @brief Returns the number of times a buffer was requested while none was available.
+ * @return the number of times the pool was exhausted.
+ */
+unsigned long long FramePool::getExhaustedCount() const {
+    QMutexLocker locker(&storage->mutex);
+    return storage->exhausted;
+}
+
+/**
+ * @brief Resets the peak and exhausted counters.
+ */
+void FramePool::resetCounters() {
+    QMutexLocker locker(&storage->mutex);
+    storage->peakInUse = storage->inUse;
+    storage->exhausted = 0;
+}
+
+/**
+ * @brief Constructs a null FrameHandle.
+ */
+FrameHandle::FrameHandle() {
+    slot = nullptr;
+}
+
+/**
+ * @brief Constructs a FrameHandle owning the first reference to a freshly acquired buffer.
+ * @param slot the acquired buffer.
+ */
+FrameHandle::FrameHandle(FramePool::Slot *slot) {
+    this->slot = slot;
+}
+
+/**
+ * @brief Constructs a FrameHandle sharing the buffer of another handle.
+ * @param other the handle to share the buffer of.
+ */
+FrameHandle::FrameHandle(const FrameHandle& other) {
+    slot = other.slot;
+
+    if (slot) {
+        slot->references.ref();
+    }
+}
+
+/**
+ * @brief Constructs a FrameHandle taking over the buffer of another handle, leaving the other handle null.
+ * @param other the handle to take the buffer from.
+ */
+FrameHandle::FrameHandle(FrameHandle&& other) {
+    slot = other.slot;
+    other.slot = nullptr;
+}
+
+/**
+ * @brief Destructs a FrameHandle, returning the buffer to its pool if this was the last handle to it.
+ */
+FrameHandle::~FrameHandle() {
+    reset();
+}
+
+/**
+ * @brief Makes this handle share the buffer of another handle.
+ * @param other the handle to share the buffer of.
+ * @return this handle.
+ */
+FrameHandle& FrameHandle::operator=(const FrameHandle& other) {
+    if (other.slot) {
+        other.slot->references.ref();
+    }
+
+    reset();
+    slot = other.slot;
+
+    return *this;
+}
+
+/**
+ * @brief Makes this handle take over the buffer of another handle, leaving the other handle null.
+ * @param other the handle to take the buffer from.
+ * @return this handle.
+ */
+FrameHandle& FrameHandle::operator=(FrameHandle&& other) {
+    if (this != &other) {
+        reset();
+        slot = other.slot;
+        other.slot = nullptr;
+    }
+
+    return *this;
+}
+
+/**
+ * @brief Returns whether this handle refers to no buffer.
+ * @return true if the handle is null.
+ */
+bool FrameHandle::isNull() const {
+    return slot == nullptr;
+}
+
+/**
+ * @brief Returns the pooled buffer. Must not be called on a null handle.
+ * @return the pooled buffer.
+ */
+cv::Mat& FrameHandle::mat() const {
+    return slot->mat;
+}
+
+/**
+ * @brief Drops this handle's reference, returning the buffer to its pool if it was the last one.
+ */
+void FrameHandle::reset() {
+    if (slot && !slot->references.deref()) {
+        // Keep the storage alive until the buffer is back in it, the pool may have been destroyed meanwhile
+        std::shared_ptr<FramePool::Storage> storage;
+        storage.swap(slot->storage);
+        storage->release(slot);
+    }
+
+    slot = nullptr;
+}
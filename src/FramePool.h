@@ -0,0 +1,105 @@
+/**
+ * @file FramePool.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Fixed set of recycled frame buffers handed out as reference-counted handles
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <memory>
+
+#include <QMetaType>
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * The default number of buffers in a frame pool.
+ * Should cover the frame queue, the frames in flight through the processing chain and the frame being decoded.
+ */
+#define DEFAULT_FRAME_POOL_CAPACITY 8
+
+class FrameHandle;
+
+/**
+ * @brief Class that recycles a fixed set of frame buffers.
+ * Buffers are handed out as reference-counted FrameHandles and return to the pool once the last handle
+ * referring to them is destroyed, so frames can be passed between threads without copying pixels and
+ * nothing is allocated per frame once the buffers have been sized. Outstanding handles keep the buffers
+ * alive even if the pool is destroyed or resized in the meantime.
+ */
+class FramePool {
+    public:
+        FramePool(const int capacity = DEFAULT_FRAME_POOL_CAPACITY);
+
+        ~FramePool();
+
+        FrameHandle acquire(const int timeout = 0);
+
+        void reserve(const cv::Size size, const int type);
+
+        int getCapacity() const;
+
+        void setCapacity(const int capacity);
+
+        int getInUseCount() const;
+
+        int getPeakInUseCount() const;
+
+        unsigned long long getExhaustedCount() const;
+
+        void resetCounters();
+
+    private:
+        friend class FrameHandle;
+
+        struct Slot;
+        struct Storage;
+
+        /**
+         * The buffers and bookkeeping of the pool, shared with every handle currently in use.
+         */
+        std::shared_ptr<Storage> storage;
+};
+
+/**
+ * @brief Reference-counted handle to a pooled frame buffer.
+ * Copying a handle shares the buffer, the buffer goes back to its pool when the last copy is destroyed.
+ * Headers obtained through mat() must not outlive the handle, the buffer is reused once it is released.
+ */
+class FrameHandle {
+    public:
+        FrameHandle();
+
+        FrameHandle(const FrameHandle& other);
+
+        FrameHandle(FrameHandle&& other);
+
+        ~FrameHandle();
+
+        FrameHandle& operator=(const FrameHandle& other);
+
+        FrameHandle& operator=(FrameHandle&& other);
+
+        bool isNull() const;
+
+        cv::Mat& mat() const;
+
+        void reset();
+
+    private:
+        friend class FramePool;
+
+        FrameHandle(FramePool::Slot *slot);
+
+        /**
+         * The pooled buffer this handle refers to, null for an empty handle.
+         */
+        FramePool::Slot *slot;
+};
+
+Q_DECLARE_METATYPE(FrameHandle)
+
+#endif // FRAMEPOOL_H
@@ -0,0 +1,111 @@
+/**
+ * @file FramePyramid.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Grayscale image pyramid of a frame, built once and shared by every tracked object
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "FramePyramid.h"
+
+#include <utility>
+
+/**
+ * @brief Constructs a new, empty FramePyramid object.
+ */
+FramePyramid::FramePyramid() {
+
+}
+
+/**
+ * @brief Destructs a FramePyramid object.
+ */
+FramePyramid::~FramePyramid() {
+
+}
+
+/**
+ * @brief Builds the pyramid of a frame, reusing the buffers of the previous one.
+ * @param frame the 8-bit BGR or grayscale frame. Its pixels are shared until detach() is called.
+ * @param withGray whether to convert the frame to grayscale.
+ * @param withLevels whether to build the optical flow pyramid, implies the grayscale frame.
+ */
+void FramePyramid::build(const cv::Mat& frame, const bool withGray, const bool withLevels) {
+    this->frame = frame;
+
+    if (withGray || withLevels) {
+        // The grayscale frame is owned by the pyramid, it is kept after the frame returns to its pool
+        if (frame.channels() == 1) {
+            frame.copyTo(gray);
+        } else {
+            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        }
+    } else {
+        gray.release();
+    }
+
+    if (withLevels) {
+        cv::buildOpticalFlowPyramid(gray, levels, cv::Size(FLOW_WINDOW_SIZE, FLOW_WINDOW_SIZE), FLOW_PYRAMID_LEVELS);
+    } else {
+        levels.clear();
+    }
+}
+
+/**
+ * @brief Builds the color and grayscale frames only, for initializing trackers on a frame that is not tracked in.
+ * @param frame the 8-bit BGR or grayscale frame.
+ */
+void FramePyramid::build(const cv::Mat& frame) {
+    build(frame, true, false);
+}
+
+/**
+ * @brief Releases every image of the pyramid.
+ */
+void FramePyramid::clear() {
+    frame.release();
+    gray.release();
+    levels.clear();
+}
+
+/**
+ * @brief Drops the reference to the color frame, keeping the grayscale images owned by the pyramid.
+ * Must be called before the frame's buffer is handed on, when the pyramid is kept for the next frame.
+ */
+void FramePyramid::detach() {
+    frame.release();
+}
+
+/**
+ * @brief Exchanges the contents of two pyramids without copying, used to keep the previous frame's pyramid.
+ * @param other the pyramid to exchange contents with.
+ */
+void FramePyramid::swap(FramePyramid& other) {
+    std::swap(frame, other.frame);
+    std::swap(gray, other.gray);
+    levels.swap(other.levels);
+}
+
+/**
+ * @brief Returns the color frame.
+ * @return the color frame, empty if the pyramid was not built.
+ */
+const cv::Mat& FramePyramid::getFrame() const {
+    return frame;
+}
+
+/**
+ * @brief Returns the grayscale frame.
+ * @return the grayscale frame, empty if it was not requested.
+ */
+const cv::Mat& FramePyramid::getGray() const {
+    return gray;
+}
+
+/**
+ * @brief Returns the optical flow pyramid, the full resolution grayscale frame first.
+ * @return the pyramid's levels with their gradients, empty if they were not requested.
+ */
+const std::vector<cv::Mat>& FramePyramid::getLevels() const {
+    return levels;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file FramePyramid.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Grayscale image pyramid of a frame, built once and shared by every tracked object
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * The size of the search window of the optical flow, in pixels at each pyramid level.
+ */
+#define FLOW_WINDOW_SIZE 21
+
+/**
+ * The number of downscaled levels above the full resolution grayscale frame.
+ */
+#define FLOW_PYRAMID_LEVELS 3
+
+/**
+ * @brief Grayscale image pyramid of a frame, built once and shared by every tracked object.
+ * Holds the color frame, its grayscale version and, if requested, the downscaled pyramid with gradients used
+ * by the optical flow. Without it, every tracker would convert and downscale the same frame on its own.
+ * The pyramid is only read while objects are updated, so objects updated in parallel can share it.
+ */
+class FramePyramid {
+    public:
+        FramePyramid();
+
+        ~FramePyramid();
+
+        void build(const cv::Mat& frame, const bool withGray, const bool withLevels);
+
+        void build(const cv::Mat& frame);
+
+        void clear();
+
+        void detach();
+
+        void swap(FramePyramid& other);
+
+        const cv::Mat& getFrame() const;
+
+        const cv::Mat& getGray() const;
+
+        const std::vector<cv::Mat>& getLevels() const;
+
+    private:
+        /**
+         * The color frame, sharing the caller's pixels until detached.
+         */
+        cv::Mat frame;
+
+        /**
+         * The grayscale frame, its buffer is reused from frame to frame.
+         */
+        cv::Mat gray;
+
+        /**
+         * The optical flow pyramid of the grayscale frame, empty unless requested.
+         */
+        std::vector<cv::Mat> levels;
+};
+
+#endif // FRAMEPYRAMID_H
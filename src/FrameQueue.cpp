@@ -0,0 +1,239 @@
+/**
+ * @file FrameQueue.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Bounded, thread-safe ring of frames shared between the capture thread and its consumer
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "FrameQueue.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Constructs a new FrameQueue object.
+ * @param capacity the maximum number of frames held by the queue (at least one).
+ * @param policy the policy applied when a frame is pushed into a full queue.
+ */
+FrameQueue::FrameQueue(const int capacity, const OverflowPolicy policy) {
+    ring.resize(std::max(capacity, 1));
+    head = 0;
+    count = 0;
+    closed = false;
+    this->policy = policy;
+    pushedFrames = 0;
+    droppedFrames = 0;
+    blockedPushes = 0;
+}
+
+/**
+ * @brief Destructs a FrameQueue object.
+ */
+FrameQueue::~FrameQueue() {
+    close();
+}
+
+/**
+ * @brief Pushes a frame into the queue, applying the overflow policy if the queue is full.
+ * @param frame the frame to push. Only the handle is stored, the pixel data is shared.
+ * @return true if the frame was queued, false if it was dropped or the queue is closed.
+ */
+bool FrameQueue::push(const FrameHandle& frame) {
+    QMutexLocker locker(&mutex);
+
+    if (closed) {
+        return false;
+    }
+
+    if (count == static_cast<int>(ring.size()) && policy == OverflowPolicy::Block) {
+        blockedPushes++;
+
+        // Wait for the consumer to make space, unless the queue is closed or the policy changes meanwhile
+        while (count == static_cast<int>(ring.size()) && !closed && policy == OverflowPolicy::Block) {
+            notFull.wait(&mutex);
+        }
+
+        if (closed) {
+            return false;
+        }
+    }
+
+    if (count == static_cast<int>(ring.size())) {
+        if (policy == OverflowPolicy::DropNewest) {
+            droppedFrames++;
+            return false;
+        }
+
+        // Overwrite the oldest frame and advance the head past it, its buffer returns to the pool
+        ring[head] = frame;
+        head = (head + 1) % ring.size();
+        droppedFrames++;
+        pushedFrames++;
+
+        return true;
+    }
+
+    ring[(head + count) % ring.size()] = frame;
+    count++;
+    pushedFrames++;
+
+    return true;
+}
+
+/**
+ * @brief Pops the oldest frame from the queue without blocking.
+ * @param frame receives the popped frame.
+ * @return true if a frame was popped, false if the queue was empty.
+ */
+bool FrameQueue::pop(FrameHandle& frame) {
+    QMutexLocker locker(&mutex);
+
+    if (count == 0) {
+        return false;
+    }
+
+    // Move the frame out so the ring does not keep its buffer from returning to the pool
+    frame = std::move(ring[head]);
+    head = (head + 1) % ring.size();
+    count--;
+
+    notFull.wakeOne();
+
+    return true;
+}
+
+/**
+ * @brief Removes every frame from the queue. Removed frames are not counted as dropped.
+ */
+void FrameQueue::clear() {
+    QMutexLocker locker(&mutex);
+
+    for (auto& frame : ring) {
+        frame.reset();
+    }
+
+    head = 0;
+    count = 0;
+
+    notFull.wakeAll();
+}
+
+/**
+ * @brief Closes the queue. Pushes are rejected and any producer blocked in push() is released.
+ */
+void FrameQueue::close() {
+    QMutexLocker locker(&mutex);
+    closed = true;
+    notFull.wakeAll();
+}
+
+/**
+ * @brief Reopens a previously closed queue so frames can be pushed again.
+ */
+void FrameQueue::reopen() {
+    QMutexLocker locker(&mutex);
+    closed = false;
+}
+
+/**
+ * @brief Returns the number of frames currently queued.
+ * @return the number of frames currently queued.
+ */
+int FrameQueue::size() const {
+    QMutexLocker locker(&mutex);
+    return count;
+}
+
+/**
+ * @brief Returns the maximum number of frames the queue can hold.
+ * @return the maximum number of frames the queue can hold.
+ */
+int FrameQueue::getCapacity() const {
+    QMutexLocker locker(&mutex);
+    return static_cast<int>(ring.size());
+}
+
+/**
+ * @brief Sets the maximum number of frames the queue can hold.
+ * The newest frames are kept if the queue shrinks below its current size, evicted frames are counted as dropped.
+ * @param capacity the new capacity (at least one).
+ */
+void FrameQueue::setCapacity(const int capacity) {
+    QMutexLocker locker(&mutex);
+
+    const int newCapacity = std::max(capacity, 1);
+    const int kept = std::min(count, newCapacity);
+
+    std::vector<FrameHandle> resized(newCapacity);
+
+    for (int i = 0; i < kept; i++) {
+        resized[i] = ring[(head + count - kept + i) % ring.size()];
+    }
+
+    droppedFrames += count - kept;
+
+    ring.swap(resized);
+    head = 0;
+    count = kept;
+
+    notFull.wakeAll();
+}
+
+/**
+ * @brief Returns the currently set overflow policy.
+ * @return the currently set overflow policy.
+ */
+FrameQueue::OverflowPolicy FrameQueue::getOverflowPolicy() const {
+    QMutexLocker locker(&mutex);
+    return policy;
+}
+
+/**
+ * @brief Sets the policy applied when a frame is pushed into a full queue.
+ * @param policy the overflow policy to set.
+ */
+void FrameQueue::setOverflowPolicy(const FrameQueue::OverflowPolicy policy) {
+    QMutexLocker locker(&mutex);
+    this->policy = policy;
+
+    // A producer blocked under the previous policy must re-evaluate
+    notFull.wakeAll();
+}
+
+/**
+ * @brief Returns the number of frames accepted by the queue since the counters were last reset.
+ * @return the number of frames accepted by the queue.
+ */
+unsigned long long FrameQueue::getPushedFrameCount() const {
+    QMutexLocker locker(&mutex);
+    return pushedFrames;
+}
+
+/**
+ * @brief Returns the number of frames dropped by the overflow policy since the counters were last reset.
+ * @return the number of dropped frames.
+ */
+unsigned long long FrameQueue::getDroppedFrameCount() const {
+    QMutexLocker locker(&mutex);
+    return droppedFrames;
+}
+
+/**
+ * @brief Returns the number of pushes that had to wait for space under the Block policy.
+ * @return the number of blocked pushes.
+ */
+unsigned long long FrameQueue::getBlockedPushCount() const {
+    QMutexLocker locker(&mutex);
+    return blockedPushes;
+}
+
+/**
+ * @brief Resets the pushed, dropped and blocked counters to zero.
+ */
+void FrameQueue::resetCounters() {
+    QMutexLocker locker(&mutex);
+    pushedFrames = 0;
+    droppedFrames = 0;
+    blockedPushes = 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file FrameQueue.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Bounded, thread-safe ring of frames shared between the capture thread and its consumer
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef FRAMEQUEUE_H
+#define FRAMEQUEUE_H
+
+#include <vector>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "FramePool.h"
+
+/**
+ * The default number of frames the queue can hold.
+ * A capacity of one turns the queue into a latest-frame mailbox.
+ */
+#define DEFAULT_FRAME_QUEUE_CAPACITY 1
+
+/**
+ * @brief Bounded ring of frames with a configurable overflow policy.
+ * The producer (capture thread) pushes frames and the consumer pops them. When the ring is full,
+ * the overflow policy decides whether the oldest frame is replaced, the new frame is discarded
+ * or the producer blocks until space is available. Dropped frames are counted.
+ */
+class FrameQueue {
+    public:
+        /**
+         * Enumeration used to specify what happens when a frame is pushed into a full queue.
+         */
+        enum OverflowPolicy {
+            // Replace the oldest queued frame with the new one
+            DropOldest,
+            // Discard the new frame and keep the queued ones
+            DropNewest,
+            // Block the producer until the consumer makes space
+            Block
+        };
+
+        FrameQueue(const int capacity = DEFAULT_FRAME_QUEUE_CAPACITY, const OverflowPolicy policy = DropOldest);
+
+        ~FrameQueue();
+
+        bool push(const FrameHandle& frame);
+
+        bool pop(FrameHandle& frame);
+
+        void clear();
+
+        void close();
+
+        void reopen();
+
+        int size() const;
+
+        int getCapacity() const;
+
+        void setCapacity(const int capacity);
+
+        OverflowPolicy getOverflowPolicy() const;
+
+        void setOverflowPolicy(const OverflowPolicy policy);
+
+        unsigned long long getPushedFrameCount() const;
+
+        unsigned long long getDroppedFrameCount() const;
+
+        unsigned long long getBlockedPushCount() const;
+
+        void resetCounters();
+
+    private:
+        /**
+         * Guards every member below, the queue is accessed from both the capture and consumer threads.
+         */
+        mutable QMutex mutex;
+
+        /**
+         * Signalled whenever space becomes available or the queue is closed. Used by the Block policy.
+         */
+        QWaitCondition notFull;
+
+        /**
+         * Fixed size storage for the ring. Frames are handles to pooled buffers, pixels are never copied.
+         */
+        std::vector<FrameHandle> ring;
+
+        /**
+         * Index of the oldest frame in the ring.
+         */
+        int head;
+
+        /**
+         * The number of frames currently in the ring.
+         */
+        int count;
+
+        /**
+         * Whether the queue has been closed. A closed queue rejects pushes and wakes blocked producers.
+         */
+        bool closed;
+
+        OverflowPolicy policy;
+
+        unsigned long long pushedFrames;
+        unsigned long long droppedFrames;
+        unsigned long long blockedPushes;
+};
+
+#endif // FRAMEQUEUE_H
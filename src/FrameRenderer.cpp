@@ -0,0 +1,156 @@
+/**
+ * @file FrameRenderer.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Draws tracking overlays on processed frames and converts them for display
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "FrameRenderer.h"
+
+#include <algorithm>
+#include <string>
+
+/**
+ * @brief Constructs a new FrameRenderer object.
+ * @param parent the parent Qt object of this object.
+ */
+FrameRenderer::FrameRenderer(QObject *parent) : QObject(parent) {
+
+}
+
+/**
+ * @brief Destructs a FrameRenderer object.
+ */
+FrameRenderer::~FrameRenderer() {
+
+}
+
+/**
+ * @brief Draws the overlays requested by the tracked frame's draw flags and converts it into a QImage.
+ * The overlays are drawn directly on the tracked frame's pixels.
+ * @param trackedFrame the processed frame along with a snapshot of its tracked objects.
+ * @return the rendered RGB image.
+ */
+QImage FrameRenderer::render(ObjectTracker::TrackedFrame& trackedFrame) {
+    using DrawFlag = ObjectTracker::DrawFlag;
+
+    cv::Mat& frame = trackedFrame.frame.mat();
+    const auto drawFlags = trackedFrame.drawFlags;
+    const auto& region = trackedFrame.regionOfInterest;
+
+    // Objects and thresholds are drawn on a view of the region they were tracked in, sharing the frame's pixels
+    cv::Mat view = frame(region);
+
+    for (const auto& object : trackedFrame.objects) {
+        // Draw the recent trajectory of the object if required, fading towards its oldest positions
+        if (drawFlags.testFlag(DrawFlag::DrawTrajectories)) {
+            for (std::size_t age = 1; age < object.trajectory.size(); age++) {
+                const double fade = 1.0 - static_cast<double>(age) / object.trajectory.size();
+                cv::line(view, object.trajectory[age - 1], object.trajectory[age], cv::Scalar(255 * fade, 0, 255 * fade), 1, cv::LINE_AA);
+            }
+        }
+
+        // Draw the bounding box of the object if required
+        if (drawFlags.testFlag(DrawFlag::DrawBoundingBoxes)) {
+            cv::rectangle(view, object.bbox, cv::Scalar(255, 0, 0), 1, cv::LINE_AA);
+        }
+
+        // Draw the centroid of the object if required
+        if (drawFlags.testFlag(DrawFlag::DrawCentroids)) {
+            cv::circle(view, object.position, 2, cv::Scalar(0, 255, 255), -1, cv::LINE_AA);
+        }
+
+        // Display the object's current state if required
+        if (drawFlags.testFlag(DrawFlag::ShowStates)) {
+            const auto text = "#" + std::to_string(object.id) + " " + object.state;
+            const auto size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, NULL);
+            const auto screenPos = object.position + cv::Point(-size.width / 2, size.height + 5);
+
+            cv::putText(view, text, screenPos, cv::FONT_HERSHEY_DUPLEX, 0.5, cv::Scalar(0, 0, 255), 1, cv::LINE_AA);
+        }
+    }
+
+    // Draw the counting lines and zones if required, with an arrow pointing the way people enter
+    if (drawFlags.testFlag(DrawFlag::DrawThresholds) && trackedFrame.countingLines) {
+        const auto& lines = *trackedFrame.countingLines;
+
+        for (int i = 0; i < lines.getLineCount(); i++) {
+            const auto& line = lines.getLine(i);
+            const auto& polyline = lines.getPolyline(i);
+
+            cv::polylines(view, polyline, line.zone, cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
+
+            // Entering crosses the first segment from its left to its right, unless the line is reversed.
+            // Entering a zone always means moving into it, zones need no arrow
+            if (!line.zone) {
+                const cv::Point2f start = polyline[0];
+                const cv::Point2f end = polyline[1];
+                const cv::Point2f middle = 0.5f * (start + end);
+                cv::Point2f normal(start.y - end.y, end.x - start.x);
+                normal *= ARROW_LENGTH / std::max(static_cast<float>(cv::norm(normal)), 1.0f);
+
+                if (line.reversed) {
+                    normal = -normal;
+                }
+
+                cv::arrowedLine(view, middle - normal, middle + normal, cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
+            }
+            cv::putText(view, line.name.toStdString(), polyline[0] + cv::Point(4, -4), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                        cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
+        }
+
+        // Outline the region of interest unless it covers the whole frame
+        if (region.size() != frame.size()) {
+            cv::rectangle(frame, region, cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
+        }
+    }
+
+    // Display frame number and status information if required
+    QString infoText = "";
+
+    if (drawFlags.testFlag(DrawFlag::ShowFrameNumber)) {
+        infoText = QString("Frame: %1").arg(trackedFrame.frameNumber);
+    }
+
+    if (drawFlags.testFlag(DrawFlag::ShowFrameStatus)) {
+        infoText = QString("%1 (%2, every %3 frames)").arg(infoText).arg(trackedFrame.status).arg(trackedFrame.detectionInterval);
+
+        // Show how far processing was degraded to stay within its CPU budget
+        if (trackedFrame.degradation != BudgetGovernor::FullQuality) {
+            infoText = QString("%1 [%2]").arg(infoText).arg(QString::fromStdString(BudgetGovernor::getLevelName(trackedFrame.degradation)));
+        }
+    }
+
+    if (infoText != "") {
+        const auto size = cv::getTextSize(infoText.toStdString(), cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, NULL);
+        const auto screenPos = cv::Point(0, size.height);
+        cv::putText(frame, infoText.toStdString(), screenPos, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 0), 1, cv::LINE_AA);
+    }
+
+    // Convert the processed frame into a QImage, grayscale frames are copied as they are
+    if (frame.channels() == 1) {
+        QImage image(frame.cols, frame.rows, QImage::Format_Grayscale8);
+
+        cv::Mat mat(frame.rows, frame.cols, CV_8UC1, image.bits(), image.bytesPerLine());
+        frame.copyTo(mat);
+
+        return image;
+    }
+
+    QImage image(frame.cols, frame.rows, QImage::Format_RGB888);
+
+    cv::Mat mat(frame.rows, frame.cols, CV_8UC3, image.bits(), image.bytesPerLine());
+    cv::resize(frame, mat, mat.size(), 0, 0, cv::INTER_AREA);
+    cv::cvtColor(mat, mat, cv::COLOR_BGR2RGB);
+
+    return image;
+}
+
+/**
+ * @brief Renders the given tracked frame and emits a signal containing the resulting image.
+ * @param trackedFrame the processed frame to render.
+ */
+void FrameRenderer::renderFrame(ObjectTracker::TrackedFrame trackedFrame) {
+    emit frameRendered(render(trackedFrame));
+}
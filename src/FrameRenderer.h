@@ -0,0 +1,43 @@
+/**
+ * @file FrameRenderer.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Draws tracking overlays on processed frames and converts them for display
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <QImage>
+#include <QObject>
+
+#include "ObjectTracker.h"
+
+/**
+ * The length, in pixels, of the arrows showing the way people enter across counting lines.
+ */
+#define ARROW_LENGTH 12.0f
+
+/**
+ * @brief Class that draws tracking overlays on processed frames and converts them into QImages.
+ * Can be used directly through render() or as a stage of its own, possibly on a separate thread.
+ */
+class FrameRenderer : public QObject {
+    Q_OBJECT
+
+    public:
+        FrameRenderer(QObject *parent = 0);
+
+        ~FrameRenderer();
+
+        static QImage render(ObjectTracker::TrackedFrame& trackedFrame);
+
+    public slots:
+        void renderFrame(ObjectTracker::TrackedFrame trackedFrame);
+
+    signals:
+        void frameRendered(QImage image);
+};
+
+#endif // FRAMERENDERER_H
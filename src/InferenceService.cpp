@@ -0,0 +1,272 @@
+/**
+ * @file InferenceService.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Thread which runs the detection requests of many trackers as batches on one shared network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "InferenceService.h"
+#include "ModelRegistry.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Constructs a new InferenceService object. The service starts serving requests once started.
+ * @param maxBatchSize the maximum number of frames detected in a single forward pass.
+ * @param maxWait the maximum time in milliseconds a request waits for its batch to fill up.
+ * @param parent the parent Qt object of this object.
+ */
+InferenceService::InferenceService(const int maxBatchSize, const int maxWait, QObject *parent) : QThread(parent) {
+    stopping = false;
+    this->maxBatchSize = std::max(maxBatchSize, 1);
+    this->maxWait = std::max(maxWait, 0);
+    batches = 0;
+    served = 0;
+}
+
+/**
+ * @brief Destructs an InferenceService object, stopping the thread. Pending requests are answered with no
+ * detections, so their trackers give back their slots whether they are destroyed before or after the service.
+ */
+InferenceService::~InferenceService() {
+    mutex.lock();
+    stopping = true;
+    submitted.wakeAll();
+    mutex.unlock();
+
+    wait();
+
+    // Taken like a batch, so cancel() waits until the dropped requests are answered
+    QMutexLocker dispatchLocker(&dispatchMutex);
+    mutex.lock();
+    const std::deque<Request> dropped = std::move(requests);
+    requests.clear();
+    mutex.unlock();
+
+    for (const auto& request : dropped) {
+        answer(request, std::vector<cv::Rect>());
+    }
+
+    dispatchLocker.unlock();
+
+    ModelRegistry::instance().release(detector);
+}
+
+/**
+ * @brief Returns the maximum number of frames detected in a single forward pass.
+ * @return the maximum batch size.
+ */
+int InferenceService::getMaxBatchSize() const {
+    QMutexLocker locker(&mutex);
+    return maxBatchSize;
+}
+
+/**
+ * @brief Sets the maximum number of frames detected in a single forward pass.
+ * @param size the maximum batch size (at least one).
+ */
+void InferenceService::setMaxBatchSize(const int size) {
+    QMutexLocker locker(&mutex);
+    maxBatchSize = std::max(size, 1);
+    submitted.wakeAll();
+}
+
+/**
+ * @brief Returns the maximum time a request waits for its batch to fill up.
+ * @return the maximum wait time in milliseconds.
+ */
+int InferenceService::getMaxWait() const {
+    QMutexLocker locker(&mutex);
+    return maxWait;
+}
+
+/**
+ * @brief Sets the maximum time a request waits for its batch to fill up. Bounds the latency added by batching.
+ * @param wait the maximum wait time in milliseconds, zero to run whatever is pending right away.
+ */
+void InferenceService::setMaxWait(const int wait) {
+    QMutexLocker locker(&mutex);
+    maxWait = std::max(wait, 0);
+    submitted.wakeAll();
+}
+
+/**
+ * @brief Submits a detection request. Can be called from any thread.
+ * The result is delivered to the client's applyDetections(std::vector<cv::Rect>, unsigned int) slot.
+ * @param client the object receiving the result. Must call cancel() before it is destroyed.
+ * @param frame the snapshot frame to detect people in. Must not be modified until the result is delivered.
+ * @param request an identifier for the request, passed back with the result.
+ * @param inputSize the input size of the network.
+ * @param options the options of the detector to detect with.
+ * @param tiling how the frame is split into tiles, each tile takes one place in a batch.
+ * Requests submitted while the service stops are answered with no detections right away.
+ */
+void InferenceService::submit(QObject *client, const cv::Mat& frame, const unsigned int request, const cv::Size inputSize, const PersonDetector::Options& options,
+                              const PersonDetector::Tiling& tiling) {
+    Request pending = { client, frame, request, inputSize, options, tiling, QElapsedTimer() };
+    pending.age.start();
+
+    QMutexLocker locker(&mutex);
+
+    if (stopping) {
+        locker.unlock();
+        answer(pending, std::vector<cv::Rect>());
+        return;
+    }
+
+    requests.push_back(std::move(pending));
+    submitted.wakeAll();
+}
+
+/**
+ * @brief Drops the pending requests of a client and waits for a batch in progress to be delivered.
+ * No result is delivered to the client once this returns.
+ * @param client the client to cancel the requests of.
+ */
+void InferenceService::cancel(QObject *client) {
+    mutex.lock();
+
+    requests.erase(std::remove_if(requests.begin(), requests.end(), [client](const Request& request) {
+        return request.client == client;
+    }), requests.end());
+
+    mutex.unlock();
+
+    // A batch taken before the requests were dropped may still contain one of them
+    QMutexLocker locker(&dispatchMutex);
+}
+
+/**
+ * @brief Returns the number of batches detected so far.
+ * @return the number of forward passes run.
+ */
+unsigned long long InferenceService::getBatchCount() const {
+    QMutexLocker locker(&mutex);
+    return batches;
+}
+
+/**
+ * @brief Returns the number of requests detected so far. Divided by the batch count, gives the mean batch size.
+ * @return the number of requests served.
+ */
+unsigned long long InferenceService::getRequestCount() const {
+    QMutexLocker locker(&mutex);
+    return served;
+}
+
+/**
+ * @brief Collects pending requests into batches and detects them until the service is stopped.
+ */
+void InferenceService::run() {
+    while (true) {
+        std::vector<Request> batch;
+
+        mutex.lock();
+
+        while (!stopping && requests.empty()) {
+            submitted.wait(&mutex);
+        }
+
+        // Let the batch fill up until it is full or its oldest request has waited long enough
+        while (!stopping && !requests.empty() && static_cast<int>(requests.size()) < maxBatchSize) {
+            const qint64 remaining = maxWait - requests.front().age.elapsed();
+
+            if (remaining <= 0 || !submitted.wait(&mutex, static_cast<unsigned long>(remaining))) {
+                break;
+            }
+        }
+
+        if (stopping) {
+            mutex.unlock();
+            return;
+        }
+
+        // Every request may have been cancelled while waiting
+        if (requests.empty()) {
+            mutex.unlock();
+            continue;
+        }
+
+        // A batch shares one network and input size, other requests wait for the next batch
+        const auto options = requests.front().options;
+        const auto inputSize = requests.front().inputSize;
+
+        // Tiles take a place each, a request is never split across batches
+        int size = 0;
+
+        for (auto it = requests.begin(); it != requests.end() && size < maxBatchSize;) {
+            const int tiles = std::max(1, it->tiling.getCount());
+
+            if (it->options == options && it->inputSize == inputSize && (batch.empty() || size + tiles <= maxBatchSize)) {
+                size += tiles;
+                batch.push_back(std::move(*it));
+                it = requests.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        batches++;
+        served += batch.size();
+
+        // Taken before the requests are released, so cancel() waits for this batch
+        dispatchMutex.lock();
+        mutex.unlock();
+
+        // Without a model every request is answered with no detections, so its tracker gives back its slot
+        const bool acquired = ModelRegistry::instance().acquire(detector, options, inputSize);
+
+        std::vector<std::vector<cv::Rect>> tiles;
+        std::vector<cv::Mat> frames;
+        tiles.reserve(batch.size());
+        frames.reserve(size);
+
+        for (const auto& request : batch) {
+            tiles.push_back(PersonDetector::getTiles(request.frame.size(), request.tiling));
+
+            for (const auto& tile : tiles.back()) {
+                frames.push_back(request.frame(tile));
+            }
+        }
+
+        std::vector<std::vector<cv::Rect>> results(frames.size());
+        std::vector<std::vector<float>> confidences(frames.size());
+
+        // A failed forward pass answers the whole batch with no detections, dispatchMutex must still be released below
+        if (acquired) {
+            try {
+                results = detector->detectBatch(frames, &confidences);
+            } catch (const std::exception& e) {
+                detector->reportFailure(e);
+                results.assign(frames.size(), std::vector<cv::Rect>());
+                confidences.assign(frames.size(), std::vector<float>());
+            }
+        }
+
+        // Merge each request's tiles and scatter the results back to the clients, on their own threads
+        std::size_t first = 0;
+
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            const std::size_t last = first + tiles[i].size();
+            const auto boxes = PersonDetector::mergeTiles(tiles[i], std::vector<std::vector<cv::Rect>>(results.begin() + first, results.begin() + last),
+                                                          std::vector<std::vector<float>>(confidences.begin() + first, confidences.begin() + last));
+            first = last;
+
+            answer(batch[i], boxes);
+        }
+
+        dispatchMutex.unlock();
+    }
+}
+
+/**
+ * @brief Delivers the result of a request to its client's applyDetections() slot, on the client's own thread.
+ * @param request the request to answer.
+ * @param boxes the detected people, empty if the request could not be detected.
+ */
+void InferenceService::answer(const Request& request, const std::vector<cv::Rect>& boxes) {
+    QMetaObject::invokeMethod(request.client, "applyDetections", Qt::QueuedConnection,
+                              Q_ARG(std::vector<cv::Rect>, boxes), Q_ARG(unsigned int, request.request));
+}
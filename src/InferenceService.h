@@ -0,0 +1,129 @@
+/**
+ * @file InferenceService.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Thread which runs the detection requests of many trackers as batches on one shared network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef INFERENCESERVICE_H
+#define INFERENCESERVICE_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <opencv2/opencv.hpp>
+
+#include "PersonDetector.h"
+
+/**
+ * The default maximum number of frames, or tiles of frames, detected in a single forward pass.
+ */
+#define DEFAULT_MAX_BATCH_SIZE 8
+
+/**
+ * The default maximum time in milliseconds a request waits for a batch to fill up before the batch is run anyway.
+ */
+#define DEFAULT_MAX_BATCH_WAIT 10
+
+/**
+ * @brief Thread which runs the detection requests of many trackers as batches on one shared network.
+ * Trackers submit snapshot frames from any thread. Pending requests, or their tiles, are collected into a single NCHW blob and
+ * detected in one forward pass, which amortizes the per-call overhead and reuses the network's weights while
+ * they are in the cache. A batch runs as soon as it is full or its oldest request has waited the maximum wait
+ * time. Each client's results are delivered to its applyDetections(std::vector<cv::Rect>, unsigned int) slot
+ * through a queued call, so they arrive on the client's own thread. Every request is answered exactly once, those
+ * still pending when the service is destroyed with no detections.
+ */
+class InferenceService : public QThread {
+    Q_OBJECT
+
+    public:
+        InferenceService(const int maxBatchSize = DEFAULT_MAX_BATCH_SIZE, const int maxWait = DEFAULT_MAX_BATCH_WAIT, QObject *parent = 0);
+
+        ~InferenceService();
+
+        int getMaxBatchSize() const;
+
+        void setMaxBatchSize(const int size);
+
+        int getMaxWait() const;
+
+        void setMaxWait(const int wait);
+
+        void submit(QObject *client, const cv::Mat& frame, const unsigned int request, const cv::Size inputSize, const PersonDetector::Options& options,
+                    const PersonDetector::Tiling& tiling = PersonDetector::Tiling());
+
+        void cancel(QObject *client);
+
+        unsigned long long getBatchCount() const;
+
+        unsigned long long getRequestCount() const;
+
+    protected:
+        void run() override;
+
+    private:
+        /**
+         * A pending detection request.
+         */
+        struct Request {
+            QObject *client;
+            cv::Mat frame;
+            unsigned int request;
+            cv::Size inputSize;
+            PersonDetector::Options options;
+            PersonDetector::Tiling tiling;
+            QElapsedTimer age;
+        };
+
+        static void answer(const Request& request, const std::vector<cv::Rect>& boxes);
+
+        /**
+         * Guards the members below, requests are submitted from the clients' threads.
+         */
+        mutable QMutex mutex;
+
+        /**
+         * Signalled whenever a request is submitted or the service is stopped.
+         */
+        QWaitCondition submitted;
+
+        /**
+         * The pending requests, oldest first.
+         */
+        std::deque<Request> requests;
+
+        /**
+         * Whether the service is stopping.
+         */
+        bool stopping;
+
+        int maxBatchSize;
+
+        /**
+         * The maximum wait time in milliseconds.
+         */
+        int maxWait;
+
+        unsigned long long batches;
+        unsigned long long served;
+
+        /**
+         * Held while a batch is detected and its results are delivered, so a cancelled client is never called afterwards.
+         */
+        QMutex dispatchMutex;
+
+        /**
+         * The shared detector, only used by the service's thread and exchanged through the ModelRegistry when the options of a batch change.
+         */
+        std::unique_ptr<PersonDetector> detector;
+};
+
+#endif // INFERENCESERVICE_H
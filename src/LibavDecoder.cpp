@@ -0,0 +1,309 @@
+/**
+ * @file LibavDecoder.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Multi-threaded decoder for video files built directly on FFmpeg's libraries
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "LibavDecoder.h"
+
+#ifdef HAVE_LIBAV
+
+#include <cmath>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+/**
+ * @brief Constructs a new LibavDecoder object with nothing opened.
+ */
+LibavDecoder::LibavDecoder() {
+    format = nullptr;
+    context = nullptr;
+    decoded = nullptr;
+    packet = nullptr;
+    scaler = nullptr;
+    stream = -1;
+    draining = false;
+    outputType = CV_8UC3;
+}
+
+/**
+ * @brief Destructs a LibavDecoder object, closing the opened file.
+ */
+LibavDecoder::~LibavDecoder() {
+    close();
+}
+
+/**
+ * @brief Opens a video file and its best video stream's decoder on the requested threads.
+ * Frames are delivered in BGR at the decoded size until the output size or type is changed.
+ * @param filename the path of the video file.
+ * @param options the number of threads and how decoding is split between them.
+ * @return true if the file and its decoder were opened.
+ */
+bool LibavDecoder::open(const std::string& filename, const VideoDecoder::Options& options) {
+    close();
+
+    if (avformat_open_input(&format, filename.c_str(), nullptr, nullptr) < 0) {
+        return false;
+    }
+
+    if (avformat_find_stream_info(format, nullptr) < 0) {
+        close();
+        return false;
+    }
+
+    stream = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+
+    if (stream < 0) {
+        close();
+        return false;
+    }
+
+    const AVCodec *codec = avcodec_find_decoder(format->streams[stream]->codecpar->codec_id);
+    context = codec ? avcodec_alloc_context3(codec) : nullptr;
+
+    if (!context || avcodec_parameters_to_context(context, format->streams[stream]->codecpar) < 0) {
+        close();
+        return false;
+    }
+
+    // Zero lets the decoder start one thread per core
+    context->thread_count = options.threads > 0 ? options.threads : 0;
+
+    switch (options.mode) {
+        case VideoDecoder::FrameThreads:
+            context->thread_type = FF_THREAD_FRAME;
+            break;
+        case VideoDecoder::SliceThreads:
+            context->thread_type = FF_THREAD_SLICE;
+            break;
+        default:
+            context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+            break;
+    }
+
+    if (avcodec_open2(context, codec, nullptr) < 0) {
+        close();
+        return false;
+    }
+
+    decoded = av_frame_alloc();
+    packet = av_packet_alloc();
+
+    if (!decoded || !packet) {
+        close();
+        return false;
+    }
+
+    outputSize = getFrameSize();
+    outputType = CV_8UC3;
+
+    return true;
+}
+
+/**
+ * @brief Closes the opened file and frees the decoder and its threads.
+ */
+void LibavDecoder::close() {
+    sws_freeContext(scaler);
+    scaler = nullptr;
+
+    av_packet_free(&packet);
+    av_frame_free(&decoded);
+    avcodec_free_context(&context);
+    avformat_close_input(&format);
+
+    stream = -1;
+    draining = false;
+    outputSize = cv::Size();
+}
+
+/**
+ * @brief Returns whether a file is opened.
+ * @return true if opened.
+ */
+bool LibavDecoder::isOpened() const {
+    return context != nullptr;
+}
+
+/**
+ * @brief Decodes the next frame in the output size and type.
+ * Packets are fed to the decoder until it returns a frame. At the end of the file, the frames still being decoded
+ * by the decoder's threads are drained before reporting the end.
+ * @param frame receives the frame. A buffer of the right size and type is written in place.
+ * @return false if there are no more frames.
+ */
+bool LibavDecoder::read(cv::Mat& frame) {
+    if (!context) {
+        return false;
+    }
+
+    while (true) {
+        const int received = avcodec_receive_frame(context, decoded);
+
+        if (received == 0) {
+            const bool converted = convert(frame);
+            av_frame_unref(decoded);
+            return converted;
+        }
+
+        if (received != AVERROR(EAGAIN) || draining) {
+            return false;
+        }
+
+        if (av_read_frame(format, packet) < 0) {
+            draining = true;
+            avcodec_send_packet(context, nullptr);
+            continue;
+        }
+
+        // Other streams are dropped, a corrupt packet only costs its own frame as with OpenCV's capture
+        if (packet->stream_index == stream) {
+            avcodec_send_packet(context, packet);
+        }
+
+        av_packet_unref(packet);
+    }
+}
+
+/**
+ * @brief Returns the size of the opened video stream.
+ * @return the decoded size, empty if nothing is opened.
+ */
+cv::Size LibavDecoder::getFrameSize() const {
+    return context ? cv::Size(context->width, context->height) : cv::Size();
+}
+
+/**
+ * @brief Returns the frame rate of the opened video stream.
+ * @return the frame rate, zero if unknown.
+ */
+double LibavDecoder::getFps() const {
+    if (stream < 0) {
+        return 0;
+    }
+
+    // Streams without a rate store 0/0, which av_q2d turns into NaN
+    const AVStream *video = format->streams[stream];
+    const double average = av_q2d(video->avg_frame_rate);
+    const double fps = std::isfinite(average) && average > 0 ? average : av_q2d(video->r_frame_rate);
+
+    return std::isfinite(fps) && fps > 0 ? fps : 0.0;
+}
+
+/**
+ * @brief Returns the number of frames of the opened video stream, estimated from its duration if not stored.
+ * @return the number of frames, zero if unknown.
+ */
+double LibavDecoder::getFrameCount() const {
+    if (stream < 0) {
+        return 0;
+    }
+
+    const AVStream *video = format->streams[stream];
+
+    if (video->nb_frames > 0) {
+        return static_cast<double>(video->nb_frames);
+    }
+
+    const double seconds = format->duration > 0 ? format->duration / static_cast<double>(AV_TIME_BASE) : 0.0;
+    return std::floor(seconds * getFps() + 0.5);
+}
+
+/**
+ * @brief Returns the size frames are delivered in.
+ * @return the output size.
+ */
+cv::Size LibavDecoder::getOutputSize() const {
+    return outputSize;
+}
+
+/**
+ * @brief Sets the size frames are scaled to while decoding. A non-positive dimension keeps the decoded one.
+ * @param size the output size.
+ */
+void LibavDecoder::setOutputSize(const cv::Size size) {
+    const cv::Size frameSize = getFrameSize();
+    outputSize = cv::Size(size.width > 0 ? size.width : frameSize.width, size.height > 0 ? size.height : frameSize.height);
+}
+
+/**
+ * @brief Returns the OpenCV type frames are delivered in.
+ * @return CV_8UC1 for grayscale, CV_8UC3 for BGR.
+ */
+int LibavDecoder::getOutputType() const {
+    return outputType;
+}
+
+/**
+ * @brief Sets the OpenCV type frames are converted to while decoding.
+ * @param type CV_8UC1 for grayscale, CV_8UC3 for BGR.
+ * @return false if the type is not supported.
+ */
+bool LibavDecoder::setOutputType(const int type) {
+    if (type != CV_8UC1 && type != CV_8UC3) {
+        return false;
+    }
+
+    outputType = type;
+    return true;
+}
+
+/**
+ * @brief Returns the number of threads decoding the opened file.
+ * @return the number of threads, zero if nothing is opened.
+ */
+int LibavDecoder::getThreadCount() const {
+    return context ? context->thread_count : 0;
+}
+
+/**
+ * @brief Returns how decoding of the opened file is split between threads, which depends on what the codec supports.
+ * @return FrameThreads or SliceThreads, AutoThreads if decoding is not threaded.
+ */
+VideoDecoder::ThreadMode LibavDecoder::getThreadMode() const {
+    if (context && (context->active_thread_type & FF_THREAD_FRAME)) {
+        return VideoDecoder::FrameThreads;
+    }
+
+    if (context && (context->active_thread_type & FF_THREAD_SLICE)) {
+        return VideoDecoder::SliceThreads;
+    }
+
+    return VideoDecoder::AutoThreads;
+}
+
+/**
+ * @brief Scales and converts the decoded frame to the output size and type in a single pass.
+ * @param frame receives the frame. A buffer of the right size and type is written in place.
+ * @return false if the decoded frame cannot be converted.
+ */
+bool LibavDecoder::convert(cv::Mat& frame) {
+    const cv::Size size = outputSize.area() > 0 ? outputSize : cv::Size(decoded->width, decoded->height);
+    const AVPixelFormat target = outputType == CV_8UC1 ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_BGR24;
+
+    // Area averaging matches the resize OpenCV's frames get, the context is kept while nothing changes
+    scaler = sws_getCachedContext(scaler, decoded->width, decoded->height, static_cast<AVPixelFormat>(decoded->format),
+                                  size.width, size.height, target, SWS_AREA, nullptr, nullptr, nullptr);
+
+    if (!scaler) {
+        return false;
+    }
+
+    frame.create(size, outputType);
+
+    uint8_t *planes[4] = { frame.data, nullptr, nullptr, nullptr };
+    int strides[4] = { static_cast<int>(frame.step[0]), 0, 0, 0 };
+
+    sws_scale(scaler, decoded->data, decoded->linesize, 0, decoded->height, planes, strides);
+
+    return true;
+}
+
+#endif // HAVE_LIBAV
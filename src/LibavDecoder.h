@@ -0,0 +1,99 @@
+/**
+ * @file LibavDecoder.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Multi-threaded decoder for video files built directly on FFmpeg's libraries
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef LIBAVDECODER_H
+#define LIBAVDECODER_H
+
+#ifdef HAVE_LIBAV
+
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "VideoDecoder.h"
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/**
+ * @brief Class that decodes a video file with FFmpeg's libraries, splitting decoding between threads.
+ * The decoder is opened with a chosen number of frame- or slice-level threads, which OpenCV's capture does not
+ * expose. Decoded frames are scaled and converted to BGR or grayscale by a single pass of FFmpeg's scaler, at the
+ * size they are processed in, straight into the caller's buffer.
+ */
+class LibavDecoder {
+    public:
+        LibavDecoder();
+
+        ~LibavDecoder();
+
+        bool open(const std::string& filename, const VideoDecoder::Options& options);
+
+        void close();
+
+        bool isOpened() const;
+
+        bool read(cv::Mat& frame);
+
+        cv::Size getFrameSize() const;
+
+        double getFps() const;
+
+        double getFrameCount() const;
+
+        cv::Size getOutputSize() const;
+
+        void setOutputSize(const cv::Size size);
+
+        int getOutputType() const;
+
+        bool setOutputType(const int type);
+
+        int getThreadCount() const;
+
+        VideoDecoder::ThreadMode getThreadMode() const;
+
+    private:
+        bool convert(cv::Mat& frame);
+
+        AVFormatContext *format;
+
+        AVCodecContext *context;
+
+        AVFrame *decoded;
+
+        AVPacket *packet;
+
+        /**
+         * The scaler converting decoded frames, recreated only when the decoded or output size or format changes.
+         */
+        SwsContext *scaler;
+
+        /**
+         * The index of the decoded video stream in the file.
+         */
+        int stream;
+
+        /**
+         * Whether the end of the file was reached and the frames still held by the decoder's threads are being drained.
+         */
+        bool draining;
+
+        /**
+         * The size and OpenCV type frames are delivered in.
+         */
+        cv::Size outputSize;
+        int outputType;
+};
+
+#endif // HAVE_LIBAV
+
+#endif // LIBAVDECODER_H
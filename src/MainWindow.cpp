@@ -16,6 +16,7 @@
 #include <Qt>
 #include <QPushButton>
 #include <QFileInfo>
+#include <QInputDialog>
 #include <QDebug>
 #include <QSettings>
 
@@ -25,6 +26,12 @@
 #include "DBConnection.h"
 #include "AnalyticWindow.h"
 #include "SettingsWindow.h"
+#include "FrameRenderer.h"
+#include "Pipeline.h"
+#include "InferenceService.h"
+#include "ModelRegistry.h"
+#include "StreamManager.h"
+#include "DetectionSlots.h"
 
 #include <QSqlTableModel>
 /**
@@ -35,29 +42,92 @@
  */
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 {
+    QSettings settings;
+    const auto pipelined = settings.value("pipeline/enabled", false).toBool();
+
     videoSource = new VideoSource(this);
-    objectTracker = new ObjectTracker(this);
 
+    // In pipelined mode the tracker and renderer run on worker threads, so they cannot have a parent
+    objectTracker = new ObjectTracker(pipelined ? nullptr : this);
 
-    /*Buttons to draw flags and create the object tracker so we can track the people in the video frame*/
-    QSettings settings;
-    const auto drawFlags = settings.value("tracker/drawFlags").value<ObjectTracker::DrawFlags>();
-    const auto enterDirection = settings.value("tracker/enterDirection").toUInt();
-    objectTracker->setDrawFlags(drawFlags);
-    objectTracker->setEnterDirection(static_cast<ObjectTracker::EnterDirection>(enterDirection));
+    // Settings saved by a build with other DNN backends may not be available here, fall back and remember the fallback
+    if (!objectTracker->loadSettings()) {
+        settings.setValue("tracker/dnnBackend", objectTracker->getDnnBackend());
+        settings.setValue("tracker/dnnTarget", objectTracker->getDnnTarget());
+    }
+
+    // A saved INT8 or ONNX model may be missing, fall back to the full precision model and remember the fallback
+    if (!objectTracker->resolveDetector()) {
+        settings.setValue("tracker/detectorBackend", objectTracker->getDetectorBackend());
+        settings.setValue("tracker/quantizedDetector", objectTracker->isQuantizedDetector());
+    }
+
+    // Load and warm up the network now, so the first detection frame does not stall the video
+    ModelRegistry::instance().warmUp(objectTracker->getDetectorOptions(), objectTracker->getInputSize());
+
+    // Decode on a dedicated thread if requested, the frame queue decouples capture from processing
+    // A pipeline always decodes on its own thread
+    const auto threadedCapture = pipelined || settings.value("capture/threaded", false).toBool();
+    const auto queueCapacity = settings.value("capture/queueCapacity", DEFAULT_FRAME_QUEUE_CAPACITY).toInt();
+    const auto overflowPolicy = settings.value("capture/overflowPolicy", FrameQueue::DropOldest).toUInt();
+    const auto framePoolCapacity = settings.value("capture/framePoolCapacity", DEFAULT_FRAME_POOL_CAPACITY).toInt();
+    videoSource->setFramePoolCapacity(framePoolCapacity);
+    videoSource->setQueueCapacity(queueCapacity);
+    videoSource->setOverflowPolicy(static_cast<FrameQueue::OverflowPolicy>(overflowPolicy));
+    videoSource->setCaptureMode(threadedCapture ? VideoSource::ThreadedCapture : VideoSource::TimerCapture);
 
     // connects us to the video source being capatured
-    connect(videoSource, &VideoSource::frameCaptured, objectTracker, &ObjectTracker::processFrame);
+    // in pipelined mode, tracking and rendering are connected by the pipeline on their own threads
+    FrameRenderer *frameRenderer = nullptr;
+
+    if (pipelined) {
+        frameRenderer = new FrameRenderer;
+        new Pipeline(videoSource, objectTracker, frameRenderer, this);
+    } else {
+        connect(videoSource, &VideoSource::frameCaptured, objectTracker, &ObjectTracker::processFrame);
+    }
 
     // Connects to a store object so we can store the data
     store = new Store(this);
     connect(objectTracker, &ObjectTracker::personEntered, store, &Store::personEntered);
     connect(objectTracker, &ObjectTracker::personExited, store, &Store::personExited);
 
+    // Detections of every stream take turns, at most this many run at once
+    DetectionSlots::instance().setCapacity(settings.value("inference/detectionSlots", DEFAULT_DETECTION_SLOTS).toInt());
+
+    // Further entrances saved in the settings run headless next to the displayed one and count into the same store
+    streamManager = new StreamManager(store, settings.value("pipeline/streamWorkers", 0).toInt(), this);
+
+    if (streamManager->loadStreams() > 0) {
+        ModelRegistry::instance().warmUp(objectTracker->getDetectorOptions(), objectTracker->getInputSize(), 1 + streamManager->getStreamCount());
+    }
+
+    // Background detections can be batched with those of other streams on a shared network
+    // Created after the trackers and pipeline, so it is destroyed after them
+    if (settings.value("inference/shared", false).toBool()) {
+        auto inferenceService = new InferenceService(settings.value("inference/maxBatchSize", DEFAULT_MAX_BATCH_SIZE).toInt(),
+                                                     settings.value("inference/maxWait", DEFAULT_MAX_BATCH_WAIT).toInt(), this);
+        inferenceService->start();
+        objectTracker->setInferenceService(inferenceService);
+        streamManager->setInferenceService(inferenceService);
+    }
+
+    for (int i = 0; i < streamManager->getStreamCount(); i++) {
+        const auto& stream = streamManager->getStream(i);
+
+        if (!streamManager->open(i)) {
+            qDebug() << "Could not open stream" << stream.name << "from" << stream.source;
+        }
+    }
+
 
     // connects the video display to display the video
     auto video = new VideoDisplay(this);
-    connect(objectTracker, &ObjectTracker::frameProcessed, video, &VideoDisplay::updateImage);
+    if (pipelined) {
+        connect(frameRenderer, &FrameRenderer::frameRendered, video, &VideoDisplay::updateImage);
+    } else {
+        connect(objectTracker, &ObjectTracker::frameProcessed, video, &VideoDisplay::updateImage);
+    }
 
 
     video->setMinimumSize(320, 200); // sets the minmum size of the GUI
@@ -204,7 +274,16 @@ void MainWindow::openFile()
     /*Checks if the file path has been selected and notifies the user*/
     if (!filepath.isNull())
     {
-        if (videoSource->openFile(filepath)) {
+        // Frames are downscaled and converted once while decoding, at the resolution and format they are processed in
+        QSettings settings;
+        const cv::Size frameSize(settings.value("capture/frameWidth", 0).toInt(), settings.value("capture/frameHeight", 0).toInt());
+        const auto format = settings.value("capture/grayFrames", false).toBool() ? FrameConverter::GrayFormat : FrameConverter::BgrFormat;
+
+        // Files are decoded on several threads, zero starts one per core
+        videoSource->setDecoderOptions({ settings.value("capture/decoderThreads", 0).toInt(),
+                                         static_cast<VideoDecoder::ThreadMode>(settings.value("capture/decoderThreadMode", VideoDecoder::AutoThreads).toUInt()) });
+
+        if (videoSource->openFile(filepath, frameSize, format)) {
             fileNameLabel->setText(QString("File Path: %1").arg(filepath));
         } else {
             fileNameLabel->setText("No video active.");
@@ -218,9 +297,23 @@ void MainWindow::openFile()
  *
  */
 void MainWindow::openCamera() {
-    // Use default system default camera
-    if (videoSource->openCamera(0)) {
-        fileNameLabel->setText("Capturing from default system camera.");
+    QSettings settings;
+    bool accepted = false;
+
+    // Offer the camera used last time, the system default camera at first
+    const int camera = QInputDialog::getInt(this, "Open Camera", "Camera index:", settings.value("capture/camera", 0).toInt(), 0, 99, 1, &accepted);
+
+    if (!accepted) {
+        return;
+    }
+
+    settings.setValue("capture/camera", camera);
+
+    const cv::Size frameSize(settings.value("capture/frameWidth", 0).toInt(), settings.value("capture/frameHeight", 0).toInt());
+    const auto format = settings.value("capture/grayFrames", false).toBool() ? FrameConverter::GrayFormat : FrameConverter::BgrFormat;
+
+    if (videoSource->openCamera(camera, DEFAULT_CAPTURE_FPS, frameSize, format)) {
+        fileNameLabel->setText(QString("Capturing from camera %1.").arg(camera));
     } else {
         fileNameLabel->setText("No video active.");
     }
@@ -295,7 +388,7 @@ void MainWindow::openAnalyticWindow()
  *
  */
 void MainWindow::openSettingsWindow() {
-    SettingsWindow *settingsWindow = new SettingsWindow(objectTracker, this);
+    SettingsWindow *settingsWindow = new SettingsWindow(objectTracker, videoSource, this);
     settingsWindow->setWindowFlag(Qt::Window, true);
     settingsWindow->show();
 }
@@ -18,6 +18,7 @@
 #include "Store.h"
 #include "ObjectTracker.h"
 #include "VideoSource.h"
+#include "StreamManager.h"
 #include "ContactWindow.h"
 #include "ComposeWindow.h"
 #include "AnalyticWindow.h"
@@ -93,6 +94,8 @@ private:
 
     VideoSource *videoSource;
 
+    StreamManager *streamManager;
+
     QLabel *fileNameLabel;
     QLabel *currentCapacityLabel;
 
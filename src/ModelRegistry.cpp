@@ -0,0 +1,324 @@
+/**
+ * @file ModelRegistry.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Process-wide registry loading each detection model once and handing out warmed-up detectors
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "ModelRegistry.h"
+#include "DnnPersonDetector.h"
+#include "OnnxPersonDetector.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include <QElapsedTimer>
+
+/**
+ * @brief Constructs the ModelRegistry object.
+ */
+ModelRegistry::ModelRegistry() {
+    totalLoadTime = 0;
+    totalWarmUpTime = 0;
+
+#ifdef HAVE_ONNXRUNTIME
+    // Create the environment first so it outlives the idle sessions destroyed with the registry
+    OnnxPersonDetector::getEnvironment();
+#endif
+}
+
+/**
+ * @brief Destructs the ModelRegistry object.
+ */
+ModelRegistry::~ModelRegistry() {
+
+}
+
+/**
+ * @brief Returns the registry shared by the whole process.
+ * @return the registry.
+ */
+ModelRegistry& ModelRegistry::instance() {
+    static ModelRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Returns the files of the model loaded by detectors with the given options, reading them on first use.
+ * Throws a cv::Exception if a file cannot be read.
+ * @param options the options of the detector loading the model. Only the backend and precision matter.
+ * @return the model's files, valid for the lifetime of the process.
+ */
+const ModelRegistry::Model& ModelRegistry::getModel(const PersonDetector::Options& options) {
+    QMutexLocker locker(&mutex);
+
+    for (const auto& model : models) {
+        if (isSameModel(model.first, options)) {
+            return *model.second;
+        }
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+
+    std::unique_ptr<Model> model(new Model);
+
+    if (options.quantized) {
+        model->weights = readFile(MODEL_QUANTIZED_ONNX_FILE);
+#ifdef HAVE_ONNXRUNTIME
+    } else if (options.backend == PersonDetector::OnnxRuntimeBackend) {
+        model->weights = readFile(MODEL_ONNX_FILE);
+#endif
+    } else {
+        model->architecture = readFile(MODEL_PROTOTXT_FILE);
+        model->weights = readFile(MODEL_CAFFEMODEL_FILE);
+    }
+
+    model->loadTime = clock.nsecsElapsed() / 1e6;
+    totalLoadTime += model->loadTime;
+
+    std::cout << "Loaded " << PersonDetector::getBackendName(options.backend).toStdString()
+              << (options.quantized ? " INT8" : " FP32") << " model in " << model->loadTime << " ms" << std::endl;
+
+    models.push_back(std::make_pair(options, std::move(model)));
+
+    return *models.back().second;
+}
+
+/**
+ * @brief Returns the options a detector can actually be created with, loading the model on first use.
+ * A model that cannot be loaded is replaced by the full precision OpenCV model, with the same DNN preference and threads.
+ * Failures are logged once, the model is not read again afterwards.
+ * @param options the requested options.
+ * @param resolved receives the options to create detectors with.
+ * @return false if not even the full precision model can be loaded, detection is then disabled.
+ */
+bool ModelRegistry::resolve(const PersonDetector::Options& options, PersonDetector::Options& resolved) {
+    resolved = options;
+
+    if (load(resolved)) {
+        return true;
+    }
+
+    if (resolved.quantized || resolved.backend != PersonDetector::OpenCvBackend) {
+        resolved.quantized = false;
+        resolved.backend = PersonDetector::OpenCvBackend;
+
+        if (load(resolved)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Makes sure the given detector runs with the given options, exchanging it for a warmed-up one if not.
+ * A detector with other options is released to the registry first. Idle detectors with matching options
+ * are reused, otherwise a new one is created and warmed up. If the model cannot be loaded, the full precision
+ * OpenCV model is used instead, see resolve().
+ * @param detector the detector to check, may be empty.
+ * @param options the options the detector must have.
+ * @param inputSize the input size the detector is used with.
+ * @return false if no detector could be created, the detector is then left empty.
+ */
+bool ModelRegistry::acquire(std::unique_ptr<PersonDetector>& detector, const PersonDetector::Options& options, const cv::Size inputSize) {
+    PersonDetector::Options resolved;
+
+    if (!resolve(options, resolved)) {
+        release(detector);
+        return false;
+    }
+
+    if (detector && detector->getOptions() == resolved) {
+        detector->setInputSize(inputSize);
+        return true;
+    }
+
+    release(detector);
+
+    mutex.lock();
+
+    for (auto it = idle.begin(); it != idle.end(); it++) {
+        if ((*it)->getOptions() == resolved) {
+            detector = std::move(*it);
+            idle.erase(it);
+            break;
+        }
+    }
+
+    mutex.unlock();
+
+    // Creating and warming up takes a while, other threads keep acquiring meanwhile
+    if (!detector) {
+        try {
+            detector = create(resolved, inputSize);
+        } catch (const std::exception& e) {
+            std::cerr << "Could not create detector: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    detector->setInputSize(inputSize);
+
+    return true;
+}
+
+/**
+ * @brief Returns a detector to the registry so it can be handed out again.
+ * @param detector the detector to release, left empty. Nothing happens if it is already empty.
+ */
+void ModelRegistry::release(std::unique_ptr<PersonDetector>& detector) {
+    if (!detector) {
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    idle.push_back(std::move(detector));
+}
+
+/**
+ * @brief Loads a model and prepares warmed-up detectors for it, typically at startup.
+ * Every detector acquired afterwards with the same options starts without paying any initialization.
+ * If the model cannot be loaded, detectors are prepared for the model used instead, see resolve().
+ * @param options the options of the detectors to prepare.
+ * @param inputSize the input size the detectors will be used with.
+ * @param count the number of detectors to prepare, one for every thread that will detect at the same time.
+ * @return false if no detector could be created.
+ */
+bool ModelRegistry::warmUp(const PersonDetector::Options& options, const cv::Size inputSize, const int count) {
+    PersonDetector::Options resolved;
+
+    if (!resolve(options, resolved)) {
+        return false;
+    }
+
+    mutex.lock();
+
+    int available = 0;
+
+    for (const auto& detector : idle) {
+        available += detector->getOptions() == resolved ? 1 : 0;
+    }
+
+    mutex.unlock();
+
+    for (int i = available; i < count; i++) {
+        try {
+            std::unique_ptr<PersonDetector> detector = create(resolved, inputSize);
+            release(detector);
+        } catch (const std::exception& e) {
+            std::cerr << "Could not create detector: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the total time spent reading model files.
+ * @return the total load time in milliseconds.
+ */
+double ModelRegistry::getTotalLoadTime() const {
+    QMutexLocker locker(&mutex);
+    return totalLoadTime;
+}
+
+/**
+ * @brief Returns the total time spent creating and warming up detectors.
+ * @return the total warm-up time in milliseconds.
+ */
+double ModelRegistry::getTotalWarmUpTime() const {
+    QMutexLocker locker(&mutex);
+    return totalWarmUpTime;
+}
+
+/**
+ * @brief Creates a detector and warms it up with an inference on a blank frame.
+ * @param options the options of the detector to create.
+ * @param inputSize the input size the detector will be used with.
+ * @return the warmed-up detector.
+ */
+std::unique_ptr<PersonDetector> ModelRegistry::create(const PersonDetector::Options& options, const cv::Size inputSize) {
+    // Load the model before timing, so the warm-up time only covers network setup and the first inference
+    getModel(options);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    std::unique_ptr<PersonDetector> detector = PersonDetector::create(options);
+    detector->setInputSize(inputSize);
+    detector->detect(cv::Mat::zeros(inputSize, CV_8UC3));
+
+    const double warmUpTime = clock.nsecsElapsed() / 1e6;
+
+    mutex.lock();
+    totalWarmUpTime += warmUpTime;
+    mutex.unlock();
+
+    std::cout << "Warmed up " << PersonDetector::getBackendName(options.backend).toStdString()
+              << (options.quantized ? " INT8" : " FP32") << " detector in " << warmUpTime << " ms" << std::endl;
+
+    return detector;
+}
+
+/**
+ * @brief Loads the model of the given options unless it is known to be missing. Logs the first failure.
+ * @param options the options of the detector loading the model.
+ * @return true if the model is loaded.
+ */
+bool ModelRegistry::load(const PersonDetector::Options& options) {
+    mutex.lock();
+
+    const bool known = std::any_of(missing.begin(), missing.end(), [&options](const PersonDetector::Options& other) {
+        return isSameModel(options, other);
+    });
+
+    mutex.unlock();
+
+    if (known) {
+        return false;
+    }
+
+    try {
+        getModel(options);
+        return true;
+    } catch (const cv::Exception& e) {
+        std::cerr << "Could not load " << PersonDetector::getBackendName(options.backend).toStdString()
+                  << (options.quantized ? " INT8" : " FP32") << " model: " << e.err << std::endl;
+    }
+
+    QMutexLocker locker(&mutex);
+    missing.push_back(options);
+
+    return false;
+}
+
+/**
+ * @brief Returns whether two detectors load the same model files. Only the backend and precision matter.
+ * @param options the options of a detector.
+ * @param other the options of another detector.
+ * @return true if both load the same model.
+ */
+bool ModelRegistry::isSameModel(const PersonDetector::Options& options, const PersonDetector::Options& other) {
+    return options.backend == other.backend && options.quantized == other.quantized;
+}
+
+/**
+ * @brief Reads a whole file into memory. Throws a cv::Exception if the file cannot be read.
+ * @param filename the name of the file to read.
+ * @return the contents of the file.
+ */
+std::vector<uchar> ModelRegistry::readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        CV_Error(cv::Error::StsError, "Could not read model file: " + filename);
+    }
+
+    return std::vector<uchar>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
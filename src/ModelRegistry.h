@@ -0,0 +1,104 @@
+/**
+ * @file ModelRegistry.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Process-wide registry loading each detection model once and handing out warmed-up detectors
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef MODELREGISTRY_H
+#define MODELREGISTRY_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <QMutex>
+
+#include <opencv2/opencv.hpp>
+
+#include "PersonDetector.h"
+
+/**
+ * @brief Process-wide registry loading each detection model once and handing out warmed-up detectors.
+ * Model files are read from disk the first time a model is needed and kept in memory, so every further
+ * detector parses its network from memory. Each detector is warmed up with a dummy inference when it is
+ * created, so the one-time initialization of the network is never paid on a live frame. Detectors are
+ * inference contexts used by one thread at a time. Released detectors are kept and handed out again.
+ * Load and warm-up times are logged and can be queried. A model whose files cannot be loaded, such as a missing
+ * INT8 or ONNX export, is replaced by the full precision OpenCV model, or detection is disabled if that is missing too.
+ * Nothing is thrown to the callers, which run on the trackers' and workers' threads.
+ */
+class ModelRegistry {
+    public:
+        /**
+         * The files of a model, read into memory.
+         */
+        struct Model {
+            // The network architecture, empty for formats holding everything in a single file
+            std::vector<uchar> architecture;
+            // The learned network
+            std::vector<uchar> weights;
+            // The time it took to read the files, in milliseconds
+            double loadTime;
+        };
+
+        static ModelRegistry& instance();
+
+        const Model& getModel(const PersonDetector::Options& options);
+
+        bool resolve(const PersonDetector::Options& options, PersonDetector::Options& resolved);
+
+        bool acquire(std::unique_ptr<PersonDetector>& detector, const PersonDetector::Options& options, const cv::Size inputSize);
+
+        void release(std::unique_ptr<PersonDetector>& detector);
+
+        bool warmUp(const PersonDetector::Options& options, const cv::Size inputSize, const int count = 1);
+
+        double getTotalLoadTime() const;
+
+        double getTotalWarmUpTime() const;
+
+    private:
+        ModelRegistry();
+
+        ~ModelRegistry();
+
+        ModelRegistry(const ModelRegistry&) = delete;
+
+        ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+        std::unique_ptr<PersonDetector> create(const PersonDetector::Options& options, const cv::Size inputSize);
+
+        bool load(const PersonDetector::Options& options);
+
+        static bool isSameModel(const PersonDetector::Options& options, const PersonDetector::Options& other);
+
+        static std::vector<uchar> readFile(const std::string& filename);
+
+        /**
+         * Guards every member below, detectors are acquired from the trackers' and workers' threads.
+         */
+        mutable QMutex mutex;
+
+        /**
+         * The loaded models, keyed by the backend and precision they were loaded for. Never removed, so references stay valid.
+         */
+        std::vector<std::pair<PersonDetector::Options, std::unique_ptr<Model>>> models;
+
+        /**
+         * Warmed-up detectors not used by anyone, ready to be handed out again.
+         */
+        std::vector<std::unique_ptr<PersonDetector>> idle;
+
+        /**
+         * The options of models that could not be loaded, so they are not read again on every detection.
+         */
+        std::vector<PersonDetector::Options> missing;
+
+        double totalLoadTime;
+        double totalWarmUpTime;
+};
+
+#endif // MODELREGISTRY_H
@@ -0,0 +1,87 @@
+/**
+ * @file MotionGate.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Cheap background subtraction used to skip detection and tracking while nothing moves
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "MotionGate.h"
+
+/**
+ * @brief Constructs a new MotionGate object with an empty background model.
+ */
+MotionGate::MotionGate() {
+    runFrames = 0;
+    skippedFrames = 0;
+}
+
+/**
+ * @brief Destructs a MotionGate object.
+ */
+MotionGate::~MotionGate() {
+
+}
+
+/**
+ * @brief Compares a frame with the background model, then updates the model with it.
+ * The first frame after a reset always counts as having motion.
+ * @param frame the 8-bit BGR or grayscale frame to check.
+ * @return true if enough of the frame differs from the background.
+ */
+bool MotionGate::hasMotion(const cv::Mat& frame) {
+    // Downscale first so every following step works on a few thousand pixels
+    const int height = std::max(1, frame.rows * MOTION_FRAME_WIDTH / std::max(1, frame.cols));
+    cv::resize(frame, small, cv::Size(MOTION_FRAME_WIDTH, height), 0, 0, cv::INTER_AREA);
+
+    if (small.channels() == 3) {
+        cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        small.copyTo(gray);
+    }
+
+    bool motion = true;
+
+    if (background.size() == gray.size()) {
+        background.convertTo(backgroundGray, CV_8U);
+        cv::absdiff(gray, backgroundGray, difference);
+
+        const int foreground = cv::countNonZero(difference > MOTION_PIXEL_THRESHOLD);
+        motion = foreground >= MIN_MOTION_FRACTION * difference.total();
+
+        cv::accumulateWeighted(gray, background, MOTION_LEARNING_RATE);
+    } else {
+        gray.convertTo(background, CV_32F);
+    }
+
+    if (motion) {
+        runFrames.fetchAndAddRelaxed(1);
+    } else {
+        skippedFrames.fetchAndAddRelaxed(1);
+    }
+
+    return motion;
+}
+
+/**
+ * @brief Returns the number of frames in which motion was found, i.e. which were processed.
+ * @return the number of frames run through detection and tracking.
+ */
+unsigned long long MotionGate::getRunFrameCount() const {
+    return runFrames.loadAcquire();
+}
+
+/**
+ * @brief Returns the number of frames in which no motion was found, i.e. which were skipped.
+ * @return the number of frames skipped.
+ */
+unsigned long long MotionGate::getSkippedFrameCount() const {
+    return skippedFrames.loadAcquire();
+}
+
+/**
+ * @brief Discards the background model, so the next frame starts a new one. Counters are kept.
+ */
+void MotionGate::reset() {
+    background.release();
+}
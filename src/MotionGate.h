@@ -0,0 +1,76 @@
+/**
+ * @file MotionGate.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Cheap background subtraction used to skip detection and tracking while nothing moves
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef MOTIONGATE_H
+#define MOTIONGATE_H
+
+#include <QAtomicInteger>
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * The width frames are downscaled to before being compared with the background model.
+ */
+#define MOTION_FRAME_WIDTH 160
+
+/**
+ * The rate at which the background model adapts to the scene, between 0 and 1.
+ */
+#define MOTION_LEARNING_RATE 0.05
+
+/**
+ * The minimum difference in intensity from the background for a pixel to count as foreground.
+ */
+#define MOTION_PIXEL_THRESHOLD 25
+
+/**
+ * The minimum fraction of foreground pixels for a frame to count as having motion.
+ */
+#define MIN_MOTION_FRACTION 0.002
+
+/**
+ * @brief Class that detects foreground motion with a cheap, downscaled background model.
+ * Frames are downscaled to MOTION_FRAME_WIDTH, converted to grayscale and compared with a running average
+ * of previous frames. Used by the object tracker to skip detection and tracking while a scene is idle.
+ */
+class MotionGate {
+    public:
+        MotionGate();
+
+        ~MotionGate();
+
+        bool hasMotion(const cv::Mat& frame);
+
+        unsigned long long getRunFrameCount() const;
+
+        unsigned long long getSkippedFrameCount() const;
+
+        void reset();
+
+    private:
+        /**
+         * The running average of previous downscaled grayscale frames.
+         */
+        cv::Mat background;
+
+        /**
+         * Reused buffers for the downscaled frame, its grayscale version, the 8-bit background and their difference.
+         */
+        cv::Mat small;
+        cv::Mat gray;
+        cv::Mat backgroundGray;
+        cv::Mat difference;
+
+        /**
+         * The number of frames with motion and without, readable from any thread.
+         */
+        QAtomicInteger<quint64> runFrames;
+        QAtomicInteger<quint64> skippedFrames;
+};
+
+#endif // MOTIONGATE_H
@@ -1,24 +1,116 @@
 #include "ObjectTracker.h"
+#include "FrameRenderer.h"
+#include "ModelRegistry.h"
+#include "TrackingTask.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <string>
+#include <utility>
 #include <iostream>
 
+#include <QElapsedTimer>
+#include <QSettings>
+
 /**
  * @brief Constructs a new ObjectTracker object.
  * @param parent the parent Qt object of this object.
  */
 ObjectTracker::ObjectTracker(QObject *parent) : QObject(parent) {
-    net = cv::dnn::readNetFromCaffe(MODEL_PROTOTXT_FILE, MODEL_CAFFEMODEL_FILE);
-    layers = net.getUnconnectedOutLayersNames();
+    detectionWorker = nullptr;
+    detectionPending = false;
+    detectionRequest = 0;
+    detectionMode = DetectionMode::SynchronousDetection;
+    adaptiveDetection = false;
+    detectionInterval.storeRelease(scheduler.getInterval());
+    slotClient = DetectionSlots::instance().join();
+    heldSlots = 0;
+    slotRequested = false;
+    phasePending = true;
+    detectionThread.setObjectName("DetectionThread");
+    idle = false;
+    motionGating = false;
+    trackerAlgorithm = TrackedObject::KcfTracker;
+    grayTracking = false;
+    associationMethod = TrackAssociator::HungarianAssociation;
+    predictiveTracking = false;
+    parallelTracking = true;
+    staggeredDetection = true;
+    nextObjectId = 0;
+    regionOfInterest = cv::Rect();
     frameNumber = 0;
+    enterDirection = EnterDirection::Up;
+    countingLinesVersion = 1;
+    activeLinesVersion = 0;
+    inputSize = cv::Size(DEFAULT_INPUT_WIDTH, DEFAULT_INPUT_HEIGHT);
+    renderMode = RenderMode::InlineRendering;
+    budget = governor.getBudget();
+    degradationLevel.storeRelease(governor.getLevel());
+    degradationSteps.storeRelease(0);
+    budgetSkippedFrames.storeRelease(0);
 }
 
 /**
  * @brief Destructs an ObjectTracker object.
  */
 ObjectTracker::~ObjectTracker() {
+    // Make sure a shared inference service no longer delivers results to us
+    if (!inferenceService.isNull()) {
+        inferenceService->cancel(this);
+    }
+
+    // The worker is deleted on its own thread once the thread finishes
+    detectionThread.quit();
+    detectionThread.wait();
+
+    // Gives back the slots of detections whose results will never arrive
+    DetectionSlots::instance().leave(slotClient);
+
+    ModelRegistry::instance().release(detector);
+}
+
+/**
+ * @brief Applies the tracker settings saved in the settings window.
+ * @return false if the saved DNN backend and target are not available in this build and the defaults are used instead.
+ */
+bool ObjectTracker::loadSettings() {
+    QSettings settings;
+
+    setDrawFlags(settings.value("tracker/drawFlags").value<ObjectTracker::DrawFlags>());
+    setEnterDirection(static_cast<ObjectTracker::EnterDirection>(settings.value("tracker/enterDirection").toUInt()));
+    setCountingLines(CountingLines::Line::fromStrings(settings.value("tracker/countingLines").toStringList()));
+    setInputSize(cv::Size(settings.value("tracker/inputWidth", DEFAULT_INPUT_WIDTH).toInt(),
+                          settings.value("tracker/inputHeight", DEFAULT_INPUT_HEIGHT).toInt()));
+    setDetectorBackend(static_cast<PersonDetector::Backend>(settings.value("tracker/detectorBackend", PersonDetector::OpenCvBackend).toInt()));
+    setQuantizedDetector(settings.value("tracker/quantizedDetector", false).toBool());
+    setDetectorThreads(settings.value("tracker/detectorThreads", 0).toInt());
+
+    const bool available = setDnnPreference(settings.value("tracker/dnnBackend", cv::dnn::DNN_BACKEND_DEFAULT).toInt(),
+                                            settings.value("tracker/dnnTarget", cv::dnn::DNN_TARGET_CPU).toInt());
+
+    PersonDetector::Tiling tiling;
+    tiling.columns = settings.value("tracker/tileColumns", 1).toInt();
+    tiling.rows = settings.value("tracker/tileRows", 1).toInt();
+    tiling.overlap = settings.value("tracker/tileOverlap", DEFAULT_TILE_OVERLAP).toDouble();
+    setTiling(tiling);
 
+    const auto regionOfInterest = settings.value("tracker/regionOfInterest").toRect();
+    setRegionOfInterest(cv::Rect(regionOfInterest.x(), regionOfInterest.y(), regionOfInterest.width(), regionOfInterest.height()));
+
+    const auto asyncDetection = settings.value("tracker/asyncDetection", false).toBool();
+    setDetectionMode(asyncDetection ? ObjectTracker::AsynchronousDetection : ObjectTracker::SynchronousDetection);
+    setAdaptiveDetection(settings.value("tracker/adaptiveDetection", false).toBool());
+    setMotionGating(settings.value("tracker/motionGating", false).toBool());
+    setAssociationMethod(static_cast<TrackAssociator::Method>(settings.value("tracker/associationMethod", TrackAssociator::HungarianAssociation).toInt()));
+    setPredictiveTracking(settings.value("tracker/predictiveTracking", false).toBool());
+    setTrackerAlgorithm(static_cast<TrackedObject::Algorithm>(settings.value("tracker/algorithm", TrackedObject::KcfTracker).toInt()));
+    setGrayTracking(settings.value("tracker/grayTracking", false).toBool());
+    setParallelTracking(settings.value("tracker/parallelTracking", true).toBool());
+    setBudget({ settings.value("governor/enabled", false).toBool(),
+                settings.value("governor/frameDeadline", DEFAULT_FRAME_DEADLINE).toDouble(),
+                settings.value("governor/cpuShare", DEFAULT_CPU_SHARE).toDouble() });
+
+    return available;
 }
 
 /**
@@ -26,6 +118,7 @@ ObjectTracker::~ObjectTracker() {
  * @return the currently set draw flags.
  */
 ObjectTracker::DrawFlags ObjectTracker::getDrawFlags() const {
+    QMutexLocker locker(&settingsMutex);
     return drawFlags;
 }
 
@@ -35,6 +128,7 @@ ObjectTracker::DrawFlags ObjectTracker::getDrawFlags() const {
  * @param flags the draw flags to set.
  */
 void ObjectTracker::setDrawFlags(const ObjectTracker::DrawFlags flags) {
+    QMutexLocker locker(&settingsMutex);
     drawFlags = flags;
 }
 
@@ -43,6 +137,7 @@ void ObjectTracker::setDrawFlags(const ObjectTracker::DrawFlags flags) {
  * @return the currently set enter direction.
  */
 ObjectTracker::EnterDirection ObjectTracker::getEnterDirection() const {
+    QMutexLocker locker(&settingsMutex);
     return enterDirection;
 }
 
@@ -51,191 +146,856 @@ ObjectTracker::EnterDirection ObjectTracker::getEnterDirection() const {
  * @param direction the enter direction to set.
  */
 void ObjectTracker::setEnterDirection(const ObjectTracker::EnterDirection direction) {
+    QMutexLocker locker(&settingsMutex);
     enterDirection = direction;
+    countingLinesVersion++;
+}
+
+/**
+ * @brief Returns the lines and zones people are counted across.
+ * @return the currently set counting lines, empty if people are counted across the default line.
+ */
+std::vector<CountingLines::Line> ObjectTracker::getCountingLines() const {
+    QMutexLocker locker(&settingsMutex);
+    return countingLines;
+}
+
+/**
+ * @brief Sets the lines and zones people are counted across, each with its own enter direction.
+ * People are counted whenever the latest movement of their trajectory crosses a line, once for every line crossed.
+ * Without lines, people are counted across the center of the region in the enter direction.
+ * @param lines the counting lines to set, in fractions of the region of interest.
+ */
+void ObjectTracker::setCountingLines(const std::vector<CountingLines::Line>& lines) {
+    QMutexLocker locker(&settingsMutex);
+    countingLines = lines;
+    countingLinesVersion++;
+}
+
+/**
+ * @brief Returns the line through the center of the region people are counted across when no lines are set.
+ * @param direction the direction people walk to enter.
+ * @return the default counting line.
+ */
+CountingLines::Line ObjectTracker::getDefaultLine(const ObjectTracker::EnterDirection direction) {
+    CountingLines::Line line;
+    line.name = "Threshold";
+    line.zone = false;
+
+    // Entering crosses a line from its left to its right, as walked from its first point
+    if (direction == EnterDirection::Up || direction == EnterDirection::Down) {
+        line.points = { cv::Point2f(0, 0.5f), cv::Point2f(1, 0.5f) };
+        line.reversed = direction == EnterDirection::Up;
+    } else {
+        line.points = { cv::Point2f(0.5f, 0), cv::Point2f(0.5f, 1) };
+        line.reversed = direction == EnterDirection::Right;
+    }
+
+    return line;
+}
+
+/**
+ * @brief Returns the input size of the detection network.
+ * @return the size frames are resized to before detection.
+ */
+cv::Size ObjectTracker::getInputSize() const {
+    QMutexLocker locker(&settingsMutex);
+    return inputSize;
+}
+
+/**
+ * @brief Sets the input size of the detection network.
+ * Detection cost depends only on this size, not on the resolution of the frames.
+ * @param size the size frames are resized to before detection.
+ */
+void ObjectTracker::setInputSize(const cv::Size size) {
+    QMutexLocker locker(&settingsMutex);
+    inputSize = size;
+}
+
+/**
+ * @brief Returns every option detectors are created with.
+ * @return the currently set detector options.
+ */
+PersonDetector::Options ObjectTracker::getDetectorOptions() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions;
+}
+
+/**
+ * @brief Returns the inference engine detectors run on.
+ * @return the currently set detector backend.
+ */
+PersonDetector::Backend ObjectTracker::getDetectorBackend() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions.backend;
+}
+
+/**
+ * @brief Sets the inference engine detectors run on. Detectors are recreated on their next detection.
+ * Falls back to the OpenCV backend if the given one is not available in this build.
+ * @param backend the detector backend to set.
+ */
+void ObjectTracker::setDetectorBackend(const PersonDetector::Backend backend) {
+    QMutexLocker locker(&settingsMutex);
+    detectorOptions.backend = PersonDetector::isAvailable(backend) ? backend : PersonDetector::OpenCvBackend;
+}
+
+/**
+ * @brief Returns whether detectors load the INT8-quantized network.
+ * @return true if the quantized network is used, false for the full precision one.
+ */
+bool ObjectTracker::isQuantizedDetector() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions.quantized;
+}
+
+/**
+ * @brief Sets whether detectors load the INT8-quantized network. Detectors are recreated on their next detection.
+ * The quantized network is several times cheaper on CPUs with fast integer instructions, at a small cost in accuracy.
+ * @param quantized true for the quantized network, false for the full precision one.
+ */
+void ObjectTracker::setQuantizedDetector(const bool quantized) {
+    QMutexLocker locker(&settingsMutex);
+    detectorOptions.quantized = quantized;
+}
+
+/**
+ * @brief Falls back to the full precision OpenCV detector if the model of the set backend and precision cannot be loaded,
+ * e.g. because its INT8 or ONNX export is missing. The model is loaded now if it was not yet.
+ * @return false if the set backend and precision were replaced.
+ */
+bool ObjectTracker::resolveDetector() {
+    const auto options = getDetectorOptions();
+    PersonDetector::Options resolved;
+
+    ModelRegistry::instance().resolve(options, resolved);
+
+    if (resolved.backend == options.backend && resolved.quantized == options.quantized) {
+        return true;
+    }
+
+    std::cerr << "Falling back to the " << PersonDetector::getBackendName(resolved.backend).toStdString() << " FP32 model" << std::endl;
+
+    setDetectorBackend(resolved.backend);
+    setQuantizedDetector(resolved.quantized);
+
+    return false;
+}
+
+/**
+ * @brief Returns the backend of OpenCV's dnn module the OpenCV detector runs on.
+ * @return the currently set cv::dnn::Backend.
+ */
+int ObjectTracker::getDnnBackend() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions.dnnBackend;
+}
+
+/**
+ * @brief Returns the target of OpenCV's dnn module the OpenCV detector runs on.
+ * @return the currently set cv::dnn::Target.
+ */
+int ObjectTracker::getDnnTarget() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions.dnnTarget;
+}
+
+/**
+ * @brief Sets the backend and target of OpenCV's dnn module the OpenCV detector runs on.
+ * Combinations not available in this build are rejected, and the default backend on the CPU is used instead.
+ * @param dnnBackend the cv::dnn::Backend to set.
+ * @param dnnTarget the cv::dnn::Target to set.
+ * @return true if the combination is available, false if the default was used instead.
+ */
+bool ObjectTracker::setDnnPreference(const int dnnBackend, const int dnnTarget) {
+    const bool available = PersonDetector::isDnnPreferenceAvailable(dnnBackend, dnnTarget);
+
+    if (!available) {
+        std::cerr << "DNN backend " << PersonDetector::getDnnBackendName(dnnBackend).toStdString() << " on "
+                  << PersonDetector::getDnnTargetName(dnnTarget).toStdString()
+                  << " is not available, using the default backend on the CPU" << std::endl;
+    }
+
+    QMutexLocker locker(&settingsMutex);
+    detectorOptions.dnnBackend = available ? dnnBackend : cv::dnn::DNN_BACKEND_DEFAULT;
+    detectorOptions.dnnTarget = available ? dnnTarget : cv::dnn::DNN_TARGET_CPU;
+
+    return available;
+}
+
+/**
+ * @brief Returns the maximum number of threads each ONNX Runtime detector may use.
+ * @return the thread cap, zero if ONNX Runtime decides.
+ */
+int ObjectTracker::getDetectorThreads() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectorOptions.threads;
+}
+
+/**
+ * @brief Sets the maximum number of threads each ONNX Runtime detector may use, so inference leaves cores to capture
+ * and tracking. OpenCV detectors are not affected, they share the process-wide count set with
+ * PersonDetector::setOpenCvThreads(). The cap is clamped to the number of cores.
+ * @param threads the thread cap, zero to let ONNX Runtime decide.
+ */
+void ObjectTracker::setDetectorThreads(const int threads) {
+    QMutexLocker locker(&settingsMutex);
+    detectorOptions.threads = std::max(0, std::min(threads, QThread::idealThreadCount()));
+}
+
+/**
+ * @brief Returns how the region of interest is split into tiles for detection.
+ * @return the currently set tiling.
+ */
+PersonDetector::Tiling ObjectTracker::getTiling() const {
+    QMutexLocker locker(&settingsMutex);
+    return tiling;
+}
+
+/**
+ * @brief Sets how the region of interest is split into overlapping tiles, detected as one batch and merged.
+ * More tiles find smaller, more distant people at the cost of one network input per tile.
+ * The grid is clamped to MAX_TILES_PER_AXIS along each axis and the overlap to MAX_TILE_OVERLAP.
+ * @param tiling the tiling to set, a single tile to detect the whole region at once.
+ */
+void ObjectTracker::setTiling(const PersonDetector::Tiling& tiling) {
+    QMutexLocker locker(&settingsMutex);
+    this->tiling.columns = std::max(1, std::min(tiling.columns, MAX_TILES_PER_AXIS));
+    this->tiling.rows = std::max(1, std::min(tiling.rows, MAX_TILES_PER_AXIS));
+    this->tiling.overlap = std::max(0.0, std::min(tiling.overlap, MAX_TILE_OVERLAP));
+}
+
+/**
+ * @brief Returns the currently set detection mode.
+ * @return the currently set detection mode.
+ */
+ObjectTracker::DetectionMode ObjectTracker::getDetectionMode() const {
+    QMutexLocker locker(&settingsMutex);
+    return detectionMode;
+}
+
+/**
+ * @brief Sets whether detection frames block on the neural network or detect in the background.
+ * Background detection keeps the time per frame flat at the cost of detections being applied a few frames late.
+ * @param mode the detection mode to set.
+ */
+void ObjectTracker::setDetectionMode(const ObjectTracker::DetectionMode mode) {
+    QMutexLocker locker(&settingsMutex);
+    detectionMode = mode;
+}
+
+/**
+ * @brief Returns whether the detection interval adapts to the scene.
+ * @return true if the detection interval is adaptive, false if it is fixed at FAST_TRACKING_FRAMES.
+ */
+bool ObjectTracker::isAdaptiveDetection() const {
+    QMutexLocker locker(&settingsMutex);
+    return adaptiveDetection;
+}
+
+/**
+ * @brief Sets whether the detection interval adapts to the scene.
+ * An adaptive interval detects rarely while the scene is empty and more often when trackers lose their object,
+ * the number of people changes or someone approaches the threshold.
+ * @param adaptive true for an adaptive interval, false for a fixed one.
+ */
+void ObjectTracker::setAdaptiveDetection(const bool adaptive) {
+    QMutexLocker locker(&settingsMutex);
+    adaptiveDetection = adaptive;
+}
+
+/**
+ * @brief Returns the current number of frames between two detections. Can be called from any thread.
+ * @return the current detection interval.
+ */
+int ObjectTracker::getDetectionInterval() const {
+    return detectionInterval.loadAcquire();
+}
+
+/**
+ * @brief Returns whether frames without motion skip detection and tracking.
+ * @return true if motion gating is enabled.
+ */
+bool ObjectTracker::isMotionGating() const {
+    QMutexLocker locker(&settingsMutex);
+    return motionGating;
+}
+
+/**
+ * @brief Sets whether frames without motion skip detection and tracking.
+ * Each frame is first compared with a cheap, downscaled background model. While nothing moves, objects are
+ * neither detected nor tracked and keep their last position. A detection runs as soon as motion returns.
+ * @param gating true to enable motion gating, false to process every frame.
+ */
+void ObjectTracker::setMotionGating(const bool gating) {
+    QMutexLocker locker(&settingsMutex);
+    motionGating = gating;
+}
+
+/**
+ * @brief Returns the algorithm following objects between detections.
+ * @return the currently set tracker algorithm.
+ */
+TrackedObject::Algorithm ObjectTracker::getTrackerAlgorithm() const {
+    QMutexLocker locker(&settingsMutex);
+    return trackerAlgorithm;
+}
+
+/**
+ * @brief Sets the algorithm following objects between detections. Objects switch to it on their next detection.
+ * MOSSE is the cheapest and CSRT the most robust, which one fits depends on the scene's lighting and camera height.
+ * @param algorithm the tracker algorithm to set.
+ */
+void ObjectTracker::setTrackerAlgorithm(const TrackedObject::Algorithm algorithm) {
+    QMutexLocker locker(&settingsMutex);
+    trackerAlgorithm = algorithm;
+}
+
+/**
+ * @brief Returns whether every tracker reads the grayscale frame shared by the objects of a frame.
+ * @return true if gray tracking is enabled.
+ */
+bool ObjectTracker::isGrayTracking() const {
+    QMutexLocker locker(&settingsMutex);
+    return grayTracking;
+}
+
+/**
+ * @brief Sets whether every tracker reads the grayscale frame shared by the objects of a frame.
+ * MOSSE and the optical flow always do. KCF and CSRT are cheaper on it but lose their color features,
+ * objects switch on their next detection.
+ * @param gray true to enable gray tracking.
+ */
+void ObjectTracker::setGrayTracking(const bool gray) {
+    QMutexLocker locker(&settingsMutex);
+    grayTracking = gray;
+}
+
+/**
+ * @brief Returns how detections are matched with the currently tracked objects.
+ * @return the currently set association method.
+ */
+TrackAssociator::Method ObjectTracker::getAssociationMethod() const {
+    QMutexLocker locker(&settingsMutex);
+    return associationMethod;
+}
+
+/**
+ * @brief Sets how detections are matched with the currently tracked objects.
+ * Matched objects keep their identifier and inside/outside state across detection frames.
+ * @param method the association method to set.
+ */
+void ObjectTracker::setAssociationMethod(const TrackAssociator::Method method) {
+    QMutexLocker locker(&settingsMutex);
+    associationMethod = method;
+}
+
+/**
+ * @brief Returns whether well-conditioned objects are moved by their motion prediction instead of the tracker.
+ * @return true if predictive tracking is enabled.
+ */
+bool ObjectTracker::isPredictiveTracking() const {
+    QMutexLocker locker(&settingsMutex);
+    return predictiveTracking;
+}
+
+/**
+ * @brief Sets whether well-conditioned objects are moved by their motion prediction instead of the tracker.
+ * An object confirmed by detections and closely following its prediction skips the tracker for a few frames at a time.
+ * @param predictive true to enable predictive tracking.
+ */
+void ObjectTracker::setPredictiveTracking(const bool predictive) {
+    QMutexLocker locker(&settingsMutex);
+    predictiveTracking = predictive;
+}
+
+/**
+ * @brief Returns whether the objects of a frame are updated in parallel.
+ * @return true if parallel tracking is enabled.
+ */
+bool ObjectTracker::isParallelTracking() const {
+    QMutexLocker locker(&settingsMutex);
+    return parallelTracking;
+}
+
+/**
+ * @brief Sets whether the objects of a frame are updated in parallel on the tracking pool shared by every tracker.
+ * Objects are counted in the same order either way, so the results do not change.
+ * @param parallel true to enable parallel tracking.
+ */
+void ObjectTracker::setParallelTracking(const bool parallel) {
+    QMutexLocker locker(&settingsMutex);
+    parallelTracking = parallel;
+}
+
+/**
+ * @brief Returns whether detections are shifted by this tracker's phase in the shared detection schedule.
+ * @return true if detections are staggered.
+ */
+bool ObjectTracker::isStaggeredDetection() const {
+    QMutexLocker locker(&settingsMutex);
+    return staggeredDetection;
+}
+
+/**
+ * @brief Sets whether detections are shifted by this tracker's phase, after the first detection since a restart.
+ * Trackers that must detect on the same frames as others, e.g. to compare them, should not be staggered.
+ * @param staggered true to stagger detections.
+ */
+void ObjectTracker::setStaggeredDetection(const bool staggered) {
+    QMutexLocker locker(&settingsMutex);
+    staggeredDetection = staggered;
+}
+
+/**
+ * @brief Returns the time spent updating tracked objects per frame, by the number of objects in the frame.
+ * @return the tracking times, indexed by the number of objects. Counts without frames are zero.
+ */
+std::vector<ObjectTracker::TrackingTime> ObjectTracker::getTrackingTimes() const {
+    QMutexLocker locker(&timesMutex);
+    return trackingTimes;
+}
+
+/**
+ * @brief Clears the recorded tracking times.
+ */
+void ObjectTracker::resetTrackingTimes() {
+    QMutexLocker locker(&timesMutex);
+    trackingTimes.clear();
+}
+
+/**
+ * @brief Returns the number of frames run through detection and tracking while motion gating was enabled.
+ * Can be called from any thread.
+ * @return the number of frames in which motion was found.
+ */
+unsigned long long ObjectTracker::getRunFrameCount() const {
+    return motionGate.getRunFrameCount();
+}
+
+/**
+ * @brief Returns the number of frames skipped for lack of motion. Can be called from any thread.
+ * @return the number of frames in which no motion was found.
+ */
+unsigned long long ObjectTracker::getSkippedFrameCount() const {
+    return motionGate.getSkippedFrameCount();
+}
+
+/**
+ * @brief Returns the region of interest.
+ * @return the region frames are processed in, empty for the whole frame.
+ */
+cv::Rect ObjectTracker::getRegionOfInterest() const {
+    QMutexLocker locker(&settingsMutex);
+    return regionOfInterest;
+}
+
+/**
+ * @brief Sets the region of interest, usually the area around the door.
+ * Detection, tracking, counting and drawing only operate on this part of each frame, through a view
+ * sharing the frame's pixels. Counting lines are placed relative to the region. The region is
+ * clipped to the frame, an empty region (or one outside the frame) stands for the whole frame.
+ * Changing the region drops the currently tracked objects.
+ * @param region the region to process, in frame coordinates.
+ */
+void ObjectTracker::setRegionOfInterest(const cv::Rect region) {
+    QMutexLocker locker(&settingsMutex);
+    regionOfInterest = region;
+}
+
+/**
+ * @brief Returns the shared inference service background detections are submitted to.
+ * @return the shared inference service, or nullptr if the tracker detects on its own worker.
+ */
+InferenceService *ObjectTracker::getInferenceService() const {
+    QMutexLocker locker(&settingsMutex);
+    return inferenceService;
+}
+
+/**
+ * @brief Sets a shared inference service to submit background detections to, instead of detecting on an own worker.
+ * The service batches the detections of many trackers into single forward passes. Only used in asynchronous detection mode.
+ * @param service the shared inference service, or nullptr to detect on an own worker.
+ */
+void ObjectTracker::setInferenceService(InferenceService *service) {
+    QMutexLocker locker(&settingsMutex);
+    inferenceService = service;
+}
+
+/**
+ * @brief Returns the currently set CPU budget.
+ * @return the currently set CPU budget.
+ */
+BudgetGovernor::Budget ObjectTracker::getBudget() const {
+    QMutexLocker locker(&settingsMutex);
+    return budget;
+}
+
+/**
+ * @brief Sets the CPU budget processing is kept within. While it is exceeded, the governor detects less often,
+ * on a smaller input, tracks with a cheaper algorithm and finally skips frames, see BudgetGovernor.
+ * @param budget the CPU budget to set, disabled to always process at full quality.
+ */
+void ObjectTracker::setBudget(const BudgetGovernor::Budget& budget) {
+    QMutexLocker locker(&settingsMutex);
+    this->budget = budget;
+}
+
+/**
+ * @brief Returns the step of the degradation ladder frames are currently processed at.
+ * @return the current degradation level.
+ */
+BudgetGovernor::Level ObjectTracker::getDegradationLevel() const {
+    return static_cast<BudgetGovernor::Level>(degradationLevel.loadAcquire());
+}
+
+/**
+ * @brief Returns the number of steps the governor took down or up the degradation ladder.
+ * @return the number of steps.
+ */
+unsigned long long ObjectTracker::getDegradationStepCount() const {
+    return degradationSteps.loadAcquire();
+}
+
+/**
+ * @brief Returns the number of frames skipped to stay within the CPU budget.
+ * @return the number of skipped frames.
+ */
+unsigned long long ObjectTracker::getBudgetSkippedFrameCount() const {
+    return budgetSkippedFrames.loadAcquire();
+}
+
+/**
+ * @brief Returns the currently set render mode.
+ * @return the currently set render mode.
+ */
+ObjectTracker::RenderMode ObjectTracker::getRenderMode() const {
+    QMutexLocker locker(&settingsMutex);
+    return renderMode;
+}
+
+/**
+ * @brief Sets what happens to frames once they have been processed.
+ * With deferred rendering, drawing and QImage conversion are left to a FrameRenderer connected to frameTracked,
+ * which allows rendering to run on a separate thread. Without rendering, frames are only tracked and counted.
+ * @param mode the render mode to set.
+ */
+void ObjectTracker::setRenderMode(const ObjectTracker::RenderMode mode) {
+    QMutexLocker locker(&settingsMutex);
+    renderMode = mode;
 }
 
 /**
  * @brief Porcesses the given frame and performs object tracking and drawing on it.
- * Processes the given frame by detecting objects every FAST_TRACKING_FRAMES and tracking
- * objects in intermediate frames. Then performs drawing on the frame as specified by
+ * Processes the given frame by detecting objects every few frames, as decided by the detection
+ * scheduler, and tracking objects in intermediate frames. Then performs drawing on the frame as specified by
  * the draw flags. Finally, a signal with the processed frame is emitted.
- * @param frame the frame to process.
+ * The frame is processed and drawn on in place, its pooled buffer is handed on without copying.
+ * @param handle the frame to process.
  */
-void ObjectTracker::processFrame(cv::Mat frame) {
-    // Get the number of rows (height) and columns (width) in the frame
-    const int rows = frame.rows;
-    const int cols = frame.cols;
+void ObjectTracker::processFrame(FrameHandle handle) {
+    cv::Mat& frame = handle.mat();
+
+    // The whole frame is weighed against the CPU budget, rendering included
+    QElapsedTimer frameClock;
+    frameClock.start();
+
+    // Take a consistent copy of the settings, they may be changed from another thread while we process
+    settingsMutex.lock();
+    const auto enterDirection = this->enterDirection;
+    const auto drawFlags = this->drawFlags;
+    const auto renderMode = this->renderMode;
+    const auto configuredInputSize = this->inputSize;
+    const auto detectionMode = this->detectionMode;
+    const auto detectorOptions = this->detectorOptions;
+    const auto tiling = this->tiling;
+    const auto adaptiveDetection = this->adaptiveDetection;
+    const auto motionGating = this->motionGating;
+    const auto configuredAlgorithm = this->trackerAlgorithm;
+    const auto grayTracking = this->grayTracking;
+    const auto associationMethod = this->associationMethod;
+    const auto predictiveTracking = this->predictiveTracking;
+    const auto parallelTracking = this->parallelTracking;
+    const auto regionOfInterest = this->regionOfInterest;
+    const auto budget = this->budget;
+
+    // The lines are only copied when they changed
+    const bool linesChanged = countingLinesVersion != activeLinesVersion;
 
-    // Get the center (x, y) coordinate of the frame
-    const auto center = cv::Point(cols / 2, rows / 2);
+    if (linesChanged) {
+        activeLineSettings = countingLines.empty() ? std::vector<CountingLines::Line>{ getDefaultLine(enterDirection) } : countingLines;
+        activeLinesVersion = countingLinesVersion;
+    }
+
+    settingsMutex.unlock();
+
+    scheduler.setAdaptive(adaptiveDetection);
+
+    // Under load, the governor trades accuracy for time at the step it reached on earlier frames
+    governor.setBudget(budget);
+    scheduler.setIntervalScale(governor.getIntervalScale());
+    const auto inputSize = governor.getInputSize(configuredInputSize);
+    const auto trackerAlgorithm = governor.getAlgorithm(configuredAlgorithm);
+    const auto degradation = governor.getLevel();
+
+    // Only the region of interest is detected and tracked in, an empty region stands for the whole frame
+    const auto bounds = cv::Rect(0, 0, frame.cols, frame.rows);
+    const auto region = (regionOfInterest & bounds).area() > 0 ? regionOfInterest & bounds : bounds;
+
+    // Lines are given in fractions of the region, scale them to its pixels
+    if (linesChanged || region != activeRegion) {
+        activeLines = std::make_shared<const CountingLines>(activeLineSettings, region.size());
+        segmentCrossings.assign(activeLines->getSegmentCount(), 0);
+        lineCrossings.assign(activeLines->getLineCount(), 0);
+    }
+
+    // Coordinates of tracked objects are relative to the region, they no longer apply once it moves
+    if (region != activeRegion) {
+        restart();
+        activeRegion = region;
+    }
+
+    // A view sharing the frame's pixels, nothing is copied
+    cv::Mat view = frame(region);
+
+    // Get the number of rows (height) and columns (width) in the region
+    const int rows = view.rows;
+    const int cols = view.cols;
+
+    // Crossings only count once the object is this far past the line
+    const float crossingMargin = static_cast<float>(std::min(rows, cols) * CROSSING_MARGIN_FRACTION);
 
     // Keep track of the frame's tracking status
     QString status = "Waiting";
 
-    // Use the slower, more computationally expensive object detection every N frames
-    if (frameNumber % FAST_TRACKING_FRAMES == 0) {
-        // Create a 4D blob from the frame
-        cv::Mat blob = cv::dnn::blobFromImage(frame, 0.007843, cv::Size(cols, rows), cv::Scalar(127.5));
-        net.setInput(blob);
+    // Past the last step of the ladder, frames are skipped altogether, objects keep their last position
+    const bool shed = governor.shouldSkip();
 
-        // Run a forward pass on the neural network to detect objects
-        std::vector<cv::Mat> output;
-        net.forward(output, layers);
+    // While nothing moves, skip detection and tracking entirely, objects keep their last position
+    const bool gated = !shed && motionGating && !motionGate.hasMotion(view);
+    const bool skipped = shed || gated;
 
-        // Clear the currently tracked objects, we will create new ones based on detected objects
-        objects.clear();
+    // Once motion returns, detect right away instead of trusting trackers that sat idle
+    if (idle && !skipped) {
+        scheduler.expedite();
+    }
 
-        // Set the frame's status to detecting sicne we are running our object detector
-        status = "Detecting";
+    if (!shed) {
+        idle = gated;
+    }
 
-        // Neural network produces output blob with a shape of 1x1xNx7 where N is the number of detections
-        // Every detection is a vector of values [batchId, classId, confidence, left, top, right, bottom]
-        for (std::size_t k = 0; k < output.size(); k++) {
-            const float *data = (float *) output[k].data;
+    // The time spent in each stage, for the governor
+    double detectionTime = 0;
+    double trackingTime = 0;
 
-            for (std::size_t i = 0; i < output[k].total(); i += 7) {
-                const float confidence = data[i + 2];
+    // Use the slower, more computationally expensive object detection every N frames, once it is this stream's turn.
+    // A background detection still in progress is not doubled, the next one waits for it
+    const bool detectionDue = !skipped && scheduler.isDetectionDue() && (detectionMode == DetectionMode::SynchronousDetection || !detectionPending);
+    const bool detectionFrame = acquireDetectionSlot(detectionDue);
 
-                // Ignore weak detections that do not satisfy the minimum confidence level
-                if (confidence >= MIN_CONFIDENCE_LEVEL) {
-                    const int classId = (int) data[i + 1];
+    if (!skipped) {
+        // Convert and downscale the frame once for every object, only as far as their trackers need
+        bool withGray = grayTracking || TrackedObject::usesGray(trackerAlgorithm);
+        bool withLevels = TrackedObject::usesLevels(trackerAlgorithm);
 
-                    // Ignore detections which are not of class "person"
-                    if (classId != PERSON_CLASS_ID) {
-                        continue;
-                    }
+        for (const auto& object : objects) {
+            withGray = withGray || object.isGray();
+            withLevels = withLevels || TrackedObject::usesLevels(object.getAlgorithm());
+        }
 
-                    // Calculate the bounding box for the object
-                    const int x = (int) (data[i + 3] * cols);
-                    const int y = (int) (data[i + 4] * rows);
-                    const int w = (int) (data[i + 5] * cols) - x;
-                    const int h = (int) (data[i + 6] * rows) - y;
+        currentPyramid.build(view, withGray, withLevels);
+    }
+
+    if (shed) {
+        status = "Skipped";
+    } else if (skipped) {
+        status = "Idle";
+    } else if (detectionDue && !detectionFrame && objects.empty()) {
+        // Every detection slot is taken, keep waiting for our turn
+        status = "Queued";
+    } else if (detectionFrame && detectionMode == DetectionMode::SynchronousDetection) {
+        // Set the frame's status to detecting sicne we are running our object detector
+        status = "Detecting";
 
-                    cv::Rect bbox(x, y, w, h);
+        QElapsedTimer clock;
+        clock.start();
 
-                    // Initialize a tracked object with this known bounding for it
-                    // and store it so it can be used during fast detection frames
-                    objects.push_back(TrackedObject(frame, bbox));
-                }
+        // Take a warmed-up detector for the selected backend and precision if they changed, nothing is found without a model
+        const bool acquired = ModelRegistry::instance().acquire(detector, detectorOptions, inputSize);
+        std::vector<cv::Rect> boxes;
+
+        if (acquired) {
+            try {
+                boxes = detector->detectTiled(view, tiling);
+            } catch (const std::exception& e) {
+                detector->reportFailure(e);
             }
         }
+
+        // Match the detections with where the current objects should be by now, matched objects keep their state
+        for (auto& object : objects) {
+            object.predict();
+        }
+
+        associate(currentPyramid, boxes, associationMethod, trackerAlgorithm, grayTracking);
+
+        detectionTime = clock.nsecsElapsed() / 1e6;
+
+        detectionStarted();
+        scheduler.detectionFinished(static_cast<int>(boxes.size()));
+        releaseDetectionSlot();
     } else {
         // In intermediate frames, update the previously detected objects
-        for (auto& object : objects) {
-            object.update(frame);
+        if (!objects.empty()) {
+            QElapsedTimer clock;
+            clock.start();
+
+            // Every object is updated before any is counted, the counting below runs in order on this thread
+            TrackingTask::updateAll(objects, previousPyramid, currentPyramid, predictiveTracking, parallelTracking);
+
+            trackingTime = clock.nsecsElapsed() / 1e6;
+            recordTrackingTime(static_cast<int>(objects.size()), trackingTime);
 
             // Set the frame's status to tracking sice we had at least one object that we are tracking
             status = "Tracking";
         }
+
+        // In asynchronous mode, detect on a snapshot of this frame while we keep tracking. The slot is held until the result arrives
+        if (detectionFrame && requestDetection(view, inputSize, detectorOptions, tiling)) {
+            detectionStarted();
+            status = "Detecting";
+        } else if (detectionFrame) {
+            releaseDetectionSlot();
+        }
     }
 
+    // Snapshot the objects as they are after this frame so they can be drawn later
+    TrackedFrame trackedFrame;
+    trackedFrame.objects.reserve(objects.size());
+
+    // Keep track of the trackers' health and of objects about to cross, to adapt the detection interval
+    int lostCount = 0;
+    int nearThresholdCount = 0;
+
     for (auto& object : objects) {
-        // Get the object's position and determine whether it is inside or not
+        // Get the object's position
         const auto position = object.getPosition();
 
-        // Determine if the object is inside or not
-        // Add a 10% buffer on each side of the threshold to improve the detection probability
-        bool inside;
-
-        switch (enterDirection) {
-            case EnterDirection::Up:
-                inside = position.y < center.y - rows * 0.1;
-                break;
-            case EnterDirection::Down:
-                inside = position.y > center.y + rows * 0.1;
-                break;
-            case EnterDirection::Left:
-                inside = position.x < center.x - cols * 0.1;
-                break;
-            case EnterDirection::Right:
-                inside = position.x > center.y + cols * 0.1;
-                break;
+        // Count the object's latest movement across every line it crossed, objects do not move while idle
+        if (!skipped) {
+            object.record();
         }
 
-        // Get the object's current state and update it accordingly
-        const auto state = object.getState();
+        if (!skipped && object.getTrajectorySize() >= 2) {
+            activeLines->cross(object.getTrajectoryPoint(1), object.getTrajectoryPoint(0), segmentCrossings.data(), lineCrossings.data());
 
-        if (inside) {
-            if (state == TrackedObject::Outside) {
-                // Object entered...
-                emit personEntered();
-                std::cout << "[" << frameNumber << "] object entered" << std::endl;
+            if (linesChanged || object.getLineSideCount() != activeLines->getLineCount()) {
+                object.resetLineSides(activeLines->getLineCount());
             }
 
-            object.setState(TrackedObject::Inside);
-        } else {
-            if (state == TrackedObject::Inside) {
-                // Object exited...
-                emit personExited();
-                std::cout << "[" << frameNumber << "] object exited" << std::endl;
-            }
+            for (int i = 0; i < activeLines->getLineCount(); i++) {
+                auto& side = object.getLineSide(i);
 
-            object.setState(TrackedObject::Outside);
-        }
+                // A crossing moves the object to the other side, the side it came from is known from the first crossing on
+                if (lineCrossings[i] != 0) {
+                    side.pending = lineCrossings[i] > 0 ? TrackedObject::Inside : TrackedObject::Outside;
 
-        // Draw the bounding box of the object if required
-        if (drawFlags.testFlag(DrawFlag::DrawBoundingBoxes)) {
-            cv::rectangle(frame, object.getBBox(), cv::Scalar(255, 0, 0), 1, cv::LINE_AA);
-        }
+                    if (side.counted == TrackedObject::Unknown) {
+                        side.counted = lineCrossings[i] > 0 ? TrackedObject::Outside : TrackedObject::Inside;
+                    }
+                }
 
-        // Draw the centroid of the object if required
-        if (drawFlags.testFlag(DrawFlag::DrawCentroids)) {
-            cv::circle(frame, position, 2, cv::Scalar(0, 255, 255), -1, cv::LINE_AA);
-        }
+                // Crossing back before getting far enough past the line cancels the crossing
+                if (side.pending == side.counted) {
+                    side.pending = TrackedObject::Unknown;
+                }
 
-        // Display the object's current state if required
-        if (drawFlags.testFlag(DrawFlag::ShowStates)) {
-            const auto text = object.getStateString();
-            const auto size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, NULL);
-            const auto screenPos = position + cv::Point(-size.width / 2, size.height + 5);
+                if (side.pending == TrackedObject::Unknown || activeLines->distance(object.getTrajectoryPoint(0), i) < crossingMargin) {
+                    continue;
+                }
 
-            cv::putText(frame, text, screenPos, cv::FONT_HERSHEY_DUPLEX, 0.5, cv::Scalar(0, 0, 255), 1, cv::LINE_AA);
-        }
-    }
+                side.counted = side.pending;
+                side.pending = TrackedObject::Unknown;
+                object.setState(side.counted);
 
-    // Draw the enter/exit threshold as a line if required
-    if (drawFlags.testFlag(DrawFlag::DrawThresholds)) {
-        cv::Point p1, p2;
+                const auto& name = activeLines->getLine(i).name;
 
-        if (enterDirection == EnterDirection::Up || enterDirection == EnterDirection::Down) {
-            p1 = cv::Point(0, rows / 2);
-            p2 = cv::Point(cols, rows / 2);
-        } else {
-            p1 = cv::Point(cols / 2, 0);
-            p2 = cv::Point(cols / 2, rows);
+                if (side.counted == TrackedObject::Inside) {
+                    // Object entered...
+                    emit personEntered(name);
+                    std::cout << "[" << frameNumber << "] object entered across " << name.toStdString() << std::endl;
+                } else {
+                    // Object exited...
+                    emit personExited(name);
+                    std::cout << "[" << frameNumber << "] object exited across " << name.toStdString() << std::endl;
+                }
+            }
         }
 
-        cv::line(frame, p1, p2, cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
-    }
+        const bool nearThreshold = activeLines->distance(position) < std::min(rows, cols) * NEAR_THRESHOLD_FRACTION;
 
-    // Display frame number and status information if required
-    QString infoText = "";
+        lostCount += object.isFound() ? 0 : 1;
+        nearThresholdCount += nearThreshold ? 1 : 0;
 
-    if (drawFlags.testFlag(DrawFlag::ShowFrameNumber)) {
-        infoText = QString("Frame: %1").arg(frameNumber);
-    }
+        if (renderMode != RenderMode::NoRendering) {
+            trackedFrame.objects.push_back({ object.getId(), object.getBBox(), position, object.getStateString(), {} });
 
-    if (drawFlags.testFlag(DrawFlag::ShowFrameStatus)) {
-        infoText = QString("%1 (%2)").arg(infoText).arg(status);
+            if (drawFlags.testFlag(DrawFlag::DrawTrajectories)) {
+                auto& trajectory = trackedFrame.objects.back().trajectory;
+
+                for (int age = 0; age < object.getTrajectorySize(); age++) {
+                    trajectory.push_back(object.getTrajectoryPoint(age));
+                }
+            }
+        }
     }
 
-    if (infoText != "") {
-        const auto size = cv::getTextSize(infoText.toStdString(), cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, NULL);
-        const auto screenPos = cv::Point(0, size.height);
-        cv::putText(frame, infoText.toStdString(), screenPos, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 0), 1, cv::LINE_AA);
+    // Keep this frame's pyramid for the next update, without holding on to the frame's buffer
+    if (!skipped) {
+        currentPyramid.detach();
+        previousPyramid.swap(currentPyramid);
     }
 
+    scheduler.frameTracked(lostCount, nearThresholdCount);
+    detectionInterval.storeRelease(scheduler.getInterval());
+
+    trackedFrame.frame = std::move(handle);
+    trackedFrame.frameNumber = frameNumber;
+    trackedFrame.regionOfInterest = region;
+    trackedFrame.status = status;
+    trackedFrame.detectionInterval = scheduler.getInterval();
+    trackedFrame.degradation = degradation;
+    trackedFrame.countingLines = activeLines;
+    trackedFrame.drawFlags = drawFlags;
+
     // Increment the frame number
     frameNumber++;
 
-    // Convert the processed frame into a QImage and emit a signal containing it
-    QImage image(cols, rows, QImage::Format_RGB888);
+    // Either render the frame here or hand it on to a renderer, possibly running on another thread
+    if (renderMode == RenderMode::InlineRendering) {
+        emit frameProcessed(FrameRenderer::render(trackedFrame));
+    } else if (renderMode == RenderMode::DeferredRendering) {
+        emit frameTracked(trackedFrame);
+    }
+
+    // Skipped frames cost next to nothing, only the frames actually processed are weighed against the budget
+    if (shed) {
+        budgetSkippedFrames.storeRelease(governor.getSkippedFrameCount());
+    } else if (governor.frameProcessed(frameClock.nsecsElapsed() / 1e6, detectionTime, trackingTime)) {
+        std::cout << "[" << trackedFrame.frameNumber << "] processing "
+                  << (governor.getLevel() > degradation ? "degraded to " : "restored to ")
+                  << BudgetGovernor::getLevelName(governor.getLevel()) << " (load " << governor.getLoad()
+                  << ", detection " << governor.getDetectionTime() << " ms, tracking " << governor.getTrackingTime()
+                  << " ms per frame)" << std::endl;
 
-    cv::Mat mat(rows, cols, CV_8UC3, image.bits(), image.bytesPerLine());
-    cv::resize(frame, mat, mat.size(), 0, 0, cv::INTER_AREA);
-    cv::cvtColor(mat, mat, cv::COLOR_BGR2RGB);
+        degradationLevel.storeRelease(governor.getLevel());
+        degradationSteps.storeRelease(governor.getStepCount());
+        emit degradationChanged(governor.getLevel());
+    }
 
-	emit frameProcessed(image);
+    // Emitted whatever the render mode, so a source feeding several streams knows this one is ready for more
+    emit frameFinished();
 }
 
 /**
@@ -243,5 +1003,228 @@ void ObjectTracker::processFrame(cv::Mat frame) {
  */
 void ObjectTracker::reset() {
     frameNumber = 0;
+    nextObjectId = 0;
+    restart();
+}
+
+/**
+ * @brief Drops the tracked objects and every piece of state derived from earlier frames, without resetting the frame number.
+ * The next frame with motion is a detection frame.
+ */
+void ObjectTracker::restart() {
+    idle = false;
+    motionGate.reset();
     objects.clear();
+    scheduler.reset();
+    phasePending = true;
+    previousPyramid.clear();
+    currentPyramid.clear();
+
+    // Results of a background detection still in progress no longer apply
+    detectionPending = false;
+    detectionRequest++;
+
+    // The detection may still be reading the snapshot, so the next one must not overwrite it in place
+    snapshot.release();
+}
+
+/**
+ * @brief Starts a background detection on a snapshot of the given frame, unless one is already in progress.
+ * @param frame the frame to detect people in.
+ * @param inputSize the input size of the detection network.
+ * @param options the options of the detector to detect with.
+ * @param tiling how the frame is split into tiles.
+ * @return true if a detection was started.
+ */
+bool ObjectTracker::requestDetection(const cv::Mat& frame, const cv::Size inputSize, const PersonDetector::Options& options, const PersonDetector::Tiling& tiling) {
+    if (detectionPending) {
+        return false;
+    }
+
+    settingsMutex.lock();
+    const QPointer<InferenceService> inferenceService = this->inferenceService;
+    settingsMutex.unlock();
+
+    // The worker loads its own network the first time it is needed, unless a shared service detects for us
+    if (inferenceService.isNull() && detectionWorker == nullptr) {
+        detectionWorker = new DetectionWorker;
+        detectionWorker->moveToThread(&detectionThread);
+
+        connect(&detectionThread, &QThread::finished, detectionWorker, &QObject::deleteLater);
+        connect(this, &ObjectTracker::detectionRequested, detectionWorker, &DetectionWorker::detect, Qt::QueuedConnection);
+        connect(detectionWorker, &DetectionWorker::detected, this, &ObjectTracker::applyDetections, Qt::QueuedConnection);
+
+        detectionThread.start();
+    }
+
+    // The frame itself is drawn on and recycled, so the worker gets a copy of its own
+    frame.copyTo(snapshot);
+
+    detectionPending = true;
+    detectionRequest++;
+
+    if (inferenceService.isNull()) {
+        emit detectionRequested(snapshot, detectionRequest, inputSize.width, inputSize.height, options, tiling);
+    } else {
+        inferenceService->submit(this, snapshot, detectionRequest, inputSize, options, tiling);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Takes a slot from the process-wide DetectionSlots schedule if a detection is due on this frame.
+ * A tracker refused a slot keeps its place and asks again on the next frame, one no longer due gives up its place.
+ * @param due whether a detection is due on this frame.
+ * @return true if this frame is a detection frame, the slot must then be given back with releaseDetectionSlot().
+ */
+bool ObjectTracker::acquireDetectionSlot(const bool due) {
+    if (!due) {
+        if (slotRequested) {
+            DetectionSlots::instance().withdraw(slotClient);
+            slotRequested = false;
+        }
+
+        return false;
+    }
+
+    slotRequested = !DetectionSlots::instance().tryAcquire(slotClient);
+
+    if (slotRequested) {
+        return false;
+    }
+
+    heldSlots++;
+
+    return true;
+}
+
+/**
+ * @brief Gives back a slot taken by acquireDetectionSlot(), if this tracker still holds one.
+ */
+void ObjectTracker::releaseDetectionSlot() {
+    if (heldSlots > 0) {
+        DetectionSlots::instance().release(slotClient);
+        heldSlots--;
+    }
+}
+
+/**
+ * @brief Records that a detection was started on the current frame.
+ * The first detection after a restart shifts the schedule by this tracker's phase, so trackers started together
+ * detect on different frames from then on.
+ */
+void ObjectTracker::detectionStarted() {
+    scheduler.detectionStarted();
+
+    if (phasePending && isStaggeredDetection()) {
+        scheduler.delay(DetectionSlots::instance().getPhase(slotClient, scheduler.getInterval()));
+    }
+
+    phasePending = false;
+}
+
+/**
+ * @brief Records the time spent updating the objects of a frame.
+ * @param count the number of objects in the frame.
+ * @param time the time spent, in milliseconds.
+ */
+void ObjectTracker::recordTrackingTime(const int count, const double time) {
+    QMutexLocker locker(&timesMutex);
+
+    if (static_cast<int>(trackingTimes.size()) <= count) {
+        trackingTimes.resize(count + 1, TrackingTime { 0, 0.0, 0.0 });
+    }
+
+    auto& times = trackingTimes[count];
+    times.frames++;
+    times.total += time;
+    times.longest = std::max(times.longest, time);
+}
+
+/**
+ * @brief Reconciles the results of a background detection with the currently tracked objects.
+ * Detections are associated with the objects the same way as synchronous ones, initialized on the snapshot frame.
+ * @param boxes the bounding boxes of the people detected in the snapshot frame.
+ * @param request the request the detection was made for.
+ */
+void ObjectTracker::applyDetections(std::vector<cv::Rect> boxes, unsigned int request) {
+    // Results of detections dropped by a restart give back their slot too
+    releaseDetectionSlot();
+
+    if (request != detectionRequest) {
+        return;
+    }
+
+    detectionPending = false;
+    scheduler.detectionFinished(static_cast<int>(boxes.size()));
+
+    settingsMutex.lock();
+    const auto configuredAlgorithm = this->trackerAlgorithm;
+    const auto grayTracking = this->grayTracking;
+    const auto associationMethod = this->associationMethod;
+    settingsMutex.unlock();
+
+    const auto trackerAlgorithm = governor.getAlgorithm(configuredAlgorithm);
+
+    FramePyramid pyramid;
+    pyramid.build(snapshot);
+
+    // Objects are predicted for the latest live frame, a few frames after the snapshot, which is close enough to match.
+    // Matched trackers restart on the snapshot and catch up to the live frames on the next update
+    associate(pyramid, boxes, associationMethod, trackerAlgorithm, grayTracking);
+}
+
+/**
+ * @brief Matches detections with the currently tracked objects, which must have been predicted for the detection's frame.
+ * Matched objects restart tracking from their detection and keep their identifier and inside/outside state.
+ * Unmatched detections become new objects. Objects unmatched for more than MAX_MISSED_DETECTIONS detection frames
+ * are dropped, the others keep being tracked.
+ * @param pyramid the pyramid of the frame the detections were made in.
+ * @param boxes the bounding boxes of the people detected in the frame.
+ * @param method how detections are matched with objects.
+ * @param algorithm the algorithm following matched and new objects from now on.
+ * @param gray whether matched and new objects are tracked on the grayscale frame from now on.
+ */
+void ObjectTracker::associate(const FramePyramid& pyramid, const std::vector<cv::Rect>& boxes, const TrackAssociator::Method method,
+                              const TrackedObject::Algorithm algorithm, const bool gray) {
+    std::vector<cv::Rect> predictions;
+    predictions.reserve(objects.size());
+
+    for (const auto& object : objects) {
+        predictions.push_back(object.getPrediction());
+    }
+
+    std::vector<bool> objectMatched(objects.size(), false);
+    std::vector<bool> boxMatched(boxes.size(), false);
+
+    for (const auto& match : TrackAssociator::match(predictions, boxes, method)) {
+        objects[match.first].reinitialize(pyramid, boxes[match.second], algorithm, gray);
+        objectMatched[match.first] = true;
+        boxMatched[match.second] = true;
+    }
+
+    // Keep the surviving objects in order, so identifiers are listed the same way from frame to frame
+    std::vector<TrackedObject> associated;
+    associated.reserve(objects.size() + boxes.size());
+
+    for (std::size_t i = 0; i < objects.size(); i++) {
+        if (!objectMatched[i]) {
+            objects[i].miss();
+        }
+
+        if (objects[i].getMisses() <= MAX_MISSED_DETECTIONS) {
+            associated.push_back(std::move(objects[i]));
+        }
+    }
+
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+        if (!boxMatched[i]) {
+            // Initialize a tracked object with this known bounding for it
+            // and store it so it can be used during fast detection frames
+            associated.push_back(TrackedObject(pyramid, boxes[i], nextObjectId++, algorithm, gray));
+        }
+    }
+
+    objects.swap(associated);
 }
@@ -1,40 +1,48 @@
 #ifndef OBJECTTRACKER_H
 #define OBJECTTRACKER_H
 
+#include <memory>
 #include <vector>
 
+#include <QAtomicInt>
 #include <QImage>
+#include <QMutex>
+#include <QPointer>
+#include <QString>
+#include <QThread>
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/tracking.hpp>
 
+#include "BudgetGovernor.h"
+#include "CountingLines.h"
+#include "DetectionScheduler.h"
+#include "DetectionSlots.h"
+#include "DetectionWorker.h"
+#include "FramePool.h"
+#include "InferenceService.h"
+#include "MotionGate.h"
+#include "PersonDetector.h"
+#include "TrackAssociator.h"
 #include "TrackedObject.h"
 
 /**
- * The number of consecutive frames for which fast object tracking will occur.
- * After this, a slower, more computationally expensive object detection algorithm is used for one frame.
+ * The distance from the nearest counting line, as a fraction of the region's smaller side, within which an object
+ * counts as near the threshold. Used to detect more often while someone is about to cross.
  */
-#define FAST_TRACKING_FRAMES 30
+#define NEAR_THRESHOLD_FRACTION 0.2
 
 /**
- * The path to the .prototxt file containg the network architecture stored in Caffe framework's format.
+ * The distance an object has to move past a counting line before its crossing counts, as a fraction of the region's
+ * smaller side. Someone standing on a line, or a box jumping when its tracker restarts, is then not counted again and again.
  */
-#define MODEL_PROTOTXT_FILE "models/mobilenet_ssd/MobileNetSSD_deploy.prototxt"
+#define CROSSING_MARGIN_FRACTION 0.1
 
 /**
- * The path to the .caffemodel file containing the learned network stored in Caffe framework's format.
+ * The number of consecutive detection frames an object may go unmatched before it is dropped.
+ * Keeps the identifier and state of a person the detector misses once, for example while briefly occluded.
  */
-#define MODEL_CAFFEMODEL_FILE "models/mobilenet_ssd/MobileNetSSD_deploy.caffemodel"
-
-/**
- * The class ID for a detected person as returned by the neural network.
- */
-#define PERSON_CLASS_ID 15
-
-/**
- * The minimum confidence level required for a detection by the neural network to be considered.
- */
-#define MIN_CONFIDENCE_LEVEL 0.4
+#define MAX_MISSED_DETECTIONS 1
 
 /**
  * @brief Class that tracks people as they enter/exit.
@@ -48,6 +56,7 @@ class ObjectTracker : public QObject {
         /**
          * Enumeration used to specify the direction people must walk to enter.
          * In other words, which side of the video ihe enterance is towards.
+         * Only used when no counting lines are set, people are then counted across the center of the region.
          */
         enum EnterDirection {
             Up, Down, Left, Right
@@ -63,21 +72,88 @@ class ObjectTracker : public QObject {
             DrawCentroids     = 0x02,
             // Draw lines to indicate the inside/outside thresholds
             DrawThresholds    = 0x04,
-            // Display the inside/outside state of objects
+            // Display the identifier and inside/outside state of objects
             ShowStates        = 0x08,
             // Display the current frame number
             ShowFrameNumber   = 0x10,
-            // Display the current frame's tracking status (Waiting, Detecting, Tracking)
-            ShowFrameStatus   = 0x20
+            // Display the current frame's tracking status (Waiting, Queued, Detecting, Tracking, Idle)
+            ShowFrameStatus   = 0x20,
+            // Draw the recent trajectories of tracked objects
+            DrawTrajectories  = 0x40
         };
 
         Q_DECLARE_FLAGS(DrawFlags, DrawFlag)
         Q_FLAG(DrawFlags)
 
+        /**
+         * Enumeration used to specify how detection frames are handled.
+         */
+        enum DetectionMode {
+            // Block on the neural network during detection frames
+            SynchronousDetection,
+            // Detect on a snapshot in the background while tracking continues, reconciling once detection finishes
+            AsynchronousDetection
+        };
+
+        /**
+         * Enumeration used to specify what happens to a frame once it has been processed.
+         */
+        enum RenderMode {
+            // Draw on the frame and convert it here, then emit frameProcessed
+            InlineRendering,
+            // Emit frameTracked and leave drawing and conversion to a FrameRenderer
+            DeferredRendering,
+            // Only track and count, nothing is drawn or emitted (headless processing)
+            NoRendering
+        };
+
+        /**
+         * Snapshot of a tracked object taken after a frame was processed.
+         * Coordinates are relative to the region of interest the frame was processed in.
+         */
+        struct ObjectSnapshot {
+            int id;
+            cv::Rect bbox;
+            cv::Point position;
+            std::string state;
+            // The recent positions of the object, latest first. Only filled when trajectories are drawn
+            std::vector<cv::Point> trajectory;
+        };
+
+        /**
+         * The time spent updating tracked objects on frames with a given number of objects.
+         */
+        struct TrackingTime {
+            unsigned long long frames;
+            // The total and longest time spent, in milliseconds
+            double total;
+            double longest;
+        };
+
+        /**
+         * Everything needed to render a processed frame, independent of the tracker's later state.
+         * Lets overlay rendering run on another thread while the tracker moves on to the next frame.
+         */
+        struct TrackedFrame {
+            FrameHandle frame;
+            unsigned int frameNumber;
+            cv::Rect regionOfInterest;
+            QString status;
+            int detectionInterval;
+            // The step of the degradation ladder the frame was processed at
+            BudgetGovernor::Level degradation;
+            std::vector<ObjectSnapshot> objects;
+            // The lines people were counted across, shared with the tracker until they change
+            std::shared_ptr<const CountingLines> countingLines;
+            DrawFlags drawFlags;
+        };
+
         ObjectTracker(QObject *parent = 0);
 
         ~ObjectTracker();
 
+        bool loadSettings();
+
         DrawFlags getDrawFlags() const;
 
         void setDrawFlags(const DrawFlags flags);
@@ -86,35 +162,280 @@ class ObjectTracker : public QObject {
 
         void setEnterDirection(const EnterDirection direction);
 
+        std::vector<CountingLines::Line> getCountingLines() const;
+
+        void setCountingLines(const std::vector<CountingLines::Line>& lines);
+
+        static CountingLines::Line getDefaultLine(const EnterDirection direction);
+
+        cv::Size getInputSize() const;
+
+        void setInputSize(const cv::Size size);
+
+        PersonDetector::Options getDetectorOptions() const;
+
+        PersonDetector::Backend getDetectorBackend() const;
+
+        void setDetectorBackend(const PersonDetector::Backend backend);
+
+        bool isQuantizedDetector() const;
+
+        void setQuantizedDetector(const bool quantized);
+
+        bool resolveDetector();
+
+        int getDnnBackend() const;
+
+        int getDnnTarget() const;
+
+        bool setDnnPreference(const int dnnBackend, const int dnnTarget);
+
+        int getDetectorThreads() const;
+
+        void setDetectorThreads(const int threads);
+
+        PersonDetector::Tiling getTiling() const;
+
+        void setTiling(const PersonDetector::Tiling& tiling);
+
+        DetectionMode getDetectionMode() const;
+
+        void setDetectionMode(const DetectionMode mode);
+
+        bool isAdaptiveDetection() const;
+
+        void setAdaptiveDetection(const bool adaptive);
+
+        int getDetectionInterval() const;
+
+        bool isMotionGating() const;
+
+        void setMotionGating(const bool gating);
+
+        TrackedObject::Algorithm getTrackerAlgorithm() const;
+
+        void setTrackerAlgorithm(const TrackedObject::Algorithm algorithm);
+
+        bool isGrayTracking() const;
+
+        void setGrayTracking(const bool gray);
+
+        TrackAssociator::Method getAssociationMethod() const;
+
+        void setAssociationMethod(const TrackAssociator::Method method);
+
+        bool isPredictiveTracking() const;
+
+        void setPredictiveTracking(const bool predictive);
+
+        bool isParallelTracking() const;
+
+        void setParallelTracking(const bool parallel);
+
+        bool isStaggeredDetection() const;
+
+        void setStaggeredDetection(const bool staggered);
+
+        std::vector<TrackingTime> getTrackingTimes() const;
+
+        void resetTrackingTimes();
+
+        unsigned long long getRunFrameCount() const;
+
+        unsigned long long getSkippedFrameCount() const;
+
+        cv::Rect getRegionOfInterest() const;
+
+        void setRegionOfInterest(const cv::Rect region);
+
+        InferenceService *getInferenceService() const;
+
+        void setInferenceService(InferenceService *service);
+
+        BudgetGovernor::Budget getBudget() const;
+
+        void setBudget(const BudgetGovernor::Budget& budget);
+
+        BudgetGovernor::Level getDegradationLevel() const;
+
+        unsigned long long getDegradationStepCount() const;
+
+        unsigned long long getBudgetSkippedFrameCount() const;
+
+        RenderMode getRenderMode() const;
+
+        void setRenderMode(const RenderMode mode);
+
     public slots:
-        void processFrame(cv::Mat frame);
+        void processFrame(FrameHandle handle);
 
         void reset();
 
     signals:
         void frameProcessed(QImage image);
 
-        void personEntered();
+        void frameTracked(ObjectTracker::TrackedFrame trackedFrame);
+
+        void frameFinished();
+
+        void detectionRequested(cv::Mat frame, unsigned int request, int inputWidth, int inputHeight, PersonDetector::Options options, PersonDetector::Tiling tiling);
+
+        void personEntered(QString line);
 
-        void personExited();
+        void personExited(QString line);
+
+        void degradationChanged(int level);
+
+    private slots:
+        void applyDetections(std::vector<cv::Rect> boxes, unsigned int request);
 
     private:
+        void restart();
+
+        bool requestDetection(const cv::Mat& frame, const cv::Size inputSize, const PersonDetector::Options& options, const PersonDetector::Tiling& tiling);
+
+        bool acquireDetectionSlot(const bool due);
+
+        void releaseDetectionSlot();
+
+        void detectionStarted();
+
+        void associate(const FramePyramid& pyramid, const std::vector<cv::Rect>& boxes, const TrackAssociator::Method method,
+                       const TrackedObject::Algorithm algorithm, const bool gray);
+
+        void recordTrackingTime(const int count, const double time);
+
+        /**
+         * The detector used during synchronous detection frames, acquired from the ModelRegistry on the first
+         * detection frame and exchanged when the detector options change.
+         */
+        std::unique_ptr<PersonDetector> detector;
+
+        /**
+         * Decides which frames are detection frames.
+         */
+        DetectionScheduler scheduler;
+
+        /**
+         * The identifier of this tracker in the process-wide DetectionSlots schedule.
+         */
+        int slotClient;
+
+        /**
+         * The number of detection slots this tracker holds. A detection dropped by a restart holds its slot until its result arrives.
+         */
+        int heldSlots;
+
+        /**
+         * Whether this tracker was refused a slot and waits for its turn.
+         */
+        bool slotRequested;
+
+        /**
+         * Whether the schedule still has to be shifted by this tracker's phase, after its first detection since a restart.
+         */
+        bool phasePending;
+
         /**
-         * The neural network used to detect objects in a frame.
+         * The scheduler's current interval, readable from any thread.
          */
-        cv::dnn::Net net;
+        QAtomicInt detectionInterval;
 
         /**
-         * The names of layers in the neural network with unconnected outputs.
-         * Forward passes are run to compute outputs of these layers.
+         * Degrades the work done per frame while it exceeds the budget, if the budget is enabled.
          */
-        std::vector<cv::String> layers;
+        BudgetGovernor governor;
+
+        /**
+         * The governor's current step and counters, readable from any thread.
+         */
+        QAtomicInt degradationLevel;
+        QAtomicInteger<quint64> degradationSteps;
+        QAtomicInteger<quint64> budgetSkippedFrames;
+
+        /**
+         * Skips detection and tracking on frames without motion, if motion gating is enabled.
+         */
+        MotionGate motionGate;
+
+        /**
+         * Whether the previous frame was skipped for lack of motion.
+         */
+        bool idle;
+
+        /**
+         * The region the previous frame was processed in, clipped to the frame. Object coordinates are relative to it.
+         */
+        cv::Rect activeRegion;
+
+        /**
+         * The counting lines the previous frame was processed with, in pixels of the active region.
+         * Replaced rather than modified, frames being rendered may still hold the previous ones.
+         */
+        std::shared_ptr<const CountingLines> activeLines;
+
+        /**
+         * The lines set when the active lines were built, the default line if none were set.
+         */
+        std::vector<CountingLines::Line> activeLineSettings;
+
+        /**
+         * The version of the counting line settings the active lines were built from.
+         */
+        unsigned int activeLinesVersion;
+
+        /**
+         * Buffers receiving the crossings of each object's latest movement, reused for every object.
+         */
+        std::vector<int> segmentCrossings;
+        std::vector<int> lineCrossings;
+
+        /**
+         * The worker running background detection, created the first time asynchronous detection is used.
+         */
+        DetectionWorker *detectionWorker;
+
+        /**
+         * The thread the detection worker runs on.
+         */
+        QThread detectionThread;
+
+        /**
+         * The shared service background detections are submitted to instead of the worker, if set.
+         */
+        QPointer<InferenceService> inferenceService;
+
+        /**
+         * Copy of the frame being detected in the background. Left untouched until the result arrives.
+         */
+        cv::Mat snapshot;
+
+        /**
+         * Whether a background detection is in progress. Only one is in progress at a time.
+         */
+        bool detectionPending;
+
+        /**
+         * Identifies the latest background detection request, so results requested before a reset are ignored.
+         */
+        unsigned int detectionRequest;
+
+        /**
+         * The pyramids of the previous and current tracked frames, shared by every object updated in between.
+         */
+        FramePyramid previousPyramid;
+        FramePyramid currentPyramid;
 
         /**
          * List of currently tracked objects.
          */
         std::vector<TrackedObject> objects;
 
+        /**
+         * The identifier given to the next new object.
+         */
+        int nextObjectId;
+
         /**
          * The current frame number. Used to alternate between object detection and tracking.
          */
@@ -125,12 +446,114 @@ class ObjectTracker : public QObject {
          */
         EnterDirection enterDirection;
 
+        /**
+         * The lines and zones people are counted across, in fractions of the region of interest.
+         */
+        std::vector<CountingLines::Line> countingLines;
+
+        /**
+         * Incremented whenever the counting lines or the enter direction change.
+         */
+        unsigned int countingLinesVersion;
+
         /**
          * Flags used to control what visual elements should be drawn on processed frames.
          */
         DrawFlags drawFlags;
+
+        /**
+         * The size frames are resized to before being passed to the neural network.
+         */
+        cv::Size inputSize;
+
+        /**
+         * The inference engine detectors run on and the network they load.
+         */
+        PersonDetector::Options detectorOptions;
+
+        /**
+         * How the region of interest is split into tiles for detection.
+         */
+        PersonDetector::Tiling tiling;
+
+        /**
+         * Whether detection blocks processing or runs in the background.
+         */
+        DetectionMode detectionMode;
+
+        /**
+         * Whether the detection interval adapts to the scene.
+         */
+        bool adaptiveDetection;
+
+        /**
+         * Whether frames without motion skip detection and tracking.
+         */
+        bool motionGating;
+
+        /**
+         * The algorithm following objects between detections.
+         */
+        TrackedObject::Algorithm trackerAlgorithm;
+
+        /**
+         * Whether every tracker reads the shared grayscale frame, even those able to read color.
+         */
+        bool grayTracking;
+
+        /**
+         * How detections are matched with the currently tracked objects.
+         */
+        TrackAssociator::Method associationMethod;
+
+        /**
+         * Whether well-conditioned objects are moved by their motion prediction instead of the tracker.
+         */
+        bool predictiveTracking;
+
+        /**
+         * Whether the objects of a frame are updated in parallel on the shared tracking pool.
+         */
+        bool parallelTracking;
+
+        /**
+         * Whether detections are shifted by this tracker's phase, so trackers started together detect on different frames.
+         */
+        bool staggeredDetection;
+
+        /**
+         * Guards the tracking times, they are read from other threads.
+         */
+        mutable QMutex timesMutex;
+
+        /**
+         * The time spent updating objects, indexed by the number of objects in the frame.
+         */
+        std::vector<TrackingTime> trackingTimes;
+
+        /**
+         * The part of each frame that is processed, empty for the whole frame.
+         */
+        cv::Rect regionOfInterest;
+
+        /**
+         * Whether processed frames are rendered here, handed on for rendering elsewhere or not rendered at all.
+         */
+        RenderMode renderMode;
+
+        /**
+         * The CPU budget the governor keeps processing within.
+         */
+        BudgetGovernor::Budget budget;
+
+        /**
+         * Guards the settings above, which may be changed from the GUI thread while frames are processed on a worker thread.
+         */
+        mutable QMutex settingsMutex;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(ObjectTracker::DrawFlags)
 
+Q_DECLARE_METATYPE(ObjectTracker::TrackedFrame)
+
 #endif // OBJECTTRACKER_H
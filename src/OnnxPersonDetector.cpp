@@ -0,0 +1,81 @@
+/**
+ * @file OnnxPersonDetector.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Detects people in a frame using ONNX Runtime on the CPU
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "OnnxPersonDetector.h"
+#include "ModelRegistry.h"
+
+#ifdef HAVE_ONNXRUNTIME
+
+#include <array>
+
+/**
+ * @brief Constructs a new OnnxPersonDetector object, creating the session from the model held by the ModelRegistry.
+ * @param options the options the detector is created with.
+ */
+OnnxPersonDetector::OnnxPersonDetector(const PersonDetector::Options& options) : PersonDetector(options) {
+    Ort::SessionOptions sessionOptions;
+    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+    // Each session has its own thread pool, so the cap applies to this detector alone
+    if (options.threads > 0) {
+        sessionOptions.SetIntraOpNumThreads(options.threads);
+        sessionOptions.SetInterOpNumThreads(1);
+    }
+
+    const ModelRegistry::Model& model = ModelRegistry::instance().getModel(options);
+    session.reset(new Ort::Session(getEnvironment(), model.weights.data(), model.weights.size(), sessionOptions));
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    inputName = session->GetInputNameAllocated(0, allocator).get();
+    outputName = session->GetOutputNameAllocated(0, allocator).get();
+}
+
+/**
+ * @brief Destructs an OnnxPersonDetector object.
+ */
+OnnxPersonDetector::~OnnxPersonDetector() {
+
+}
+
+/**
+ * @brief Detects the people in the given frame.
+ * @param frame the 8-bit, 3-channel BGR frame to detect people in.
+ * @param confidences if not null, receives the confidence of each box.
+ * @return the bounding boxes of the detected people, in frame coordinates.
+ */
+std::vector<cv::Rect> OnnxPersonDetector::detect(const cv::Mat& frame, std::vector<float> *confidences) {
+    // Create a 4D blob from the frame at the network's input size, reusing the previous blob's memory
+    const cv::Mat& blob = preprocessor.process(frame);
+
+    // Wrap the blob in a tensor without copying it
+    static const Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    const std::array<int64_t, 4> shape = { 1, 3, blob.size[2], blob.size[3] };
+
+    Ort::Value input = Ort::Value::CreateTensor<float>(memoryInfo, (float *) blob.data, blob.total(), shape.data(), shape.size());
+
+    const char *inputNames[] = { inputName.c_str() };
+    const char *outputNames[] = { outputName.c_str() };
+
+    auto output = session->Run(Ort::RunOptions{ nullptr }, inputNames, &input, 1, outputNames, 1);
+
+    std::vector<cv::Rect> boxes;
+    collectPeople(output[0].GetTensorData<float>(), output[0].GetTensorTypeAndShapeInfo().GetElementCount(), frame.size(), boxes, confidences);
+
+    return boxes;
+}
+
+/**
+ * @brief Returns the ONNX Runtime environment shared by every detector in the process.
+ * @return the shared environment.
+ */
+Ort::Env& OnnxPersonDetector::getEnvironment() {
+    static Ort::Env environment(ORT_LOGGING_LEVEL_WARNING, "headcount");
+    return environment;
+}
+
+#endif // HAVE_ONNXRUNTIME
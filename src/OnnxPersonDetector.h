@@ -0,0 +1,59 @@
+/**
+ * @file OnnxPersonDetector.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Detects people in a frame using ONNX Runtime on the CPU
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef ONNXPERSONDETECTOR_H
+#define ONNXPERSONDETECTOR_H
+
+#ifdef HAVE_ONNXRUNTIME
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+#include "PersonDetector.h"
+
+/**
+ * The path to the .onnx file containing the network, exported from the MobileNet-SSD or any detector with the same input and output layout.
+ * The MobileNet-SSD is exported by models/mobilenet_ssd/export_onnx.py, see the README.
+ */
+#define MODEL_ONNX_FILE "models/mobilenet_ssd/MobileNetSSD_deploy.onnx"
+
+/**
+ * @brief Class that detects people in a frame with a network running on ONNX Runtime's CPU execution provider.
+ * The network takes a single 1x3xHxW float input and produces an SSD-style Nx7 detection output.
+ * The quantized network is loaded from MODEL_QUANTIZED_ONNX_FILE instead.
+ */
+class OnnxPersonDetector : public PersonDetector {
+    public:
+        OnnxPersonDetector(const Options& options = Options());
+
+        ~OnnxPersonDetector();
+
+        std::vector<cv::Rect> detect(const cv::Mat& frame, std::vector<float> *confidences = nullptr) override;
+
+        static Ort::Env& getEnvironment();
+
+    private:
+        /**
+         * The inference session holding the loaded network.
+         */
+        std::unique_ptr<Ort::Session> session;
+
+        /**
+         * The names of the network's input and output.
+         */
+        std::string inputName;
+        std::string outputName;
+};
+
+#endif // HAVE_ONNXRUNTIME
+
+#endif // ONNXPERSONDETECTOR_H
@@ -0,0 +1,496 @@
+/**
+ * @file PersonDetector.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Interface of detectors finding people in a frame using a neural network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "PersonDetector.h"
+#include "DnnPersonDetector.h"
+#include "OnnxPersonDetector.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <QThread>
+
+/**
+ * @brief Returns whether two sets of options load and run the same network.
+ * The thread cap is only compared for ONNX Runtime, the only backend that applies it per detector.
+ * @param other the options to compare with.
+ * @return true if the options are equal.
+ */
+bool PersonDetector::Options::operator==(const PersonDetector::Options& other) const {
+    return backend == other.backend && quantized == other.quantized && dnnBackend == other.dnnBackend
+           && dnnTarget == other.dnnTarget && (backend != OnnxRuntimeBackend || threads == other.threads);
+}
+
+/**
+ * @brief Returns whether two sets of options differ.
+ * @param other the options to compare with.
+ * @return true if the options differ.
+ */
+bool PersonDetector::Options::operator!=(const PersonDetector::Options& other) const {
+    return !(*this == other);
+}
+
+/**
+ * @brief Returns the number of tiles a frame is split into.
+ * @return the number of tiles.
+ */
+int PersonDetector::Tiling::getCount() const {
+    return columns * rows;
+}
+
+/**
+ * @brief Returns whether two tilings split frames the same way.
+ * @param other the tiling to compare with.
+ * @return true if the tilings are equal.
+ */
+bool PersonDetector::Tiling::operator==(const PersonDetector::Tiling& other) const {
+    return columns == other.columns && rows == other.rows && overlap == other.overlap;
+}
+
+/**
+ * @brief Returns whether two tilings differ.
+ * @param other the tiling to compare with.
+ * @return true if the tilings differ.
+ */
+bool PersonDetector::Tiling::operator!=(const PersonDetector::Tiling& other) const {
+    return !(*this == other);
+}
+
+/**
+ * @brief Constructs a new PersonDetector object.
+ * @param options the options the detector is created with.
+ */
+PersonDetector::PersonDetector(const PersonDetector::Options& options) {
+    this->options = options;
+    failureReported = false;
+}
+
+/**
+ * @brief Destructs a PersonDetector object.
+ */
+PersonDetector::~PersonDetector() {
+
+}
+
+/**
+ * @brief Creates a detector with the given options, loading its network from disk.
+ * Falls back to the OpenCV backend if the requested one is not available in this build.
+ * @param options the backend to run the network on and the network to load.
+ * @return the new detector.
+ */
+std::unique_ptr<PersonDetector> PersonDetector::create(const PersonDetector::Options& options) {
+    if (!isAvailable(options.backend)) {
+        std::cerr << getBackendName(options.backend).toStdString() << " is not available, falling back to "
+                  << getBackendName(Backend::OpenCvBackend).toStdString() << std::endl;
+
+        Options fallback = options;
+        fallback.backend = Backend::OpenCvBackend;
+
+        return create(fallback);
+    }
+
+    switch (options.backend) {
+#ifdef HAVE_ONNXRUNTIME
+        case Backend::OnnxRuntimeBackend:
+            return std::unique_ptr<PersonDetector>(new OnnxPersonDetector(options));
+#endif
+        default:
+            return std::unique_ptr<PersonDetector>(new DnnPersonDetector(options));
+    }
+}
+
+/**
+ * @brief Returns whether the given backend is available in this build.
+ * @param backend the backend to check.
+ * @return true if detectors can be created for the backend.
+ */
+bool PersonDetector::isAvailable(const PersonDetector::Backend backend) {
+    switch (backend) {
+        case Backend::OpenCvBackend:
+            return true;
+        case Backend::OnnxRuntimeBackend:
+#ifdef HAVE_ONNXRUNTIME
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Caps the threads of OpenCV's parallel loops. The count is shared by the whole process, it applies to the
+ * forward passes of every OpenCV detector as well as to resizing, color conversion and the trackers, so it is set
+ * once at startup rather than by each detector.
+ * @param threads the thread cap, clamped to the number of cores, zero to keep OpenCV's default.
+ */
+void PersonDetector::setOpenCvThreads(const int threads) {
+    if (threads > 0) {
+        cv::setNumThreads(std::min(threads, QThread::idealThreadCount()));
+    }
+}
+
+/**
+ * @brief Returns a human readable name of the given backend.
+ * @param backend the backend to name.
+ * @return the name of the backend.
+ */
+QString PersonDetector::getBackendName(const PersonDetector::Backend backend) {
+    switch (backend) {
+        case Backend::OpenCvBackend:
+            return "OpenCV DNN";
+        case Backend::OnnxRuntimeBackend:
+            return "ONNX Runtime (CPU)";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief Returns whether OpenCV's dnn module can run networks with the given backend on the given target in this build.
+ * @param dnnBackend the cv::dnn::Backend to check.
+ * @param dnnTarget the cv::dnn::Target to check.
+ * @return true if the combination is available.
+ */
+bool PersonDetector::isDnnPreferenceAvailable(const int dnnBackend, const int dnnTarget) {
+    const auto targets = getAvailableDnnTargets(dnnBackend);
+    return std::find(targets.begin(), targets.end(), dnnTarget) != targets.end();
+}
+
+/**
+ * @brief Returns the backends of OpenCV's dnn module available in this build, starting with the default one.
+ * @return the available cv::dnn::Backend values.
+ */
+std::vector<int> PersonDetector::getAvailableDnnBackends() {
+    std::vector<int> backends = { cv::dnn::DNN_BACKEND_DEFAULT };
+
+    for (const auto& available : cv::dnn::getAvailableBackends()) {
+        if (std::find(backends.begin(), backends.end(), available.first) == backends.end()) {
+            backends.push_back(available.first);
+        }
+    }
+
+    return backends;
+}
+
+/**
+ * @brief Returns the targets the given backend of OpenCV's dnn module can run on in this build.
+ * @param dnnBackend the cv::dnn::Backend to list the targets of.
+ * @return the available cv::dnn::Target values.
+ */
+std::vector<int> PersonDetector::getAvailableDnnTargets(const int dnnBackend) {
+    std::vector<int> targets;
+
+    for (const auto target : cv::dnn::getAvailableTargets(static_cast<cv::dnn::Backend>(dnnBackend))) {
+        targets.push_back(target);
+    }
+
+    return targets;
+}
+
+/**
+ * @brief Returns a human readable name of the given backend of OpenCV's dnn module.
+ * @param dnnBackend the cv::dnn::Backend to name.
+ * @return the name of the backend.
+ */
+QString PersonDetector::getDnnBackendName(const int dnnBackend) {
+    switch (dnnBackend) {
+        case cv::dnn::DNN_BACKEND_DEFAULT:
+            return "Default";
+        case cv::dnn::DNN_BACKEND_OPENCV:
+            return "OpenCV";
+        case cv::dnn::DNN_BACKEND_INFERENCE_ENGINE:
+        case DNN_BACKEND_OPENVINO:
+            return "OpenVINO";
+        case cv::dnn::DNN_BACKEND_HALIDE:
+            return "Halide";
+        case cv::dnn::DNN_BACKEND_VKCOM:
+            return "Vulkan";
+        case cv::dnn::DNN_BACKEND_CUDA:
+            return "CUDA";
+        default:
+            return QString("Backend %1").arg(dnnBackend);
+    }
+}
+
+/**
+ * @brief Returns a human readable name of the given target of OpenCV's dnn module.
+ * @param dnnTarget the cv::dnn::Target to name.
+ * @return the name of the target.
+ */
+QString PersonDetector::getDnnTargetName(const int dnnTarget) {
+    switch (dnnTarget) {
+        case cv::dnn::DNN_TARGET_CPU:
+            return "CPU";
+        case cv::dnn::DNN_TARGET_OPENCL:
+            return "OpenCL";
+        case cv::dnn::DNN_TARGET_OPENCL_FP16:
+            return "OpenCL (FP16)";
+        case cv::dnn::DNN_TARGET_MYRIAD:
+            return "Myriad";
+        case cv::dnn::DNN_TARGET_VULKAN:
+            return "Vulkan";
+        case cv::dnn::DNN_TARGET_FPGA:
+            return "FPGA";
+        case cv::dnn::DNN_TARGET_CUDA:
+            return "CUDA";
+        case cv::dnn::DNN_TARGET_CUDA_FP16:
+            return "CUDA (FP16)";
+        default:
+            return QString("Target %1").arg(dnnTarget);
+    }
+}
+
+/**
+ * @brief Returns the options the detector was created with.
+ * @return the detector's options.
+ */
+const PersonDetector::Options& PersonDetector::getOptions() const {
+    return options;
+}
+
+/**
+ * @brief Returns the input size of the network.
+ * @return the size frames are resized to before detection.
+ */
+cv::Size PersonDetector::getInputSize() const {
+    return preprocessor.getInputSize();
+}
+
+/**
+ * @brief Sets the input size of the network.
+ * @param size the size frames are resized to before detection.
+ */
+void PersonDetector::setInputSize(const cv::Size size) {
+    preprocessor.setInputSize(size);
+}
+
+/**
+ * @brief Detects the people in each of the given frames.
+ * Implementations able to run a whole batch in one forward pass override this, the default detects frame by frame.
+ * @param frames the 8-bit, 3-channel BGR frames to detect people in.
+ * @param confidences if not null, receives for each frame the confidence of each of its boxes.
+ * @return for each frame, the bounding boxes of the detected people, in frame coordinates.
+ */
+std::vector<std::vector<cv::Rect>> PersonDetector::detectBatch(const std::vector<cv::Mat>& frames, std::vector<std::vector<float>> *confidences) {
+    std::vector<std::vector<cv::Rect>> results;
+    results.reserve(frames.size());
+
+    if (confidences) {
+        confidences->assign(frames.size(), std::vector<float>());
+    }
+
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        results.push_back(detect(frames[i], confidences ? &(*confidences)[i] : nullptr));
+    }
+
+    return results;
+}
+
+/**
+ * @brief Detects the people in the given frame, split into overlapping tiles detected as one batch.
+ * Each tile is scaled to the network's input size on its own, so small people keep more pixels than
+ * when the whole frame is shrunk at once.
+ * @param frame the 8-bit, 3-channel BGR frame to detect people in.
+ * @param tiling how the frame is split into tiles.
+ * @return the bounding boxes of the detected people, merged across tile seams, in frame coordinates.
+ */
+std::vector<cv::Rect> PersonDetector::detectTiled(const cv::Mat& frame, const PersonDetector::Tiling& tiling) {
+    if (tiling.getCount() <= 1) {
+        return detect(frame);
+    }
+
+    const auto tiles = getTiles(frame.size(), tiling);
+
+    std::vector<cv::Mat> frames;
+    frames.reserve(tiles.size());
+
+    // Tiles are views into the frame, the pixels are only copied into the blob
+    for (const auto& tile : tiles) {
+        frames.push_back(frame(tile));
+    }
+
+    std::vector<std::vector<float>> confidences;
+    const auto detections = detectBatch(frames, &confidences);
+
+    return mergeTiles(tiles, detections, confidences);
+}
+
+/**
+ * @brief Logs a forward pass that threw, once per detector. Callers answer the detection with no boxes, so a
+ * network rejecting an input size or batch costs detections rather than the process.
+ * @param e the exception thrown by the forward pass.
+ */
+void PersonDetector::reportFailure(const std::exception& e) {
+    if (failureReported) {
+        return;
+    }
+
+    failureReported = true;
+
+    std::cerr << "Detection failed on the " << getBackendName(options.backend).toStdString()
+              << (options.quantized ? " INT8" : " FP32") << " model, answering with no detections: " << e.what() << std::endl;
+}
+
+/**
+ * @brief Splits a frame into overlapping tiles of equal size covering the whole frame.
+ * @param frameSize the size of the frame to split.
+ * @param tiling how the frame is split, the number of tiles is clamped so every tile is at least one pixel.
+ * @return the tiles in row-major order, a single tile covering the frame if it is not split.
+ */
+std::vector<cv::Rect> PersonDetector::getTiles(const cv::Size frameSize, const PersonDetector::Tiling& tiling) {
+    const int columns = std::max(1, std::min(tiling.columns, frameSize.width));
+    const int rows = std::max(1, std::min(tiling.rows, frameSize.height));
+    const double overlap = std::max(0.0, std::min(tiling.overlap, MAX_TILE_OVERLAP));
+
+    // n tiles of size s overlapping by o * s cover n * s - (n - 1) * o * s pixels
+    const int width = std::min(frameSize.width, cvCeil(frameSize.width / (columns - (columns - 1) * overlap)));
+    const int height = std::min(frameSize.height, cvCeil(frameSize.height / (rows - (rows - 1) * overlap)));
+
+    std::vector<cv::Rect> tiles;
+    tiles.reserve(columns * rows);
+
+    for (int row = 0; row < rows; row++) {
+        // Spread the tiles evenly so the last one ends exactly at the frame's border
+        const int y = rows > 1 ? row * (frameSize.height - height) / (rows - 1) : 0;
+
+        for (int column = 0; column < columns; column++) {
+            const int x = columns > 1 ? column * (frameSize.width - width) / (columns - 1) : 0;
+            tiles.push_back(cv::Rect(x, y, width, height));
+        }
+    }
+
+    return tiles;
+}
+
+/**
+ * @brief Merges the detections made in overlapping tiles into one set of boxes in frame coordinates.
+ * Boxes are suppressed greedily, most confident first: a box is dropped if it overlaps a kept box found in another
+ * tile by more than TILE_MERGE_THRESHOLD. Boxes of the same tile were already suppressed by the network, so two
+ * people standing close together in one tile are both kept.
+ * @param tiles the tiles, in frame coordinates.
+ * @param detections the boxes detected in each tile, in tile coordinates.
+ * @param confidences the confidence of each box detected in each tile.
+ * @return the merged boxes, in frame coordinates.
+ */
+std::vector<cv::Rect> PersonDetector::mergeTiles(const std::vector<cv::Rect>& tiles, const std::vector<std::vector<cv::Rect>>& detections,
+                                                 const std::vector<std::vector<float>>& confidences) {
+    // A single tile has no seams, its boxes were already suppressed by the network
+    if (tiles.size() == 1 && detections.size() == 1) {
+        std::vector<cv::Rect> boxes = detections.front();
+
+        for (auto& box : boxes) {
+            box += tiles.front().tl();
+        }
+
+        return boxes;
+    }
+
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<std::size_t> origins;
+
+    for (std::size_t i = 0; i < tiles.size() && i < detections.size(); i++) {
+        for (std::size_t j = 0; j < detections[i].size(); j++) {
+            if (!detections[i][j].empty()) {
+                boxes.push_back(detections[i][j] + tiles[i].tl());
+                scores.push_back(i < confidences.size() && j < confidences[i].size() ? confidences[i][j] : 0.0f);
+                origins.push_back(i);
+            }
+        }
+    }
+
+    std::vector<std::size_t> order(boxes.size());
+
+    for (std::size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+
+    // Equal scores keep the tile order, so merging is deterministic
+    std::stable_sort(order.begin(), order.end(), [&scores](const std::size_t a, const std::size_t b) {
+        return scores[a] > scores[b];
+    });
+
+    std::vector<std::size_t> kept;
+    std::vector<cv::Rect> merged;
+
+    for (const auto index : order) {
+        bool duplicate = false;
+
+        for (const auto other : kept) {
+            if (origins[other] == origins[index]) {
+                continue;
+            }
+
+            const double intersection = (boxes[index] & boxes[other]).area();
+            const double overlap = intersection / (boxes[index].area() + boxes[other].area() - intersection);
+
+            if (overlap > TILE_MERGE_THRESHOLD) {
+                duplicate = true;
+                break;
+            }
+        }
+
+        if (!duplicate) {
+            kept.push_back(index);
+            merged.push_back(boxes[index]);
+        }
+    }
+
+    return merged;
+}
+
+/**
+ * @brief Collects the confident person detections from a network's output.
+ * The output holds one detection every 7 values [batchId, classId, confidence, left, top, right, bottom],
+ * with coordinates relative to the frame's size.
+ * @param data the network's output.
+ * @param total the number of values in the output.
+ * @param frameSize the size of the frame detections were made in.
+ * @param boxes receives the bounding boxes of the detected people, in frame coordinates.
+ * @param confidences if not null, receives the confidence of each box.
+ * @param batchIndex the index of the frame in the batch, detections of other frames are skipped.
+ */
+void PersonDetector::collectPeople(const float *data, const std::size_t total, const cv::Size frameSize, std::vector<cv::Rect>& boxes,
+                                   std::vector<float> *confidences, const int batchIndex) {
+    // Get the number of rows (height) and columns (width) in the frame
+    const int rows = frameSize.height;
+    const int cols = frameSize.width;
+
+    for (std::size_t i = 0; i + 7 <= total; i += 7) {
+        // Ignore detections belonging to other frames of the batch
+        if ((int) data[i] != batchIndex) {
+            continue;
+        }
+
+        const float confidence = data[i + 2];
+
+        // Ignore weak detections that do not satisfy the minimum confidence level
+        if (confidence >= MIN_CONFIDENCE_LEVEL) {
+            const int classId = (int) data[i + 1];
+
+            // Ignore detections which are not of class "person"
+            if (classId != PERSON_CLASS_ID) {
+                continue;
+            }
+
+            // Calculate the bounding box for the object
+            const int x = (int) (data[i + 3] * cols);
+            const int y = (int) (data[i + 4] * rows);
+            const int w = (int) (data[i + 5] * cols) - x;
+            const int h = (int) (data[i + 6] * rows) - y;
+
+            boxes.push_back(cv::Rect(x, y, w, h));
+
+            if (confidences) {
+                confidences->push_back(confidence);
+            }
+        }
+    }
+}
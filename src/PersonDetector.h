@@ -0,0 +1,185 @@
+/**
+ * @file PersonDetector.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Interface of detectors finding people in a frame using a neural network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef PERSONDETECTOR_H
+#define PERSONDETECTOR_H
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include <QMetaType>
+#include <QString>
+
+#include <opencv2/opencv.hpp>
+
+#include "Preprocessor.h"
+
+/**
+ * The class ID for a detected person as returned by the neural network.
+ */
+#define PERSON_CLASS_ID 15
+
+/**
+ * The minimum confidence level required for a detection by the neural network to be considered.
+ */
+#define MIN_CONFIDENCE_LEVEL 0.4
+
+/**
+ * The path to the .onnx file containing the INT8-quantized network, with the same input and output layout as the full precision one.
+ * Exported and quantized by models/mobilenet_ssd/export_onnx.py, see the README.
+ */
+#define MODEL_QUANTIZED_ONNX_FILE "models/mobilenet_ssd/MobileNetSSD_deploy_int8.onnx"
+
+/**
+ * OpenCV's identifier of its OpenVINO (nGraph) backend, returned by cv::dnn::getAvailableBackends() but not part of the public enum.
+ */
+#define DNN_BACKEND_OPENVINO 1000000
+
+/**
+ * The default overlap between neighbouring tiles, as a fraction of the tile size.
+ * Large enough for a distant person cut by one seam to appear whole in the neighbouring tile.
+ */
+#define DEFAULT_TILE_OVERLAP 0.2
+
+/**
+ * The maximum overlap between neighbouring tiles, as a fraction of the tile size.
+ */
+#define MAX_TILE_OVERLAP 0.5
+
+/**
+ * The maximum number of tiles along each axis of a frame.
+ */
+#define MAX_TILES_PER_AXIS 4
+
+/**
+ * The intersection over union above which two boxes found in different tiles are merged into one.
+ */
+#define TILE_MERGE_THRESHOLD 0.4
+
+/**
+ * @brief Interface of detectors finding people in a frame using a neural network.
+ * Implementations differ in the inference engine they run the network on. Every implementation expects an
+ * SSD-style network taking a 1x3xHxW blob created by the preprocessor and producing detections of the form
+ * [batchId, classId, confidence, left, top, right, bottom]. Each instance owns its own network, so separate
+ * instances can be used from separate threads. Instances are created with create(), either with the full
+ * precision network or with its INT8-quantized version.
+ */
+class PersonDetector {
+    public:
+        /**
+         * Enumeration used to specify the inference engine a detector runs on.
+         */
+        enum Backend {
+            // OpenCV's dnn module running the Caffe MobileNet-SSD
+            OpenCvBackend,
+            // ONNX Runtime on the CPU, only available if the application was built with it
+            OnnxRuntimeBackend
+        };
+
+        /**
+         * Everything that decides which network a detector loads and how it runs it.
+         * Detectors are recreated whenever their options change.
+         */
+        struct Options {
+            Backend backend = OpenCvBackend;
+            // Load the INT8-quantized network instead of the full precision one
+            bool quantized = false;
+            // The cv::dnn::Backend and cv::dnn::Target the OpenCV backend runs the network on
+            int dnnBackend = cv::dnn::DNN_BACKEND_DEFAULT;
+            int dnnTarget = cv::dnn::DNN_TARGET_CPU;
+            // The intra-op threads of an ONNX Runtime session, zero for its default. OpenCV networks ignore it and
+            // share the process-wide count set with setOpenCvThreads()
+            int threads = 0;
+
+            bool operator==(const Options& other) const;
+            bool operator!=(const Options& other) const;
+        };
+
+        /**
+         * How a frame is split into overlapping tiles, each detected at the network's full input size.
+         * A single tile detects the whole frame at once.
+         */
+        struct Tiling {
+            int columns = 1;
+            int rows = 1;
+            // The overlap between neighbouring tiles, as a fraction of the tile size
+            double overlap = DEFAULT_TILE_OVERLAP;
+
+            int getCount() const;
+
+            bool operator==(const Tiling& other) const;
+            bool operator!=(const Tiling& other) const;
+        };
+
+        virtual ~PersonDetector();
+
+        static std::unique_ptr<PersonDetector> create(const Options& options);
+
+        static bool isAvailable(const Backend backend);
+
+        static void setOpenCvThreads(const int threads);
+
+        static QString getBackendName(const Backend backend);
+
+        static bool isDnnPreferenceAvailable(const int dnnBackend, const int dnnTarget);
+
+        static std::vector<int> getAvailableDnnBackends();
+
+        static std::vector<int> getAvailableDnnTargets(const int dnnBackend);
+
+        static QString getDnnBackendName(const int dnnBackend);
+
+        static QString getDnnTargetName(const int dnnTarget);
+
+        static std::vector<cv::Rect> getTiles(const cv::Size frameSize, const Tiling& tiling);
+
+        static std::vector<cv::Rect> mergeTiles(const std::vector<cv::Rect>& tiles, const std::vector<std::vector<cv::Rect>>& detections,
+                                                const std::vector<std::vector<float>>& confidences);
+
+        const Options& getOptions() const;
+
+        cv::Size getInputSize() const;
+
+        void setInputSize(const cv::Size size);
+
+        virtual std::vector<cv::Rect> detect(const cv::Mat& frame, std::vector<float> *confidences = nullptr) = 0;
+
+        virtual std::vector<std::vector<cv::Rect>> detectBatch(const std::vector<cv::Mat>& frames, std::vector<std::vector<float>> *confidences = nullptr);
+
+        std::vector<cv::Rect> detectTiled(const cv::Mat& frame, const Tiling& tiling);
+
+        void reportFailure(const std::exception& e);
+
+    protected:
+        PersonDetector(const Options& options);
+
+        static void collectPeople(const float *data, const std::size_t total, const cv::Size frameSize, std::vector<cv::Rect>& boxes,
+                                  std::vector<float> *confidences, const int batchIndex = 0);
+
+        /**
+         * Converts frames into the network's input blob, reusing its buffers between detections.
+         */
+        Preprocessor preprocessor;
+
+        /**
+         * The options the detector was created with.
+         */
+        Options options;
+
+    private:
+        /**
+         * Whether a failed forward pass was already logged, later failures of the same detector are not.
+         */
+        bool failureReported;
+};
+
+Q_DECLARE_METATYPE(PersonDetector::Options)
+Q_DECLARE_METATYPE(PersonDetector::Tiling)
+
+#endif // PERSONDETECTOR_H
@@ -0,0 +1,54 @@
+/**
+ * @file Pipeline.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs tracking and rendering on their own threads, linked to the video source by queued connections
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "Pipeline.h"
+
+/**
+ * @brief Constructs a new Pipeline object and starts its threads.
+ * Takes ownership of the tracker and renderer, which must not have a parent since they are moved to worker threads.
+ * @param videoSource the source feeding the pipeline. Captures on its own thread if set to threaded capture.
+ * @param objectTracker the tracker to run on the tracking thread.
+ * @param frameRenderer the renderer to run on the rendering thread.
+ * @param parent the parent Qt object of this object.
+ */
+Pipeline::Pipeline(VideoSource *videoSource, ObjectTracker *objectTracker, FrameRenderer *frameRenderer, QObject *parent) : QObject(parent) {
+    trackerThread.setObjectName("TrackerThread");
+    renderThread.setObjectName("RenderThread");
+
+    // Rendering is handed off to the renderer instead of happening on the tracking thread
+    objectTracker->setRenderMode(ObjectTracker::DeferredRendering);
+
+    objectTracker->moveToThread(&trackerThread);
+    frameRenderer->moveToThread(&renderThread);
+
+    // The stages are deleted on their own threads once the threads finish
+    connect(&trackerThread, &QThread::finished, objectTracker, &QObject::deleteLater);
+    connect(&renderThread, &QThread::finished, frameRenderer, &QObject::deleteLater);
+
+    // Link the stages with queued connections, each stage only ever runs on its own thread
+    connect(videoSource, &VideoSource::frameCaptured, objectTracker, &ObjectTracker::processFrame, Qt::QueuedConnection);
+    connect(objectTracker, &ObjectTracker::frameTracked, frameRenderer, &FrameRenderer::renderFrame, Qt::QueuedConnection);
+
+    // Every rendered frame hands a credit back to the source, bounding the frames in flight
+    connect(frameRenderer, &FrameRenderer::frameRendered, videoSource, &VideoSource::frameReleased, Qt::QueuedConnection);
+    videoSource->setMaxFramesInFlight(PIPELINE_MAX_FRAMES_IN_FLIGHT);
+
+    trackerThread.start();
+    renderThread.start();
+}
+
+/**
+ * @brief Destructs a Pipeline object, stopping its threads and the stages running on them.
+ */
+Pipeline::~Pipeline() {
+    trackerThread.quit();
+    trackerThread.wait();
+
+    renderThread.quit();
+    renderThread.wait();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file Pipeline.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs tracking and rendering on their own threads, linked to the video source by queued connections
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <QObject>
+#include <QThread>
+
+#include "FrameRenderer.h"
+#include "ObjectTracker.h"
+#include "VideoSource.h"
+
+/**
+ * The maximum number of frames between capture and the end of rendering.
+ * Allows one frame to be rendered while the next is tracked and a third waits, without unbounded queueing.
+ */
+#define PIPELINE_MAX_FRAMES_IN_FLIGHT 3
+
+/**
+ * @brief Class that runs the processing chain as a pipeline.
+ * Capture (VideoSource), detection/tracking (ObjectTracker) and overlay rendering (FrameRenderer) each run on
+ * their own thread, so frame N+1 is decoded while frame N is tracked and frame N-1 is rendered.
+ * Stages are linked by queued connections and the number of frames in flight is bounded, which pushes
+ * back on the capture when a later stage falls behind.
+ */
+class Pipeline : public QObject {
+    Q_OBJECT
+
+    public:
+        Pipeline(VideoSource *videoSource, ObjectTracker *objectTracker, FrameRenderer *frameRenderer, QObject *parent = 0);
+
+        ~Pipeline();
+
+    private:
+        QThread trackerThread;
+
+        QThread renderThread;
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,116 @@
+/**
+ * @file Preprocessor.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Converts frames into the input blob of the detection network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "Preprocessor.h"
+
+/**
+ * @brief Constructs a new Preprocessor object.
+ * @param inputSize the input size of the detection network.
+ */
+Preprocessor::Preprocessor(const cv::Size inputSize) {
+    this->inputSize = inputSize;
+}
+
+/**
+ * @brief Destructs a Preprocessor object.
+ */
+Preprocessor::~Preprocessor() {
+
+}
+
+/**
+ * @brief Returns the input size of the detection network.
+ * @return the size images are resized to.
+ */
+cv::Size Preprocessor::getInputSize() const {
+    return inputSize;
+}
+
+/**
+ * @brief Sets the input size of the detection network.
+ * @param inputSize the size images are resized to.
+ */
+void Preprocessor::setInputSize(const cv::Size inputSize) {
+    this->inputSize = inputSize;
+}
+
+/**
+ * @brief Converts an image into a batch-of-one blob.
+ * @param image the 8-bit BGR or grayscale image to convert.
+ * @return the 1x3xHxW blob, reused and overwritten by the next call.
+ */
+const cv::Mat& Preprocessor::process(const cv::Mat& image) {
+    const int shape[] = { 1, 3, inputSize.height, inputSize.width };
+    blob.create(4, shape, CV_32F);
+
+    process(image, blob, 0);
+
+    return blob;
+}
+
+/**
+ * @brief Converts an image into one item of an existing NCHW blob.
+ * The image is resized to the input size, then a single pass computes (pixel - mean) * scale
+ * for every channel and writes each channel into its own plane of the blob. A grayscale image is
+ * written into all three planes, so it is converted once without expanding it to BGR first.
+ * @param image the 8-bit BGR or grayscale image to convert.
+ * @param blob the Nx3xHxW 32-bit float blob to write into, sized for the input size.
+ * @param index the batch index to write the image to.
+ */
+void Preprocessor::process(const cv::Mat& image, cv::Mat& blob, const int index) {
+    CV_Assert(image.type() == CV_8UC3 || image.type() == CV_8UC1);
+    CV_Assert(blob.dims == 4 && blob.size[1] == 3 && blob.size[2] == inputSize.height && blob.size[3] == inputSize.width);
+
+    // Resize once into the reused buffer, skipped if the image already has the input size
+    const cv::Mat *source = &image;
+
+    if (image.size() != inputSize) {
+        cv::resize(image, resized, inputSize, 0, 0, cv::INTER_LINEAR);
+        source = &resized;
+    }
+
+    const int width = inputSize.width;
+    const int height = inputSize.height;
+    const int planeSize = width * height;
+
+    const float scale = static_cast<float>(INPUT_SCALE_FACTOR);
+    const float offset = static_cast<float>(INPUT_MEAN * INPUT_SCALE_FACTOR);
+
+    float *blue = blob.ptr<float>(index, 0);
+    float *green = blue + planeSize;
+    float *red = green + planeSize;
+
+    // A gray pixel stands for equal blue, green and red values
+    if (source->channels() == 1) {
+        for (int y = 0; y < height; y++) {
+            const uchar *pixel = source->ptr<uchar>(y);
+            const int row = y * width;
+
+            for (int x = 0; x < width; x++) {
+                const float value = pixel[x] * scale - offset;
+                blue[row + x] = value;
+                green[row + x] = value;
+                red[row + x] = value;
+            }
+        }
+
+        return;
+    }
+
+    // Fused mean subtraction, scaling and HWC to NCHW reordering, (p - mean) * scale == p * scale - mean * scale
+    for (int y = 0; y < height; y++) {
+        const uchar *pixel = source->ptr<uchar>(y);
+        const int row = y * width;
+
+        for (int x = 0; x < width; x++) {
+            blue[row + x] = pixel[3 * x] * scale - offset;
+            green[row + x] = pixel[3 * x + 1] * scale - offset;
+            red[row + x] = pixel[3 * x + 2] * scale - offset;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Preprocessor.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Converts frames into the input blob of the detection network
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * The default width of the detection network's input. MobileNet-SSD was trained on 300x300 images.
+ */
+#define DEFAULT_INPUT_WIDTH 300
+
+/**
+ * The default height of the detection network's input.
+ */
+#define DEFAULT_INPUT_HEIGHT 300
+
+/**
+ * The factor pixel values are multiplied by after mean subtraction, maps [0, 255] to [-1, 1].
+ */
+#define INPUT_SCALE_FACTOR 0.007843
+
+/**
+ * The value subtracted from every channel of every pixel before scaling.
+ */
+#define INPUT_MEAN 127.5
+
+/**
+ * @brief Class that converts frames into the input blob of the detection network.
+ * Replaces cv::dnn::blobFromImage with a single resize into a reused buffer followed by one fused pass
+ * that subtracts the mean, scales and reorders the pixels from interleaved HWC to planar NCHW,
+ * writing straight into a reused blob. The cost is therefore set by the input size, not the frame size.
+ */
+class Preprocessor {
+    public:
+        Preprocessor(const cv::Size inputSize = cv::Size(DEFAULT_INPUT_WIDTH, DEFAULT_INPUT_HEIGHT));
+
+        ~Preprocessor();
+
+        cv::Size getInputSize() const;
+
+        void setInputSize(const cv::Size inputSize);
+
+        const cv::Mat& process(const cv::Mat& image);
+
+        void process(const cv::Mat& image, cv::Mat& blob, const int index);
+
+    private:
+        /**
+         * The size images are resized to before being converted.
+         */
+        cv::Size inputSize;
+
+        /**
+         * Reused buffer holding the resized image.
+         */
+        cv::Mat resized;
+
+        /**
+         * Reused 1x3xHxW blob returned by process().
+         */
+        cv::Mat blob;
+};
+
+#endif // PREPROCESSOR_H
@@ -8,11 +8,16 @@
  * @copyright Copyright (c) 2020
  *
  */
+#include <algorithm>
+
 #include <QGroupBox>
 #include <QHBoxLayout>
+#include <QLabel>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QSettings>
+#include <QStringList>
+#include <QThread>
 
 #include "SettingsWindow.h"
 
@@ -20,12 +25,51 @@
  * @brief Constructor that allows to change the settings of the boxes on the video, the line on the video the max capacity and etc..
  *
  * @param objectTracker
+ * @param videoSource
  * @param parent
  */
-SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, QWidget *parent) : QWidget(parent) {
+SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, VideoSource *videoSource, QWidget *parent) : QWidget(parent) {
     QSettings settings;
     const auto drawFlags = settings.value("tracker/drawFlags").value<ObjectTracker::DrawFlags>();
     const auto enterDirection = settings.value("tracker/enterDirection").toUInt();
+    const auto countingLines = settings.value("tracker/countingLines").toStringList();
+    const auto regionOfInterest = settings.value("tracker/regionOfInterest").toRect();
+    const auto detectorBackend = settings.value("tracker/detectorBackend", PersonDetector::OpenCvBackend).toInt();
+    const auto quantizedDetector = settings.value("tracker/quantizedDetector", false).toBool();
+    const auto dnnBackend = settings.value("tracker/dnnBackend", cv::dnn::DNN_BACKEND_DEFAULT).toInt();
+    const auto dnnTarget = settings.value("tracker/dnnTarget", cv::dnn::DNN_TARGET_CPU).toInt();
+    const auto detectorThreads = settings.value("tracker/detectorThreads", 0).toInt();
+    const auto opencvThreads = settings.value("inference/opencvThreads", 0).toInt();
+    const auto inputWidth = settings.value("tracker/inputWidth", DEFAULT_INPUT_WIDTH).toInt();
+    const auto inputHeight = settings.value("tracker/inputHeight", DEFAULT_INPUT_HEIGHT).toInt();
+    const auto tileColumns = settings.value("tracker/tileColumns", 1).toInt();
+    const auto tileRows = settings.value("tracker/tileRows", 1).toInt();
+    const auto tileOverlap = settings.value("tracker/tileOverlap", DEFAULT_TILE_OVERLAP).toDouble();
+    const auto asyncDetection = settings.value("tracker/asyncDetection", false).toBool();
+    const auto adaptiveDetection = settings.value("tracker/adaptiveDetection", false).toBool();
+    const auto motionGating = settings.value("tracker/motionGating", false).toBool();
+    const auto trackerAlgorithm = settings.value("tracker/algorithm", TrackedObject::KcfTracker).toInt();
+    const auto grayTracking = settings.value("tracker/grayTracking", false).toBool();
+    const auto associationMethod = settings.value("tracker/associationMethod", TrackAssociator::HungarianAssociation).toInt();
+    const auto predictiveTracking = settings.value("tracker/predictiveTracking", false).toBool();
+    const auto parallelTracking = settings.value("tracker/parallelTracking", true).toBool();
+    const auto sharedInference = settings.value("inference/shared", false).toBool();
+    const auto maxBatchSize = settings.value("inference/maxBatchSize", DEFAULT_MAX_BATCH_SIZE).toInt();
+    const auto maxBatchWait = settings.value("inference/maxWait", DEFAULT_MAX_BATCH_WAIT).toInt();
+    const auto detectionSlots = settings.value("inference/detectionSlots", DEFAULT_DETECTION_SLOTS).toInt();
+    const auto budgetEnabled = settings.value("governor/enabled", false).toBool();
+    const auto frameDeadline = settings.value("governor/frameDeadline", DEFAULT_FRAME_DEADLINE).toDouble();
+    const auto cpuShare = settings.value("governor/cpuShare", DEFAULT_CPU_SHARE).toDouble();
+    const auto pipelined = settings.value("pipeline/enabled", false).toBool();
+    const auto threadedCapture = pipelined || settings.value("capture/threaded", false).toBool();
+    const auto queueCapacity = settings.value("capture/queueCapacity", DEFAULT_FRAME_QUEUE_CAPACITY).toInt();
+    const auto overflowPolicy = settings.value("capture/overflowPolicy", FrameQueue::DropOldest).toUInt();
+    const auto framePoolCapacity = settings.value("capture/framePoolCapacity", DEFAULT_FRAME_POOL_CAPACITY).toInt();
+    const auto frameWidth = settings.value("capture/frameWidth", 0).toInt();
+    const auto frameHeight = settings.value("capture/frameHeight", 0).toInt();
+    const auto grayFrames = settings.value("capture/grayFrames", false).toBool();
+    const auto decoderThreads = settings.value("capture/decoderThreads", 0).toInt();
+    const auto decoderThreadMode = settings.value("capture/decoderThreadMode", VideoDecoder::AutoThreads).toInt();
 
     // Create the "Draw Flags" group box with check boxes to select individual flags
     QGroupBox *drawFlagsGroup = new QGroupBox("Draw Flags");
@@ -54,6 +98,10 @@ SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, QWidget *parent) :
     showFrameStatusCheckBox = new QCheckBox("Show Frame Status");
     showFrameStatusCheckBox->setChecked(drawFlags.testFlag(ObjectTracker::ShowFrameStatus));
 
+    // Shows the recent path of every tracked person
+    drawTrajectoriesCheckBox = new QCheckBox("Draw Trajectories");
+    drawTrajectoriesCheckBox->setChecked(drawFlags.testFlag(ObjectTracker::DrawTrajectories));
+
     QGridLayout *drawFlagsLayout = new QGridLayout;
     drawFlagsLayout->setSizeConstraint(QLayout::SetMinimumSize);
     drawFlagsLayout->addWidget(drawBoundingBoxesCheckBox, 0, 0);
@@ -62,10 +110,11 @@ SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, QWidget *parent) :
     drawFlagsLayout->addWidget(showStatesCheckBox, 0, 1);
     drawFlagsLayout->addWidget(showFrameNumberCheckBox, 1, 1);
     drawFlagsLayout->addWidget(showFrameStatusCheckBox, 2, 1);
+    drawFlagsLayout->addWidget(drawTrajectoriesCheckBox, 3, 0);
     drawFlagsGroup->setLayout(drawFlagsLayout);
 
-    // Create the "Enter Direction" group box with a combo box to select the direction
-    QGroupBox *enterDirectionGroup = new QGroupBox("Enter Direction");
+    // Create the "Counting" group box with a combo box to select the direction and the lines people are counted across
+    QGroupBox *enterDirectionGroup = new QGroupBox("Counting");
 
     enterDirectionComboBox = new QComboBox;
     enterDirectionComboBox->addItem("Up");
@@ -74,12 +123,450 @@ SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, QWidget *parent) :
     enterDirectionComboBox->addItem("Right");
     enterDirectionComboBox->setCurrentIndex(enterDirection);
 
+    // One line or zone per row, without any the enter direction applies across the center of the region
+    countingLinesTextEdit = new QPlainTextEdit(countingLines.join("\n"));
+    countingLinesTextEdit->setPlaceholderText("Door|0,0.5 1,0.5|line|forward");
+    countingLinesTextEdit->setToolTip("One per row: name|x,y x,y ...|line or zone|forward or reversed\n"
+                                      "Points are fractions of the region of interest. People enter by crossing a line from its left\n"
+                                      "to its right, walking from its first point, or by moving into a zone. Reversed swaps the two.\n"
+                                      "Without lines, people are counted across the center of the region in the enter direction.");
+
     // Sets the constraints changed by the user to the video
-    QVBoxLayout *enterDirectionLayout = new QVBoxLayout;
+    QGridLayout *enterDirectionLayout = new QGridLayout;
     enterDirectionLayout->setSizeConstraint(QLayout::SetMinimumSize);
-    enterDirectionLayout->addWidget(enterDirectionComboBox);
+    enterDirectionLayout->addWidget(new QLabel("Enter Direction"), 0, 0);
+    enterDirectionLayout->addWidget(enterDirectionComboBox, 0, 1);
+    enterDirectionLayout->addWidget(new QLabel("Counting Lines"), 1, 0, 1, 2);
+    enterDirectionLayout->addWidget(countingLinesTextEdit, 2, 0, 1, 2);
     enterDirectionGroup->setLayout(enterDirectionLayout);
 
+    // Create the "Detector" group box to choose the size frames are resized to before detection
+    // Create the "Region of Interest" group box to restrict processing to the area around the door
+    QGroupBox *regionGroup = new QGroupBox("Region of Interest");
+
+    regionXSpinBox = new QSpinBox;
+    regionXSpinBox->setRange(0, 7680);
+    regionXSpinBox->setValue(regionOfInterest.x());
+
+    regionYSpinBox = new QSpinBox;
+    regionYSpinBox->setRange(0, 4320);
+    regionYSpinBox->setValue(regionOfInterest.y());
+
+    // An empty region processes the whole frame
+    regionWidthSpinBox = new QSpinBox;
+    regionWidthSpinBox->setRange(0, 7680);
+    regionWidthSpinBox->setSpecialValueText("Full Frame");
+    regionWidthSpinBox->setValue(regionOfInterest.width());
+
+    regionHeightSpinBox = new QSpinBox;
+    regionHeightSpinBox->setRange(0, 4320);
+    regionHeightSpinBox->setSpecialValueText("Full Frame");
+    regionHeightSpinBox->setValue(regionOfInterest.height());
+
+    QGridLayout *regionLayout = new QGridLayout;
+    regionLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    regionLayout->addWidget(new QLabel("X"), 0, 0);
+    regionLayout->addWidget(regionXSpinBox, 0, 1);
+    regionLayout->addWidget(new QLabel("Y"), 0, 2);
+    regionLayout->addWidget(regionYSpinBox, 0, 3);
+    regionLayout->addWidget(new QLabel("Width"), 1, 0);
+    regionLayout->addWidget(regionWidthSpinBox, 1, 1);
+    regionLayout->addWidget(new QLabel("Height"), 1, 2);
+    regionLayout->addWidget(regionHeightSpinBox, 1, 3);
+    regionGroup->setLayout(regionLayout);
+
+    QGroupBox *detectorGroup = new QGroupBox("Detector");
+
+    // Only offer the backends this build supports
+    detectorBackendComboBox = new QComboBox;
+
+    for (const auto backend : { PersonDetector::OpenCvBackend, PersonDetector::OnnxRuntimeBackend }) {
+        if (PersonDetector::isAvailable(backend)) {
+            detectorBackendComboBox->addItem(PersonDetector::getBackendName(backend), backend);
+        }
+    }
+
+    detectorBackendComboBox->setCurrentIndex(std::max(detectorBackendComboBox->findData(detectorBackend), 0));
+
+    // The quantized network is cheaper on the CPU, compare its counts with "--batch --compare" before adopting it
+    quantizedDetectorCheckBox = new QCheckBox("INT8-Quantized Network");
+    quantizedDetectorCheckBox->setChecked(quantizedDetector);
+
+    // Only offer the DNN backends and targets this build of OpenCV supports
+    dnnBackendComboBox = new QComboBox;
+    dnnTargetComboBox = new QComboBox;
+
+    for (const auto backend : PersonDetector::getAvailableDnnBackends()) {
+        dnnBackendComboBox->addItem(PersonDetector::getDnnBackendName(backend), backend);
+    }
+
+    // The available targets depend on the backend
+    connect(dnnBackendComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        dnnTargetComboBox->clear();
+
+        for (const auto target : PersonDetector::getAvailableDnnTargets(dnnBackendComboBox->itemData(index).toInt())) {
+            dnnTargetComboBox->addItem(PersonDetector::getDnnTargetName(target), target);
+        }
+    });
+
+    dnnBackendComboBox->setCurrentIndex(-1);
+    dnnBackendComboBox->setCurrentIndex(std::max(dnnBackendComboBox->findData(dnnBackend), 0));
+    dnnTargetComboBox->setCurrentIndex(std::max(dnnTargetComboBox->findData(dnnTarget), 0));
+
+    // Capping the threads of each detector leaves cores to capture, tracking and other streams
+    detectorThreadsSpinBox = new QSpinBox;
+    detectorThreadsSpinBox->setRange(0, QThread::idealThreadCount());
+    detectorThreadsSpinBox->setSpecialValueText("Automatic");
+    detectorThreadsSpinBox->setValue(detectorThreads);
+    detectorThreadsSpinBox->setToolTip("Each ONNX Runtime detector has its own thread pool of this size");
+
+    // OpenCV has a single thread count for the whole process, it also caps resizing, color conversion and tracking
+    opencvThreadsSpinBox = new QSpinBox;
+    opencvThreadsSpinBox->setRange(0, QThread::idealThreadCount());
+    opencvThreadsSpinBox->setSpecialValueText("Automatic");
+    opencvThreadsSpinBox->setValue(opencvThreads);
+    opencvThreadsSpinBox->setToolTip("Shared by all OpenCV detectors, resizing, color conversion and tracking in the whole process");
+
+    // The DNN backend and target only apply to the OpenCV detector, the per detector thread cap only to ONNX Runtime
+    const auto updateDnnEnabled = [this]() {
+        const bool openCv = detectorBackendComboBox->currentData().toInt() == PersonDetector::OpenCvBackend;
+        dnnBackendComboBox->setEnabled(openCv);
+        dnnTargetComboBox->setEnabled(openCv);
+        detectorThreadsSpinBox->setEnabled(!openCv);
+    };
+
+    updateDnnEnabled();
+    connect(detectorBackendComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, updateDnnEnabled);
+
+    inputWidthSpinBox = new QSpinBox;
+    inputWidthSpinBox->setRange(32, 1920);
+    inputWidthSpinBox->setValue(inputWidth);
+
+    inputHeightSpinBox = new QSpinBox;
+    inputHeightSpinBox->setRange(32, 1920);
+    inputHeightSpinBox->setValue(inputHeight);
+
+    // Tiling detects the region in overlapping tiles as one batch, finding small people at the cost of more inference
+    tileColumnsSpinBox = new QSpinBox;
+    tileColumnsSpinBox->setRange(1, MAX_TILES_PER_AXIS);
+    tileColumnsSpinBox->setValue(tileColumns);
+
+    tileRowsSpinBox = new QSpinBox;
+    tileRowsSpinBox->setRange(1, MAX_TILES_PER_AXIS);
+    tileRowsSpinBox->setValue(tileRows);
+
+    tileOverlapSpinBox = new QSpinBox;
+    tileOverlapSpinBox->setRange(0, qRound(MAX_TILE_OVERLAP * 100));
+    tileOverlapSpinBox->setSuffix(" %");
+    tileOverlapSpinBox->setValue(qRound(tileOverlap * 100));
+
+    const auto updateTileOverlapEnabled = [this]() {
+        tileOverlapSpinBox->setEnabled(tileColumnsSpinBox->value() > 1 || tileRowsSpinBox->value() > 1);
+    };
+
+    updateTileOverlapEnabled();
+    connect(tileColumnsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, updateTileOverlapEnabled);
+    connect(tileRowsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, updateTileOverlapEnabled);
+
+    // Detecting in the background keeps the time per frame flat, detections are applied a few frames late
+    asyncDetectionCheckBox = new QCheckBox("Detect in Background");
+    asyncDetectionCheckBox->setChecked(asyncDetection);
+
+    // Show the current interval so the effect of the adaptive schedule can be followed
+    adaptiveDetectionCheckBox = new QCheckBox(QString("Adaptive Detection Interval (currently every %1 frames)").arg(objectTracker->getDetectionInterval()));
+    adaptiveDetectionCheckBox->setChecked(adaptiveDetection);
+
+    // Skip detection and tracking while nothing moves, show how many frames were skipped so far
+    motionGatingCheckBox = new QCheckBox("Skip Frames Without Motion");
+    motionGatingCheckBox->setChecked(motionGating);
+    motionGatingCheckBox->setToolTip(QString("%1 frames processed, %2 frames skipped")
+                                     .arg(objectTracker->getRunFrameCount())
+                                     .arg(objectTracker->getSkippedFrameCount()));
+
+    QGridLayout *detectorLayout = new QGridLayout;
+    detectorLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    detectorLayout->addWidget(new QLabel("Backend"), 0, 0);
+    detectorLayout->addWidget(detectorBackendComboBox, 0, 1);
+    detectorLayout->addWidget(quantizedDetectorCheckBox, 1, 0, 1, 2);
+    detectorLayout->addWidget(new QLabel("DNN Backend"), 2, 0);
+    detectorLayout->addWidget(dnnBackendComboBox, 2, 1);
+    detectorLayout->addWidget(new QLabel("DNN Target"), 3, 0);
+    detectorLayout->addWidget(dnnTargetComboBox, 3, 1);
+    detectorLayout->addWidget(new QLabel("ONNX Runtime Threads per Detector"), 4, 0);
+    detectorLayout->addWidget(detectorThreadsSpinBox, 4, 1);
+    detectorLayout->addWidget(new QLabel("OpenCV Threads, Whole Process (requires restart)"), 5, 0);
+    detectorLayout->addWidget(opencvThreadsSpinBox, 5, 1);
+    detectorLayout->addWidget(new QLabel("Input Width"), 6, 0);
+    detectorLayout->addWidget(inputWidthSpinBox, 6, 1);
+    detectorLayout->addWidget(new QLabel("Input Height"), 7, 0);
+    detectorLayout->addWidget(inputHeightSpinBox, 7, 1);
+    detectorLayout->addWidget(new QLabel("Tile Columns"), 8, 0);
+    detectorLayout->addWidget(tileColumnsSpinBox, 8, 1);
+    detectorLayout->addWidget(new QLabel("Tile Rows"), 9, 0);
+    detectorLayout->addWidget(tileRowsSpinBox, 9, 1);
+    detectorLayout->addWidget(new QLabel("Tile Overlap"), 10, 0);
+    detectorLayout->addWidget(tileOverlapSpinBox, 10, 1);
+    detectorLayout->addWidget(asyncDetectionCheckBox, 11, 0, 1, 2);
+    detectorLayout->addWidget(adaptiveDetectionCheckBox, 12, 0, 1, 2);
+    detectorLayout->addWidget(motionGatingCheckBox, 13, 0, 1, 2);
+    detectorGroup->setLayout(detectorLayout);
+
+    // Create the "Tracking" group box to choose how detections are matched with tracked people
+    QGroupBox *trackingGroup = new QGroupBox("Tracking");
+
+    // Cheaper trackers suit well-lit scenes, robust ones suit difficult lighting, see the calibration mode
+    trackerAlgorithmComboBox = new QComboBox;
+
+    for (const auto algorithm : { TrackedObject::OpticalFlowTracker, TrackedObject::MosseTracker, TrackedObject::KcfTracker, TrackedObject::CsrtTracker }) {
+        trackerAlgorithmComboBox->addItem(QString::fromStdString(TrackedObject::getAlgorithmName(algorithm)), algorithm);
+    }
+
+    trackerAlgorithmComboBox->setCurrentIndex(std::max(0, trackerAlgorithmComboBox->findData(trackerAlgorithm)));
+
+    // Every tracker then reads the grayscale frame converted once per frame, KCF and CSRT lose their color features
+    grayTrackingCheckBox = new QCheckBox("Track on Shared Grayscale");
+    grayTrackingCheckBox->setChecked(grayTracking);
+
+    associationMethodComboBox = new QComboBox;
+    associationMethodComboBox->addItem("Greedy", TrackAssociator::GreedyAssociation);
+    associationMethodComboBox->addItem("Hungarian", TrackAssociator::HungarianAssociation);
+    associationMethodComboBox->setCurrentIndex(std::max(0, associationMethodComboBox->findData(associationMethod)));
+
+    // Moving predictable tracks by their motion model saves the tracker's cost on those frames
+    predictiveTrackingCheckBox = new QCheckBox("Predict Well-Conditioned Tracks");
+    predictiveTrackingCheckBox->setChecked(predictiveTracking);
+
+    // Show how long tracking took so far by the number of people in view
+    parallelTrackingCheckBox = new QCheckBox("Update Tracks in Parallel");
+    parallelTrackingCheckBox->setChecked(parallelTracking);
+
+    QStringList trackingTimes;
+    const auto times = objectTracker->getTrackingTimes();
+
+    for (std::size_t count = 0; count < times.size(); count++) {
+        if (times[count].frames > 0) {
+            trackingTimes << QString("%1 people: %2 ms mean, %3 ms max over %4 frames").arg(count)
+                             .arg(times[count].total / times[count].frames, 0, 'f', 2).arg(times[count].longest, 0, 'f', 2)
+                             .arg(times[count].frames);
+        }
+    }
+
+    parallelTrackingCheckBox->setToolTip(trackingTimes.isEmpty() ? "No frames tracked yet" : trackingTimes.join("\n"));
+
+    QGridLayout *trackingLayout = new QGridLayout;
+    trackingLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    trackingLayout->addWidget(new QLabel("Tracker"), 0, 0);
+    trackingLayout->addWidget(trackerAlgorithmComboBox, 0, 1);
+    trackingLayout->addWidget(grayTrackingCheckBox, 1, 0, 1, 2);
+    trackingLayout->addWidget(new QLabel("Association"), 2, 0);
+    trackingLayout->addWidget(associationMethodComboBox, 2, 1);
+    trackingLayout->addWidget(predictiveTrackingCheckBox, 3, 0, 1, 2);
+    trackingLayout->addWidget(parallelTrackingCheckBox, 4, 0, 1, 2);
+    trackingGroup->setLayout(trackingLayout);
+
+    // Create the "Shared Inference" group box to batch background detections across streams
+    QGroupBox *inferenceGroup = new QGroupBox("Shared Inference");
+
+    sharedInferenceCheckBox = new QCheckBox("Batch Background Detections (requires restart)");
+    sharedInferenceCheckBox->setChecked(sharedInference);
+
+    maxBatchSizeSpinBox = new QSpinBox;
+    maxBatchSizeSpinBox->setRange(1, 64);
+    maxBatchSizeSpinBox->setValue(maxBatchSize);
+
+    // Bounds the latency batching adds to a detection
+    maxBatchWaitSpinBox = new QSpinBox;
+    maxBatchWaitSpinBox->setRange(0, 1000);
+    maxBatchWaitSpinBox->setSuffix(" ms");
+    maxBatchWaitSpinBox->setValue(maxBatchWait);
+
+    // Show how well requests are being batched
+    const InferenceService *inferenceService = objectTracker->getInferenceService();
+
+    if (inferenceService != nullptr) {
+        const auto batches = inferenceService->getBatchCount();
+        const auto requests = inferenceService->getRequestCount();
+
+        sharedInferenceCheckBox->setToolTip(QString("%1 detections in %2 batches (%3 per batch)")
+                                            .arg(requests)
+                                            .arg(batches)
+                                            .arg(batches > 0 ? static_cast<double>(requests) / batches : 0.0, 0, 'f', 1));
+    }
+
+    // Caps the detections running at once across every stream, so they take turns instead of spiking together
+    detectionSlotsSpinBox = new QSpinBox;
+    detectionSlotsSpinBox->setRange(0, 64);
+    detectionSlotsSpinBox->setSpecialValueText("Unlimited");
+    detectionSlotsSpinBox->setValue(detectionSlots);
+    detectionSlotsSpinBox->setToolTip(QString("%1 detections started, %2 frames waited for a slot")
+                                      .arg(DetectionSlots::instance().getGrantedCount())
+                                      .arg(DetectionSlots::instance().getDeferredCount()));
+
+    maxBatchSizeSpinBox->setEnabled(sharedInference);
+    maxBatchWaitSpinBox->setEnabled(sharedInference);
+    connect(sharedInferenceCheckBox, &QCheckBox::toggled, maxBatchSizeSpinBox, &QSpinBox::setEnabled);
+    connect(sharedInferenceCheckBox, &QCheckBox::toggled, maxBatchWaitSpinBox, &QSpinBox::setEnabled);
+
+    QGridLayout *inferenceLayout = new QGridLayout;
+    inferenceLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    inferenceLayout->addWidget(sharedInferenceCheckBox, 0, 0, 1, 2);
+    inferenceLayout->addWidget(new QLabel("Max Batch Size"), 1, 0);
+    inferenceLayout->addWidget(maxBatchSizeSpinBox, 1, 1);
+    inferenceLayout->addWidget(new QLabel("Max Wait"), 2, 0);
+    inferenceLayout->addWidget(maxBatchWaitSpinBox, 2, 1);
+    inferenceLayout->addWidget(new QLabel("Concurrent Detections"), 3, 0);
+    inferenceLayout->addWidget(detectionSlotsSpinBox, 3, 1);
+    inferenceGroup->setLayout(inferenceLayout);
+
+    // Create the "CPU Budget" group box to degrade processing step by step instead of falling behind under load
+    QGroupBox *budgetGroup = new QGroupBox("CPU Budget");
+
+    // Show the step currently taken and how often the governor stepped so far
+    budgetCheckBox = new QCheckBox("Degrade Under Load");
+    budgetCheckBox->setChecked(budgetEnabled);
+    budgetCheckBox->setToolTip(QString("Currently %1, %2 steps taken, %3 frames skipped")
+                               .arg(QString::fromStdString(BudgetGovernor::getLevelName(objectTracker->getDegradationLevel())))
+                               .arg(objectTracker->getDegradationStepCount())
+                               .arg(objectTracker->getBudgetSkippedFrameCount()));
+
+    frameDeadlineSpinBox = new QSpinBox;
+    frameDeadlineSpinBox->setRange(1, 1000);
+    frameDeadlineSpinBox->setSuffix(" ms");
+    frameDeadlineSpinBox->setValue(static_cast<int>(frameDeadline));
+
+    // Leaves the rest of every frame's time to decoding, display and other streams
+    cpuShareSpinBox = new QSpinBox;
+    cpuShareSpinBox->setRange(10, 100);
+    cpuShareSpinBox->setSuffix(" %");
+    cpuShareSpinBox->setValue(static_cast<int>(cpuShare * 100));
+
+    frameDeadlineSpinBox->setEnabled(budgetEnabled);
+    cpuShareSpinBox->setEnabled(budgetEnabled);
+    connect(budgetCheckBox, &QCheckBox::toggled, frameDeadlineSpinBox, &QSpinBox::setEnabled);
+    connect(budgetCheckBox, &QCheckBox::toggled, cpuShareSpinBox, &QSpinBox::setEnabled);
+
+    QGridLayout *budgetLayout = new QGridLayout;
+    budgetLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    budgetLayout->addWidget(budgetCheckBox, 0, 0, 1, 2);
+    budgetLayout->addWidget(new QLabel("Frame Deadline"), 1, 0);
+    budgetLayout->addWidget(frameDeadlineSpinBox, 1, 1);
+    budgetLayout->addWidget(new QLabel("CPU Share"), 2, 0);
+    budgetLayout->addWidget(cpuShareSpinBox, 2, 1);
+    budgetGroup->setLayout(budgetLayout);
+
+    // Create the "Capture" group box to choose where frames are decoded and how the frame queue overflows
+    QGroupBox *captureGroup = new QGroupBox("Capture");
+
+    threadedCaptureCheckBox = new QCheckBox("Decode on a Separate Thread");
+    threadedCaptureCheckBox->setChecked(threadedCapture);
+
+    queueCapacitySpinBox = new QSpinBox;
+    queueCapacitySpinBox->setRange(1, 64);
+    queueCapacitySpinBox->setValue(queueCapacity);
+
+    overflowPolicyComboBox = new QComboBox;
+    overflowPolicyComboBox->addItem("Drop Oldest");
+    overflowPolicyComboBox->addItem("Drop Newest");
+    overflowPolicyComboBox->addItem("Block");
+    overflowPolicyComboBox->setCurrentIndex(overflowPolicy);
+
+    // Show how many of the frame buffers are in use, so the pool can be sized to the queue and pipeline
+    const FramePool& framePool = videoSource->getFramePool();
+
+    framePoolCapacitySpinBox = new QSpinBox;
+    framePoolCapacitySpinBox->setRange(2, 128);
+    framePoolCapacitySpinBox->setValue(framePoolCapacity);
+    framePoolCapacitySpinBox->setToolTip(QString("In use: %1, peak: %2, exhausted: %3 times")
+                                             .arg(framePool.getInUseCount())
+                                             .arg(framePool.getPeakInUseCount())
+                                             .arg(framePool.getExhaustedCount()));
+
+    // Downscale and convert frames once while decoding, every later stage then reads fewer bytes. Zero keeps the source's size
+    const FrameConverter& frameConverter = videoSource->getFrameConverter();
+    const auto frameFormatToolTip = QString("Currently decoding %1x%2 %3 frames")
+                                    .arg(frameConverter.getFrameSize().width)
+                                    .arg(frameConverter.getFrameSize().height)
+                                    .arg(frameConverter.getPixelFormat() == FrameConverter::GrayFormat ? "grayscale" : "color");
+
+    frameWidthSpinBox = new QSpinBox;
+    frameWidthSpinBox->setRange(0, 7680);
+    frameWidthSpinBox->setSpecialValueText("Source");
+    frameWidthSpinBox->setValue(frameWidth);
+    frameWidthSpinBox->setToolTip(frameFormatToolTip);
+
+    frameHeightSpinBox = new QSpinBox;
+    frameHeightSpinBox->setRange(0, 4320);
+    frameHeightSpinBox->setSpecialValueText("Source");
+    frameHeightSpinBox->setValue(frameHeight);
+    frameHeightSpinBox->setToolTip(frameFormatToolTip);
+
+    grayFramesCheckBox = new QCheckBox("Decode to Grayscale (applies to the next video)");
+    grayFramesCheckBox->setChecked(grayFrames);
+
+    // Show the decoding throughput apart from the rest of the processing, so decode-bound videos stand out
+    const VideoDecoder& decoder = videoSource->getDecoder();
+    const auto decoderToolTip = decoder.isOpened() ? QString("Decoding with %1 on %2 threads at %3 frames per second")
+                                                         .arg(QString::fromStdString(decoder.getBackendName()))
+                                                         .arg(decoder.getThreadCount())
+                                                         .arg(decoder.getDecodeRate(), 0, 'f', 1)
+                                                   : QString("No video is being decoded");
+
+    decoderThreadsSpinBox = new QSpinBox;
+    decoderThreadsSpinBox->setRange(0, 64);
+    decoderThreadsSpinBox->setSpecialValueText("One per Core");
+    decoderThreadsSpinBox->setValue(decoderThreads);
+    decoderThreadsSpinBox->setToolTip(decoderToolTip);
+
+    // Frame and slice threading need FFmpeg's libraries, OpenCV only takes the number of threads
+    decoderThreadModeComboBox = new QComboBox;
+    decoderThreadModeComboBox->addItem("Auto", VideoDecoder::AutoThreads);
+    decoderThreadModeComboBox->addItem("Frame", VideoDecoder::FrameThreads);
+    decoderThreadModeComboBox->addItem("Slice", VideoDecoder::SliceThreads);
+    decoderThreadModeComboBox->setCurrentIndex(std::max(0, decoderThreadModeComboBox->findData(decoderThreadMode)));
+    decoderThreadModeComboBox->setEnabled(VideoDecoder::isLibavAvailable());
+    decoderThreadModeComboBox->setToolTip(decoderToolTip);
+
+    // The queue options only apply when decoding on a separate thread
+    queueCapacitySpinBox->setEnabled(threadedCapture);
+    overflowPolicyComboBox->setEnabled(threadedCapture);
+    connect(threadedCaptureCheckBox, &QCheckBox::toggled, queueCapacitySpinBox, &QSpinBox::setEnabled);
+    connect(threadedCaptureCheckBox, &QCheckBox::toggled, overflowPolicyComboBox, &QComboBox::setEnabled);
+
+    // Pipelining moves tracking and rendering onto worker threads, which can only be set up at startup
+    pipelinedCheckBox = new QCheckBox("Pipelined Processing (requires restart)");
+    pipelinedCheckBox->setChecked(pipelined);
+
+    // A pipeline always decodes on its own thread
+    threadedCaptureCheckBox->setEnabled(!pipelined);
+    connect(pipelinedCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (checked) {
+            threadedCaptureCheckBox->setChecked(true);
+        }
+
+        threadedCaptureCheckBox->setEnabled(!checked);
+    });
+
+    QGridLayout *captureLayout = new QGridLayout;
+    captureLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    captureLayout->addWidget(threadedCaptureCheckBox, 0, 0, 1, 2);
+    captureLayout->addWidget(new QLabel("Queue Capacity"), 1, 0);
+    captureLayout->addWidget(queueCapacitySpinBox, 1, 1);
+    captureLayout->addWidget(new QLabel("When Full"), 2, 0);
+    captureLayout->addWidget(overflowPolicyComboBox, 2, 1);
+    captureLayout->addWidget(new QLabel("Frame Buffers"), 3, 0);
+    captureLayout->addWidget(framePoolCapacitySpinBox, 3, 1);
+    captureLayout->addWidget(new QLabel("Frame Width"), 4, 0);
+    captureLayout->addWidget(frameWidthSpinBox, 4, 1);
+    captureLayout->addWidget(new QLabel("Frame Height"), 5, 0);
+    captureLayout->addWidget(frameHeightSpinBox, 5, 1);
+    captureLayout->addWidget(grayFramesCheckBox, 6, 0, 1, 2);
+    captureLayout->addWidget(new QLabel("Decoder Threads"), 7, 0);
+    captureLayout->addWidget(decoderThreadsSpinBox, 7, 1);
+    captureLayout->addWidget(new QLabel("Decoder Threading"), 8, 0);
+    captureLayout->addWidget(decoderThreadModeComboBox, 8, 1);
+    captureLayout->addWidget(pipelinedCheckBox, 9, 0, 1, 2);
+    captureGroup->setLayout(captureLayout);
+
     // Create "Close" button
     QPushButton *closeButton = new QPushButton("&Close", this);
     connect(closeButton, &QPushButton::clicked, this, &SettingsWindow::close);
@@ -99,10 +586,17 @@ SettingsWindow::SettingsWindow(ObjectTracker *objectTracker, QWidget *parent) :
     mainLayout->setSizeConstraint(QLayout::SetMinimumSize);
     mainLayout->addWidget(drawFlagsGroup);
     mainLayout->addWidget(enterDirectionGroup);
+    mainLayout->addWidget(regionGroup);
+    mainLayout->addWidget(detectorGroup);
+    mainLayout->addWidget(trackingGroup);
+    mainLayout->addWidget(inferenceGroup);
+    mainLayout->addWidget(budgetGroup);
+    mainLayout->addWidget(captureGroup);
     mainLayout->addStretch();
     mainLayout->addLayout(buttonLayout);
 
     this->objectTracker = objectTracker;
+    this->videoSource = videoSource;
 
     this->setWindowTitle("Settings");
     this->setLayout(mainLayout);
@@ -147,16 +641,137 @@ void SettingsWindow::save() {
     if (showFrameStatusCheckBox->isChecked()) {
         drawFlags |= ObjectTracker::ShowFrameStatus;
     }
+    // Checked if the draw trajectories box have been checked and if it has it changes the settings for the video
+    if (drawTrajectoriesCheckBox->isChecked()) {
+        drawFlags |= ObjectTracker::DrawTrajectories;
+    }
 
     const auto enterDirection = enterDirectionComboBox->currentIndex();
 
+    // Invalid rows are dropped, so the saved lines are the ones actually counted across
+    const auto countingLines = CountingLines::Line::fromStrings(countingLinesTextEdit->toPlainText().split('\n'));
+    const auto regionOfInterest = QRect(regionXSpinBox->value(), regionYSpinBox->value(),
+                                        regionWidthSpinBox->value(), regionHeightSpinBox->value());
+    const auto detectorBackend = detectorBackendComboBox->currentData().toInt();
+    const auto quantizedDetector = quantizedDetectorCheckBox->isChecked();
+    const auto dnnBackend = dnnBackendComboBox->currentData().toInt();
+    const auto dnnTarget = dnnTargetComboBox->currentData().toInt();
+    const auto detectorThreads = detectorThreadsSpinBox->value();
+    const auto opencvThreads = opencvThreadsSpinBox->value();
+    const auto inputWidth = inputWidthSpinBox->value();
+    const auto inputHeight = inputHeightSpinBox->value();
+    const auto tileColumns = tileColumnsSpinBox->value();
+    const auto tileRows = tileRowsSpinBox->value();
+    const auto tileOverlap = tileOverlapSpinBox->value() / 100.0;
+    const auto asyncDetection = asyncDetectionCheckBox->isChecked();
+    const auto adaptiveDetection = adaptiveDetectionCheckBox->isChecked();
+    const auto motionGating = motionGatingCheckBox->isChecked();
+    const auto threadedCapture = threadedCaptureCheckBox->isChecked();
+    const auto queueCapacity = queueCapacitySpinBox->value();
+    const auto overflowPolicy = overflowPolicyComboBox->currentIndex();
+    const auto framePoolCapacity = framePoolCapacitySpinBox->value();
+    const auto frameWidth = frameWidthSpinBox->value();
+    const auto frameHeight = frameHeightSpinBox->value();
+    const auto grayFrames = grayFramesCheckBox->isChecked();
+    const auto decoderThreads = decoderThreadsSpinBox->value();
+    const auto decoderThreadMode = decoderThreadModeComboBox->currentData().toInt();
+    const auto trackerAlgorithm = trackerAlgorithmComboBox->currentData().toInt();
+    const auto grayTracking = grayTrackingCheckBox->isChecked();
+    const auto associationMethod = associationMethodComboBox->currentData().toInt();
+    const auto predictiveTracking = predictiveTrackingCheckBox->isChecked();
+    const auto parallelTracking = parallelTrackingCheckBox->isChecked();
+    const auto sharedInference = sharedInferenceCheckBox->isChecked();
+    const auto maxBatchSize = maxBatchSizeSpinBox->value();
+    const auto maxBatchWait = maxBatchWaitSpinBox->value();
+    const auto detectionSlots = detectionSlotsSpinBox->value();
+    const auto budgetEnabled = budgetCheckBox->isChecked();
+    const auto frameDeadline = static_cast<double>(frameDeadlineSpinBox->value());
+    const auto cpuShare = cpuShareSpinBox->value() / 100.0;
+    const auto pipelined = pipelinedCheckBox->isChecked();
+
     // saves the settings so the next time the user opens it, it automatically saves.
     QSettings settings;
     settings.setValue("tracker/drawFlags", QVariant::fromValue(drawFlags));
     settings.setValue("tracker/enterDirection", enterDirection);
+    settings.setValue("tracker/countingLines", CountingLines::Line::toStrings(countingLines));
+    settings.setValue("tracker/regionOfInterest", regionOfInterest);
+    settings.setValue("tracker/detectorBackend", detectorBackend);
+    settings.setValue("tracker/quantizedDetector", quantizedDetector);
+    settings.setValue("tracker/dnnBackend", dnnBackend);
+    settings.setValue("tracker/dnnTarget", dnnTarget);
+    settings.setValue("tracker/detectorThreads", detectorThreads);
+    settings.setValue("inference/opencvThreads", opencvThreads);
+    settings.setValue("tracker/inputWidth", inputWidth);
+    settings.setValue("tracker/inputHeight", inputHeight);
+    settings.setValue("tracker/tileColumns", tileColumns);
+    settings.setValue("tracker/tileRows", tileRows);
+    settings.setValue("tracker/tileOverlap", tileOverlap);
+    settings.setValue("tracker/asyncDetection", asyncDetection);
+    settings.setValue("tracker/adaptiveDetection", adaptiveDetection);
+    settings.setValue("tracker/motionGating", motionGating);
+    settings.setValue("capture/threaded", threadedCapture);
+    settings.setValue("capture/queueCapacity", queueCapacity);
+    settings.setValue("capture/overflowPolicy", overflowPolicy);
+    settings.setValue("capture/framePoolCapacity", framePoolCapacity);
+    settings.setValue("capture/frameWidth", frameWidth);
+    settings.setValue("capture/frameHeight", frameHeight);
+    settings.setValue("capture/grayFrames", grayFrames);
+    settings.setValue("capture/decoderThreads", decoderThreads);
+    settings.setValue("capture/decoderThreadMode", decoderThreadMode);
+    settings.setValue("tracker/algorithm", trackerAlgorithm);
+    settings.setValue("tracker/grayTracking", grayTracking);
+    settings.setValue("tracker/associationMethod", associationMethod);
+    settings.setValue("tracker/predictiveTracking", predictiveTracking);
+    settings.setValue("tracker/parallelTracking", parallelTracking);
+    settings.setValue("inference/shared", sharedInference);
+    settings.setValue("inference/maxBatchSize", maxBatchSize);
+    settings.setValue("inference/maxWait", maxBatchWait);
+    settings.setValue("inference/detectionSlots", detectionSlots);
+    settings.setValue("governor/enabled", budgetEnabled);
+    settings.setValue("governor/frameDeadline", frameDeadline);
+    settings.setValue("governor/cpuShare", cpuShare);
+    settings.setValue("pipeline/enabled", pipelined);
 
     objectTracker->setDrawFlags(drawFlags);
     objectTracker->setEnterDirection(static_cast<ObjectTracker::EnterDirection>(enterDirection));
+    objectTracker->setCountingLines(countingLines);
+    objectTracker->setRegionOfInterest(cv::Rect(regionOfInterest.x(), regionOfInterest.y(),
+                                                regionOfInterest.width(), regionOfInterest.height()));
+    objectTracker->setDetectorBackend(static_cast<PersonDetector::Backend>(detectorBackend));
+    objectTracker->setQuantizedDetector(quantizedDetector);
+    objectTracker->setDnnPreference(dnnBackend, dnnTarget);
+    objectTracker->setDetectorThreads(detectorThreads);
+    objectTracker->setInputSize(cv::Size(inputWidth, inputHeight));
+
+    PersonDetector::Tiling tiling;
+    tiling.columns = tileColumns;
+    tiling.rows = tileRows;
+    tiling.overlap = tileOverlap;
+    objectTracker->setTiling(tiling);
+    objectTracker->setDetectionMode(asyncDetection ? ObjectTracker::AsynchronousDetection : ObjectTracker::SynchronousDetection);
+    objectTracker->setAdaptiveDetection(adaptiveDetection);
+    objectTracker->setMotionGating(motionGating);
+    objectTracker->setTrackerAlgorithm(static_cast<TrackedObject::Algorithm>(trackerAlgorithm));
+    objectTracker->setGrayTracking(grayTracking);
+    objectTracker->setAssociationMethod(static_cast<TrackAssociator::Method>(associationMethod));
+    objectTracker->setPredictiveTracking(predictiveTracking);
+    objectTracker->setParallelTracking(parallelTracking);
+    objectTracker->setBudget({ budgetEnabled, frameDeadline, cpuShare });
+
+    videoSource->setFramePoolCapacity(framePoolCapacity);
+    videoSource->setQueueCapacity(queueCapacity);
+    videoSource->setOverflowPolicy(static_cast<FrameQueue::OverflowPolicy>(overflowPolicy));
+    videoSource->setCaptureMode(threadedCapture ? VideoSource::ThreadedCapture : VideoSource::TimerCapture);
+
+    DetectionSlots::instance().setCapacity(detectionSlots);
+
+    // A running service takes the new batch limits right away
+    InferenceService *inferenceService = objectTracker->getInferenceService();
+
+    if (inferenceService != nullptr) {
+        inferenceService->setMaxBatchSize(maxBatchSize);
+        inferenceService->setMaxWait(maxBatchWait);
+    }
 
     this->close();
 }
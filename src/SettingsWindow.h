@@ -13,9 +13,12 @@
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QPlainTextEdit>
+#include <QSpinBox>
 #include <QWidget>
 
 #include "ObjectTracker.h"
+#include "VideoSource.h"
 
 /**
  * @brief Class stores produces a settings option to change up the object detection, maximum capacity, and many more on the GUI
@@ -25,7 +28,7 @@ class SettingsWindow : public QWidget {
     Q_OBJECT
 
     public:
-        SettingsWindow(ObjectTracker *objectTracker, QWidget *parent = 0);
+        SettingsWindow(ObjectTracker *objectTracker, VideoSource *videoSource, QWidget *parent = 0);
 
         ~SettingsWindow();
 
@@ -34,6 +37,7 @@ class SettingsWindow : public QWidget {
 
     private:
         ObjectTracker *objectTracker;
+        VideoSource *videoSource;
 
         QCheckBox *drawBoundingBoxesCheckBox;
         QCheckBox *drawCentroidsCheckBox;
@@ -41,8 +45,56 @@ class SettingsWindow : public QWidget {
         QCheckBox *showStatesCheckBox;
         QCheckBox *showFrameNumberCheckBox;
         QCheckBox *showFrameStatusCheckBox;
+        QCheckBox *drawTrajectoriesCheckBox;
 
         QComboBox *enterDirectionComboBox;
+        QPlainTextEdit *countingLinesTextEdit;
+
+        QSpinBox *regionXSpinBox;
+        QSpinBox *regionYSpinBox;
+        QSpinBox *regionWidthSpinBox;
+        QSpinBox *regionHeightSpinBox;
+
+        QComboBox *detectorBackendComboBox;
+        QCheckBox *quantizedDetectorCheckBox;
+        QComboBox *dnnBackendComboBox;
+        QComboBox *dnnTargetComboBox;
+        QSpinBox *detectorThreadsSpinBox;
+        QSpinBox *opencvThreadsSpinBox;
+        QSpinBox *inputWidthSpinBox;
+        QSpinBox *inputHeightSpinBox;
+        QSpinBox *tileColumnsSpinBox;
+        QSpinBox *tileRowsSpinBox;
+        QSpinBox *tileOverlapSpinBox;
+        QCheckBox *asyncDetectionCheckBox;
+        QCheckBox *adaptiveDetectionCheckBox;
+        QCheckBox *motionGatingCheckBox;
+
+        QComboBox *trackerAlgorithmComboBox;
+        QCheckBox *grayTrackingCheckBox;
+        QComboBox *associationMethodComboBox;
+        QCheckBox *predictiveTrackingCheckBox;
+        QCheckBox *parallelTrackingCheckBox;
+
+        QCheckBox *sharedInferenceCheckBox;
+        QSpinBox *maxBatchSizeSpinBox;
+        QSpinBox *maxBatchWaitSpinBox;
+        QSpinBox *detectionSlotsSpinBox;
+
+        QCheckBox *budgetCheckBox;
+        QSpinBox *frameDeadlineSpinBox;
+        QSpinBox *cpuShareSpinBox;
+
+        QCheckBox *threadedCaptureCheckBox;
+        QSpinBox *queueCapacitySpinBox;
+        QComboBox *overflowPolicyComboBox;
+        QSpinBox *framePoolCapacitySpinBox;
+        QSpinBox *frameWidthSpinBox;
+        QSpinBox *frameHeightSpinBox;
+        QCheckBox *grayFramesCheckBox;
+        QSpinBox *decoderThreadsSpinBox;
+        QComboBox *decoderThreadModeComboBox;
+        QCheckBox *pipelinedCheckBox;
 };
 
 #endif // SETTINGSWINDOW_H
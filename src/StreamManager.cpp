@@ -0,0 +1,217 @@
+/**
+ * @file StreamManager.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs several video streams, each with its own tracker, on a fixed pool of worker threads
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "StreamManager.h"
+
+#include <algorithm>
+
+#include <QRect>
+#include <QSettings>
+
+/**
+ * @brief Constructs a new StreamManager object without any streams.
+ * @param store the store every stream counts into.
+ * @param workers the maximum number of worker threads running trackers, zero for one per core.
+ * @param parent the parent Qt object of this object.
+ */
+StreamManager::StreamManager(Store *store, const int workers, QObject *parent) : QObject(parent) {
+    this->store = store;
+    maxWorkers = workers > 0 ? workers : std::max(QThread::idealThreadCount(), 1);
+}
+
+/**
+ * @brief Destructs a StreamManager object, stopping every stream and the worker threads.
+ */
+StreamManager::~StreamManager() {
+    stop();
+
+    // Trackers are deleted on their worker threads once the threads finish
+    for (auto& worker : workers) {
+        worker->quit();
+        worker->wait();
+    }
+}
+
+/**
+ * @brief Adds a stream and starts running its tracker on a worker thread. The stream is not opened yet.
+ * Takes ownership of the tracker, which must not have a parent since it is moved to a worker thread.
+ * @param name the name of the stream, e.g. the entrance it films.
+ * @param source a camera index or the path of a video file.
+ * @param objectTracker the configured tracker counting the people in the stream.
+ * @param frameSize the resolution frames are decoded in, empty for the source's own resolution.
+ * @param format the pixel format frames are decoded in.
+ * @return the index of the stream.
+ */
+int StreamManager::addStream(const QString& name, const QString& source, ObjectTracker *objectTracker, const cv::Size frameSize,
+                             const FrameConverter::PixelFormat format) {
+    auto videoSource = new VideoSource(this);
+
+    // Decode on the source's own thread and keep only the latest frame while the worker is busy
+    videoSource->setCaptureMode(VideoSource::ThreadedCapture);
+    videoSource->setQueueCapacity(1);
+    videoSource->setOverflowPolicy(FrameQueue::DropOldest);
+    videoSource->setMaxFramesInFlight(STREAM_MAX_FRAMES_IN_FLIGHT);
+
+    // Start another worker until there are as many as allowed, then share the least busy one
+    int worker = getIdlestWorker();
+
+    if (static_cast<int>(workers.size()) < maxWorkers && (worker < 0 || workerLoads[worker] > 0)) {
+        workers.push_back(std::unique_ptr<QThread>(new QThread));
+        workerLoads.push_back(0);
+
+        worker = static_cast<int>(workers.size()) - 1;
+        workers[worker]->setObjectName(QString("StreamWorker%1").arg(worker));
+        workers[worker]->start();
+    }
+
+    workerLoads[worker]++;
+
+    // Streams only count, nothing is drawn
+    objectTracker->setRenderMode(ObjectTracker::NoRendering);
+    objectTracker->moveToThread(workers[worker].get());
+    connect(workers[worker].get(), &QThread::finished, objectTracker, &QObject::deleteLater);
+
+    // Every finished frame hands a credit back to the source, which then delivers the latest decoded frame
+    connect(videoSource, &VideoSource::frameCaptured, objectTracker, &ObjectTracker::processFrame, Qt::QueuedConnection);
+    connect(objectTracker, &ObjectTracker::frameFinished, videoSource, &VideoSource::frameReleased, Qt::QueuedConnection);
+
+    connect(objectTracker, &ObjectTracker::personEntered, store, &Store::personEntered);
+    connect(objectTracker, &ObjectTracker::personExited, store, &Store::personExited);
+
+    streams.push_back({ name, source, videoSource, objectTracker, worker, frameSize, format });
+
+    return static_cast<int>(streams.size()) - 1;
+}
+
+/**
+ * @brief Adds the streams saved in the settings.
+ * Every stream uses the saved tracker and capture settings, with its own enter direction, counting lines, region of interest,
+ * frame resolution and format and number of decoder threads if set.
+ * @return the number of streams added.
+ */
+int StreamManager::loadStreams() {
+    QSettings settings;
+    const cv::Size frameSize(settings.value("capture/frameWidth", 0).toInt(), settings.value("capture/frameHeight", 0).toInt());
+    const bool grayFrames = settings.value("capture/grayFrames", false).toBool();
+    const int decoderThreads = settings.value("capture/decoderThreads", 0).toInt();
+    const auto decoderThreadMode = static_cast<VideoDecoder::ThreadMode>(settings.value("capture/decoderThreadMode", VideoDecoder::AutoThreads).toUInt());
+    const int count = settings.beginReadArray("streams");
+
+    for (int i = 0; i < count; i++) {
+        settings.setArrayIndex(i);
+
+        auto objectTracker = new ObjectTracker;
+        objectTracker->loadSettings();
+
+        if (settings.contains("enterDirection")) {
+            objectTracker->setEnterDirection(static_cast<ObjectTracker::EnterDirection>(settings.value("enterDirection").toUInt()));
+        }
+
+        if (settings.contains("countingLines")) {
+            objectTracker->setCountingLines(CountingLines::Line::fromStrings(settings.value("countingLines").toStringList()));
+        }
+
+        if (settings.contains("regionOfInterest")) {
+            const auto region = settings.value("regionOfInterest").toRect();
+            objectTracker->setRegionOfInterest(cv::Rect(region.x(), region.y(), region.width(), region.height()));
+        }
+
+        const cv::Size streamFrameSize(settings.value("frameWidth", frameSize.width).toInt(), settings.value("frameHeight", frameSize.height).toInt());
+        const auto format = settings.value("grayFrames", grayFrames).toBool() ? FrameConverter::GrayFormat : FrameConverter::BgrFormat;
+
+        const int stream = addStream(settings.value("name", QString("Stream %1").arg(i + 1)).toString(), settings.value("source").toString(),
+                                     objectTracker, streamFrameSize, format);
+
+        // Decoder threads of every stream add up, so a stream may decode on fewer
+        streams[stream].videoSource->setDecoderOptions({ settings.value("decoderThreads", decoderThreads).toInt(), decoderThreadMode });
+    }
+
+    settings.endArray();
+
+    return count;
+}
+
+/**
+ * @brief Returns the number of streams.
+ * @return the number of streams.
+ */
+int StreamManager::getStreamCount() const {
+    return static_cast<int>(streams.size());
+}
+
+/**
+ * @brief Returns a stream.
+ * @param stream the index of the stream.
+ * @return the stream.
+ */
+const StreamManager::Stream& StreamManager::getStream(const int stream) const {
+    return streams[stream];
+}
+
+/**
+ * @brief Returns the number of worker threads started so far.
+ * @return the number of worker threads.
+ */
+int StreamManager::getWorkerCount() const {
+    return static_cast<int>(workers.size());
+}
+
+/**
+ * @brief Sets the shared inference service every stream submits its background detections to.
+ * @param service the shared inference service, or nullptr for every tracker to detect on its own worker.
+ */
+void StreamManager::setInferenceService(InferenceService *service) {
+    for (auto& stream : streams) {
+        stream.objectTracker->setInferenceService(service);
+    }
+}
+
+/**
+ * @brief Opens the source of a stream and starts playing it.
+ * @param stream the index of the stream.
+ * @return true if the camera or file could be opened.
+ */
+bool StreamManager::open(const int stream) {
+    const auto& entry = streams[stream];
+
+    bool camera = false;
+    const int index = entry.source.toInt(&camera);
+
+    return camera ? entry.videoSource->openCamera(index, DEFAULT_CAPTURE_FPS, entry.frameSize, entry.format)
+                  : entry.videoSource->openFile(entry.source, entry.frameSize, entry.format);
+}
+
+/**
+ * @brief Resumes playing every opened stream.
+ */
+void StreamManager::play() {
+    for (auto& stream : streams) {
+        stream.videoSource->play();
+    }
+}
+
+/**
+ * @brief Stops playing every stream.
+ */
+void StreamManager::stop() {
+    for (auto& stream : streams) {
+        stream.videoSource->stop();
+    }
+}
+
+/**
+ * @brief Returns the worker thread running the fewest streams.
+ * @return the index of the worker, -1 if none was started yet.
+ */
+int StreamManager::getIdlestWorker() const {
+    if (workerLoads.empty()) {
+        return -1;
+    }
+
+    return static_cast<int>(std::min_element(workerLoads.begin(), workerLoads.end()) - workerLoads.begin());
+}
@@ -0,0 +1,104 @@
+/**
+ * @file StreamManager.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Runs several video streams, each with its own tracker, on a fixed pool of worker threads
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef STREAMMANAGER_H
+#define STREAMMANAGER_H
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+#include "InferenceService.h"
+#include "ObjectTracker.h"
+#include "Store.h"
+#include "VideoSource.h"
+
+/**
+ * The maximum number of frames of a stream waiting for or being processed by its worker.
+ * With one, every stream sharing a worker has at most one frame in the worker's queue, so they take turns.
+ */
+#define STREAM_MAX_FRAMES_IN_FLIGHT 1
+
+/**
+ * @brief Runs several video streams, for example one per entrance, in one process.
+ * Every stream has its own video source, tracker and counting configuration, and they all count into one shared
+ * Store. Trackers run on a fixed number of worker threads, each stream is given to the worker running the fewest.
+ * A stream only hands its worker a new frame once the previous one is finished and keeps the latest decoded frame
+ * meanwhile, so streams sharing a worker are served in turn and a slow stream drops frames instead of lagging.
+ * Detection networks are shared between streams through the ModelRegistry, and optionally an InferenceService.
+ */
+class StreamManager : public QObject {
+    Q_OBJECT
+
+    public:
+        /**
+         * A video stream and the tracker counting the people in it.
+         */
+        struct Stream {
+            QString name;
+            // A camera index or the path of a video file
+            QString source;
+            VideoSource *videoSource;
+            ObjectTracker *objectTracker;
+            // The index of the worker thread the tracker runs on
+            int worker;
+            // The resolution and pixel format frames are decoded in, an empty size for the source's own resolution
+            cv::Size frameSize;
+            FrameConverter::PixelFormat format;
+        };
+
+        StreamManager(Store *store, const int workers = 0, QObject *parent = 0);
+
+        ~StreamManager();
+
+        int addStream(const QString& name, const QString& source, ObjectTracker *objectTracker, const cv::Size frameSize = cv::Size(),
+                      const FrameConverter::PixelFormat format = FrameConverter::BgrFormat);
+
+        int loadStreams();
+
+        int getStreamCount() const;
+
+        const Stream& getStream(const int stream) const;
+
+        int getWorkerCount() const;
+
+        void setInferenceService(InferenceService *service);
+
+        bool open(const int stream);
+
+        void play();
+
+        void stop();
+
+    private:
+        int getIdlestWorker() const;
+
+        Store *store;
+
+        std::vector<Stream> streams;
+
+        /**
+         * The worker threads, started as streams are added. Each runs the event loop of the trackers given to it.
+         */
+        std::vector<std::unique_ptr<QThread>> workers;
+
+        /**
+         * The number of streams given to each worker.
+         */
+        std::vector<int> workerLoads;
+
+        /**
+         * The maximum number of worker threads.
+         */
+        int maxWorkers;
+};
+
+#endif // STREAMMANAGER_H
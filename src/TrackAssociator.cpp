@@ -0,0 +1,186 @@
+/**
+ * @file TrackAssociator.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Matches new detections to existing tracks by the overlap of their bounding boxes
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "TrackAssociator.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Matches detections to tracks, each track and each detection being matched at most once.
+ * @param tracks the predicted bounding boxes of the tracks.
+ * @param detections the bounding boxes of the detections.
+ * @param method how detections are assigned to tracks.
+ * @param minOverlap the minimum overlap of a matched pair.
+ * @return the matched pairs of track and detection indices, ordered by track.
+ */
+std::vector<std::pair<int, int>> TrackAssociator::match(const std::vector<cv::Rect>& tracks, const std::vector<cv::Rect>& detections,
+                                                        const TrackAssociator::Method method, const double minOverlap) {
+    if (tracks.empty() || detections.empty()) {
+        return std::vector<std::pair<int, int>>();
+    }
+
+    std::vector<std::vector<double>> overlaps(tracks.size(), std::vector<double>(detections.size()));
+
+    for (std::size_t i = 0; i < tracks.size(); i++) {
+        for (std::size_t j = 0; j < detections.size(); j++) {
+            overlaps[i][j] = overlap(tracks[i], detections[j]);
+        }
+    }
+
+    auto matches = method == Method::HungarianAssociation ? matchHungarian(overlaps, minOverlap) : matchGreedy(overlaps, minOverlap);
+    std::sort(matches.begin(), matches.end());
+
+    return matches;
+}
+
+/**
+ * @brief Returns the overlap of two rectangles as their intersection over union.
+ * @param a the first rectangle.
+ * @param b the second rectangle.
+ * @return the intersection over union, between 0 and 1.
+ */
+double TrackAssociator::overlap(const cv::Rect& a, const cv::Rect& b) {
+    const int intersection = (a & b).area();
+    const int combined = a.area() + b.area() - intersection;
+
+    return combined > 0 ? static_cast<double>(intersection) / combined : 0.0;
+}
+
+/**
+ * @brief Matches the most overlapping unmatched pair until no pair overlaps enough.
+ * @param overlaps the overlap of every track (row) with every detection (column).
+ * @param minOverlap the minimum overlap of a matched pair.
+ * @return the matched pairs of track and detection indices.
+ */
+std::vector<std::pair<int, int>> TrackAssociator::matchGreedy(const std::vector<std::vector<double>>& overlaps, const double minOverlap) {
+    std::vector<std::pair<double, std::pair<int, int>>> candidates;
+
+    for (std::size_t i = 0; i < overlaps.size(); i++) {
+        for (std::size_t j = 0; j < overlaps[i].size(); j++) {
+            if (overlaps[i][j] >= minOverlap) {
+                candidates.push_back(std::make_pair(overlaps[i][j], std::make_pair(static_cast<int>(i), static_cast<int>(j))));
+            }
+        }
+    }
+
+    // Most overlapping first, ties broken by index so the result does not depend on the sort
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<double, std::pair<int, int>>& a,
+                                                       const std::pair<double, std::pair<int, int>>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::vector<bool> trackMatched(overlaps.size(), false);
+    std::vector<bool> detectionMatched(overlaps.front().size(), false);
+    std::vector<std::pair<int, int>> matches;
+
+    for (const auto& candidate : candidates) {
+        const int track = candidate.second.first;
+        const int detection = candidate.second.second;
+
+        if (!trackMatched[track] && !detectionMatched[detection]) {
+            trackMatched[track] = true;
+            detectionMatched[detection] = true;
+            matches.push_back(candidate.second);
+        }
+    }
+
+    return matches;
+}
+
+/**
+ * @brief Finds the assignment maximizing the total overlap with the Hungarian algorithm, in O(n^2 m).
+ * Pairs below the minimum overlap are given the cost of no overlap at all and dropped from the result.
+ * @param overlaps the overlap of every track (row) with every detection (column).
+ * @param minOverlap the minimum overlap of a matched pair.
+ * @return the matched pairs of track and detection indices.
+ */
+std::vector<std::pair<int, int>> TrackAssociator::matchHungarian(const std::vector<std::vector<double>>& overlaps, const double minOverlap) {
+    // The algorithm assigns every row, so rows must not outnumber columns
+    const bool transposed = overlaps.size() > overlaps.front().size();
+    const int n = static_cast<int>(transposed ? overlaps.front().size() : overlaps.size());
+    const int m = static_cast<int>(transposed ? overlaps.size() : overlaps.front().size());
+
+    const auto cost = [&](const int row, const int column) {
+        const double value = transposed ? overlaps[column][row] : overlaps[row][column];
+        return value >= minOverlap ? 1.0 - value : 1.0;
+    };
+
+    // Potentials of rows (u) and columns (v), and the row assigned to each column (p), all 1-based with 0 as a sentinel
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0);
+    std::vector<int> p(m + 1, 0), way(m + 1, 0);
+
+    for (int row = 1; row <= n; row++) {
+        p[0] = row;
+        int column = 0;
+
+        std::vector<double> minimum(m + 1, infinity);
+        std::vector<bool> used(m + 1, false);
+
+        // Grow an alternating path from the new row until it reaches a free column
+        do {
+            used[column] = true;
+
+            const int current = p[column];
+            double delta = infinity;
+            int next = 0;
+
+            for (int j = 1; j <= m; j++) {
+                if (!used[j]) {
+                    const double reduced = cost(current - 1, j - 1) - u[current] - v[j];
+
+                    if (reduced < minimum[j]) {
+                        minimum[j] = reduced;
+                        way[j] = column;
+                    }
+
+                    if (minimum[j] < delta) {
+                        delta = minimum[j];
+                        next = j;
+                    }
+                }
+            }
+
+            for (int j = 0; j <= m; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minimum[j] -= delta;
+                }
+            }
+
+            column = next;
+        } while (p[column] != 0);
+
+        // Flip the path, assigning the new row
+        do {
+            const int previous = way[column];
+            p[column] = p[previous];
+            column = previous;
+        } while (column != 0);
+    }
+
+    std::vector<std::pair<int, int>> matches;
+
+    for (int j = 1; j <= m; j++) {
+        if (p[j] == 0) {
+            continue;
+        }
+
+        const int track = transposed ? j - 1 : p[j] - 1;
+        const int detection = transposed ? p[j] - 1 : j - 1;
+
+        if (overlaps[track][detection] >= minOverlap) {
+            matches.push_back(std::make_pair(track, detection));
+        }
+    }
+
+    return matches;
+}
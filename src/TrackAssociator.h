@@ -0,0 +1,51 @@
+/**
+ * @file TrackAssociator.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Matches new detections to existing tracks by the overlap of their bounding boxes
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef TRACKASSOCIATOR_H
+#define TRACKASSOCIATOR_H
+
+#include <utility>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * The minimum overlap (intersection over union) for a detection to be matched with an existing track.
+ * Matched tracks keep their identifier and inside/outside state.
+ */
+#define MIN_ASSOCIATION_OVERLAP 0.3
+
+/**
+ * @brief Matches new detections to existing tracks by the overlap of their bounding boxes.
+ * Tracks are compared by their predicted bounding boxes, so people moving quickly still overlap their detection.
+ * Pairs overlapping less than the minimum overlap are never matched.
+ */
+class TrackAssociator {
+    public:
+        /**
+         * Enumeration used to specify how detections are assigned to tracks.
+         */
+        enum Method {
+            // Repeatedly match the most overlapping pair, cheap and good enough for sparse scenes
+            GreedyAssociation,
+            // Maximize the total overlap of all matches, resolves crowded scenes where greedy choices conflict
+            HungarianAssociation
+        };
+
+        static std::vector<std::pair<int, int>> match(const std::vector<cv::Rect>& tracks, const std::vector<cv::Rect>& detections,
+                                                      const Method method, const double minOverlap = MIN_ASSOCIATION_OVERLAP);
+
+        static double overlap(const cv::Rect& a, const cv::Rect& b);
+
+    private:
+        static std::vector<std::pair<int, int>> matchGreedy(const std::vector<std::vector<double>>& overlaps, const double minOverlap);
+
+        static std::vector<std::pair<int, int>> matchHungarian(const std::vector<std::vector<double>>& overlaps, const double minOverlap);
+};
+
+#endif // TRACKASSOCIATOR_H
@@ -10,26 +10,66 @@
  */
 #include "TrackedObject.h"
 
+#include <algorithm>
+#include <limits>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
 /**
  * @brief Construct a TrackedObject which will represents/track a person in the video
- * First param is current video frame and second param is the surrounding rectangle of object
- * @param frame 
+ * First param is the current video frame's pyramid and second param is the surrounding rectangle of object
+ * @param pyramid the pyramid of the frame the object was detected in, with a grayscale frame if the tracker reads one
  * @param bbox 
+ * @param id the identifier of the object, kept for as long as it is tracked
+ * @param algorithm the algorithm following the object between detections
+ * @param gray whether the tracker reads the shared grayscale frame instead of the color one
  */
-TrackedObject::TrackedObject(const cv::Mat &frame, const cv::Rect bbox)
+TrackedObject::TrackedObject(const FramePyramid &pyramid, const cv::Rect bbox, const int id, const Algorithm algorithm, const bool gray) : kalman(4, 2, 0, CV_32F)
 {
     // Initialize a tracker with this known bounding box for the object
-    tracker = cv::TrackerKCF::create();
-    tracker->init(frame, bbox);
+    this->algorithm = algorithm;
+    this->gray = gray;
+    initialize(pyramid, bbox);
 
     // Store the initial bounding box
     this->bbox = bbox;
+    this->prediction = bbox;
+    this->id = id;
+
+    // The object was created from a detection
+    this->hits = 1;
+    this->misses = 0;
+    this->coasted = 0;
+    this->residual = std::numeric_limits<double>::infinity();
+    this->stale = false;
+
+    // Constant velocity model, the state is [x, y, vx, vy] of the center and only the center is measured
+    kalman.transitionMatrix = (cv::Mat_<float>(4, 4) << 1, 0, 1, 0,
+                                                        0, 1, 0, 1,
+                                                        0, 0, 1, 0,
+                                                        0, 0, 0, 1);
+    cv::setIdentity(kalman.measurementMatrix);
+    cv::setIdentity(kalman.processNoiseCov, cv::Scalar::all(KALMAN_PROCESS_NOISE));
+    cv::setIdentity(kalman.measurementNoiseCov, cv::Scalar::all(KALMAN_MEASUREMENT_NOISE));
+
+    // The position is known from the detection, the velocity is not
+    const cv::Point2f center = 0.5f * cv::Point2f(bbox.tl() + bbox.br());
+    kalman.statePost = (cv::Mat_<float>(4, 1) << center.x, center.y, 0, 0);
+    kalman.errorCovPost = (cv::Mat_<float>(4, 4) << KALMAN_MEASUREMENT_NOISE, 0, 0, 0,
+                                                    0, KALMAN_MEASUREMENT_NOISE, 0, 0,
+                                                    0, 0, bbox.height, 0,
+                                                    0, 0, 0, bbox.height);
 
     // Objects are initially always located
     this->found = true;
 
     // Objects inside/outside state is initially unknown
     this->state = State::Unknown;
+
+    // The object has not moved yet
+    this->trajectoryHead = 0;
+    this->trajectorySize = 0;
 }
 
 /**
@@ -40,16 +80,392 @@ TrackedObject::~TrackedObject()
 {
 }
 
+/**
+ * @brief Creates a tracker running the given algorithm
+ * MOSSE is only offered by OpenCV's legacy tracking API and is wrapped into the current one
+ * 
+ * @param algorithm 
+ * @return cv::Ptr<cv::Tracker>, empty for the optical flow, which is not an OpenCV tracker
+ */
+cv::Ptr<cv::Tracker> TrackedObject::createTracker(const TrackedObject::Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case Algorithm::MosseTracker:
+        return cv::legacy::upgradeTrackingAPI(cv::legacy::TrackerMOSSE::create());
+    case Algorithm::CsrtTracker:
+        return cv::TrackerCSRT::create();
+    case Algorithm::OpticalFlowTracker:
+        return cv::Ptr<cv::Tracker>();
+    default:
+        return cv::TrackerKCF::create();
+    }
+}
+
+/**
+ * @brief Returns the name of a tracking algorithm
+ * 
+ * @param algorithm 
+ * @return std::string 
+ */
+std::string TrackedObject::getAlgorithmName(const TrackedObject::Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case Algorithm::KcfTracker:
+        return "KCF";
+    case Algorithm::MosseTracker:
+        return "MOSSE";
+    case Algorithm::CsrtTracker:
+        return "CSRT";
+    case Algorithm::OpticalFlowTracker:
+        return "Optical Flow (LK)";
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief Returns whether an algorithm always reads the grayscale frame
+ * MOSSE converts every frame to grayscale on its own, the shared grayscale frame saves it the work
+ * 
+ * @param algorithm 
+ * @return true 
+ * @return false 
+ */
+bool TrackedObject::usesGray(const TrackedObject::Algorithm algorithm)
+{
+    return algorithm == Algorithm::MosseTracker || algorithm == Algorithm::OpticalFlowTracker;
+}
+
+/**
+ * @brief Returns whether an algorithm reads the optical flow pyramid
+ * 
+ * @param algorithm 
+ * @return true 
+ * @return false 
+ */
+bool TrackedObject::usesLevels(const TrackedObject::Algorithm algorithm)
+{
+    return algorithm == Algorithm::OpticalFlowTracker;
+}
+
+/**
+ * @brief Returns the algorithm following the object between detections
+ * 
+ * @return TrackedObject::Algorithm 
+ */
+TrackedObject::Algorithm TrackedObject::getAlgorithm() const
+{
+    return algorithm;
+}
+
+/**
+ * @brief Returns whether the tracker reads the shared grayscale frame
+ * 
+ * @return true 
+ * @return false 
+ */
+bool TrackedObject::isGray() const
+{
+    return gray || usesGray(algorithm);
+}
+
+/**
+ * @brief Returns the identifier of the tracked object
+ * 
+ * @return int 
+ */
+int TrackedObject::getId() const
+{
+    return id;
+}
+
+/**
+ * @brief Predicts where the object is in the next frame
+ * Must be called once per frame, before the object is updated, coasted or matched with a detection
+ */
+void TrackedObject::predict()
+{
+    const cv::Mat state = kalman.predict();
+    const cv::Point center(cvRound(state.at<float>(0)), cvRound(state.at<float>(1)));
+
+    // The filter only models the center, the size is kept from the last known bounding box
+    prediction = cv::Rect(center - cv::Point(bbox.width / 2, bbox.height / 2), bbox.size());
+}
+
+/**
+ * @brief Returns the predicted surrounding rectangle for the current frame
+ * 
+ * @return const cv::Rect& 
+ */
+const cv::Rect &TrackedObject::getPrediction() const
+{
+    return prediction;
+}
+
 /**
  * @brief Updates the tracked object in a new frame
  * 
- * @param frame 
+ * @param previous the pyramid of the frame the object was last updated in, only read by the optical flow
+ * @param current the pyramid of the new frame
+ */
+void TrackedObject::update(const FramePyramid &previous, const FramePyramid &current)
+{
+    coasted = 0;
+
+    // The tracker last saw the object before it was coasted, restart it from where the object is predicted to be
+    if (stale)
+    {
+        initialize(current, prediction);
+
+        bbox = prediction;
+        found = true;
+        stale = false;
+
+        return;
+    }
+
+    if (algorithm == Algorithm::OpticalFlowTracker)
+    {
+        updateFlow(previous, current);
+    }
+    else
+    {
+        // Update the tracked, find the new most likely bounding box for the object
+        // Store whether the tracked could locate the object in the given frame
+        found = tracker->update(getImage(current), bbox);
+    }
+
+    if (found)
+    {
+        // Remember how far the object was from its prediction, a small residual means the motion model holds
+        const cv::Point offset = 0.5 * (bbox.tl() + bbox.br()) - 0.5 * (prediction.tl() + prediction.br());
+        residual = cv::norm(offset) / std::max(bbox.height, 1);
+
+        correct(bbox);
+    }
+    else
+    {
+        residual = std::numeric_limits<double>::infinity();
+    }
+}
+
+/**
+ * @brief Moves the object to its predicted position without running the tracker
+ * Much cheaper than update(), only used while the object is well-conditioned
+ */
+void TrackedObject::coast()
+{
+    bbox = prediction;
+    found = true;
+    stale = true;
+    coasted++;
+}
+
+/**
+ * @brief Restarts tracking the object from a detection it was matched with, keeping its identifier and state
+ * 
+ * @param pyramid the pyramid of the frame the detection was made in
+ * @param bbox the detected surrounding rectangle
+ * @param algorithm the algorithm following the object from now on
+ * @param gray whether the tracker reads the shared grayscale frame from now on
  */
-void TrackedObject::update(cv::Mat &frame)
+void TrackedObject::reinitialize(const FramePyramid &pyramid, const cv::Rect bbox, const Algorithm algorithm, const bool gray)
 {
-    // Update the tracked, find the new most likely bounding box for the object
-    // Store whether the tracked could locate the object in the given frame
-    found = tracker->update(frame, bbox);
+    this->algorithm = algorithm;
+    this->gray = gray;
+    initialize(pyramid, bbox);
+
+    this->bbox = bbox;
+    correct(bbox);
+
+    hits++;
+    misses = 0;
+    coasted = 0;
+    found = true;
+    stale = false;
+}
+
+/**
+ * @brief Records that the object was not matched with any detection of a detection frame
+ * 
+ */
+void TrackedObject::miss()
+{
+    misses++;
+}
+
+/**
+ * @brief Returns the number of consecutive detection frames the object was not matched in
+ * 
+ * @return int 
+ */
+int TrackedObject::getMisses() const
+{
+    return misses;
+}
+
+/**
+ * @brief Returns whether the object moves predictably enough to be moved by prediction alone for the next frame
+ * The object must be confirmed by detections, closely follow its prediction and not have been coasted for too long
+ * 
+ * @return true 
+ * @return false 
+ */
+bool TrackedObject::isWellConditioned() const
+{
+    return hits >= MIN_CONFIRMED_HITS && misses == 0 && coasted < MAX_COASTED_FRAMES && residual <= MAX_PREDICTION_RESIDUAL;
+}
+
+/**
+ * @brief Starts the tracker on a frame from a known surrounding rectangle
+ * 
+ * @param pyramid the pyramid of the frame
+ * @param bbox the surrounding rectangle of the object in the frame
+ */
+void TrackedObject::initialize(const FramePyramid &pyramid, const cv::Rect bbox)
+{
+    if (algorithm == Algorithm::OpticalFlowTracker)
+    {
+        tracker.release();
+        this->bbox = bbox;
+        findCorners(pyramid.getGray());
+
+        return;
+    }
+
+    // Trackers keep features of the image they were initialized with, they must be updated with the same kind
+    tracker = createTracker(algorithm);
+    tracker->init(getImage(pyramid), bbox);
+}
+
+/**
+ * @brief Moves the object by the median motion of its corners between the previous and the current frame
+ * Corners are found again once half of them are lost. The size of the object is kept until the next detection
+ * 
+ * @param previous 
+ * @param current 
+ */
+void TrackedObject::updateFlow(const FramePyramid &previous, const FramePyramid &current)
+{
+    if (corners.empty() || previous.getLevels().empty() || current.getLevels().empty())
+    {
+        found = false;
+        return;
+    }
+
+    std::vector<cv::Point2f> moved;
+    std::vector<uchar> status;
+    std::vector<float> error;
+
+    cv::calcOpticalFlowPyrLK(previous.getLevels(), current.getLevels(), corners, moved, status, error,
+                             cv::Size(FLOW_WINDOW_SIZE, FLOW_WINDOW_SIZE), FLOW_PYRAMID_LEVELS);
+
+    const std::size_t tracked = corners.size();
+    std::vector<float> dx;
+    std::vector<float> dy;
+
+    for (std::size_t i = 0; i < moved.size(); i++)
+    {
+        if (status[i])
+        {
+            dx.push_back(moved[i].x - corners[i].x);
+            dy.push_back(moved[i].y - corners[i].y);
+        }
+    }
+
+    found = static_cast<int>(dx.size()) >= MIN_FLOW_POINTS;
+
+    if (!found)
+    {
+        return;
+    }
+
+    // The median motion ignores corners that drifted onto the background or onto another object
+    const std::size_t middle = dx.size() / 2;
+    std::nth_element(dx.begin(), dx.begin() + middle, dx.end());
+    std::nth_element(dy.begin(), dy.begin() + middle, dy.end());
+
+    const cv::Rect bounds(cv::Point(0, 0), current.getGray().size());
+    const cv::Rect shifted = cv::Rect(cv::Point(cvRound(bbox.x + dx[middle]), cvRound(bbox.y + dy[middle])), bbox.size());
+
+    found = (shifted & bounds).area() > 0;
+    bbox = shifted;
+
+    if (!found)
+    {
+        return;
+    }
+
+    if (2 * dx.size() < tracked)
+    {
+        findCorners(current.getGray());
+        return;
+    }
+
+    std::size_t kept = 0;
+
+    for (std::size_t i = 0; i < moved.size(); i++)
+    {
+        if (status[i])
+        {
+            corners[kept++] = moved[i];
+        }
+    }
+
+    corners.resize(kept);
+}
+
+/**
+ * @brief Finds the corners of the object the optical flow follows
+ * 
+ * @param gray the grayscale frame the object is in
+ */
+void TrackedObject::findCorners(const cv::Mat &gray)
+{
+    corners.clear();
+
+    const cv::Rect area = bbox & cv::Rect(cv::Point(0, 0), gray.size());
+
+    if (area.empty())
+    {
+        return;
+    }
+
+    cv::goodFeaturesToTrack(gray(area), corners, MAX_FLOW_POINTS, 0.01, 3);
+
+    for (auto &corner : corners)
+    {
+        corner += cv::Point2f(area.tl());
+    }
+}
+
+/**
+ * @brief Returns the image the tracker reads from a frame's pyramid
+ * 
+ * @param pyramid 
+ * @return const cv::Mat& the grayscale frame if the tracker reads it, the color frame otherwise
+ */
+const cv::Mat &TrackedObject::getImage(const FramePyramid &pyramid) const
+{
+    if (isGray())
+    {
+        return pyramid.getGray();
+    }
+
+    return pyramid.getFrame();
+}
+
+/**
+ * @brief Corrects the motion model with a measured surrounding rectangle
+ * 
+ * @param measurement 
+ */
+void TrackedObject::correct(const cv::Rect &measurement)
+{
+    const cv::Point2f center = 0.5f * cv::Point2f(measurement.tl() + measurement.br());
+    kalman.correct((cv::Mat_<float>(2, 1) << center.x, center.y));
 }
 
 /**
@@ -72,6 +488,37 @@ cv::Point TrackedObject::getPosition() const
     return 0.5 * (bbox.tl() + bbox.br());
 }
 
+/**
+ * @brief Adds the current position to the object's trajectory, replacing the oldest one once the trajectory is full
+ */
+void TrackedObject::record()
+{
+    trajectoryHead = (trajectoryHead + 1) % TRAJECTORY_LENGTH;
+    trajectory[trajectoryHead] = cv::Point2f(getPosition());
+    trajectorySize = std::min(trajectorySize + 1, TRAJECTORY_LENGTH);
+}
+
+/**
+ * @brief Returns the number of positions in the object's trajectory
+ * 
+ * @return int 
+ */
+int TrackedObject::getTrajectorySize() const
+{
+    return trajectorySize;
+}
+
+/**
+ * @brief Returns a recorded position of the object
+ * 
+ * @param age how many positions were recorded since, 0 for the latest
+ * @return const cv::Point2f& 
+ */
+const cv::Point2f &TrackedObject::getTrajectoryPoint(const int age) const
+{
+    return trajectory[(trajectoryHead + TRAJECTORY_LENGTH - age) % TRAJECTORY_LENGTH];
+}
+
 /**
  * @brief Returns bool which determines if tracked object was found in new frame
  * 
@@ -122,3 +569,34 @@ void TrackedObject::setState(const TrackedObject::State state)
 {
     this->state = state;
 }
+
+/**
+ * @brief Returns the number of counting lines the object keeps its side of
+ * 
+ * @return int 
+ */
+int TrackedObject::getLineSideCount() const
+{
+    return static_cast<int>(lineSides.size());
+}
+
+/**
+ * @brief Returns the side of a counting line the object was counted on and crossed to
+ * 
+ * @param line the index of the line, below getLineSideCount()
+ * @return TrackedObject::LineSide& 
+ */
+TrackedObject::LineSide &TrackedObject::getLineSide(const int line)
+{
+    return lineSides[line];
+}
+
+/**
+ * @brief Forgets the sides of every counting line, e.g. when the lines change
+ * 
+ * @param lines the number of counting lines
+ */
+void TrackedObject::resetLineSides(const int lines)
+{
+    lineSides.assign(lines, { State::Unknown, State::Unknown });
+}
@@ -11,14 +11,61 @@
 #ifndef TRACKEDOBJECT_H
 #define TRACKEDOBJECT_H
 
+#include <array>
 #include <string>
 #include <vector>
 #include <opencv2/opencv.hpp>
 #include <opencv2/tracking.hpp>
+#include <opencv2/tracking/tracking_legacy.hpp>
+
+#include "FramePyramid.h"
+
+/**
+ * The number of detections a track must have been matched with before it may be moved by prediction alone.
+ */
+#define MIN_CONFIRMED_HITS 2
+
+/**
+ * The maximum number of consecutive frames a track is moved by prediction alone before the tracker confirms it again.
+ */
+#define MAX_COASTED_FRAMES 2
+
+/**
+ * The maximum distance, as a fraction of the object's height, between the tracker's last position and the prediction
+ * for it, for the track to count as well-conditioned.
+ */
+#define MAX_PREDICTION_RESIDUAL 0.1
+
+/**
+ * The variance of the motion model's process noise, in pixels squared. Larger values follow changes of speed faster.
+ */
+#define KALMAN_PROCESS_NOISE 1.0
+
+/**
+ * The variance of the measured positions, in pixels squared. Larger values smooth the measurements more.
+ */
+#define KALMAN_MEASUREMENT_NOISE 4.0
+
+/**
+ * The maximum number of corners followed by the optical flow tracker within an object.
+ */
+#define MAX_FLOW_POINTS 50
+
+/**
+ * The minimum number of corners the optical flow must still follow for the object to count as found.
+ */
+#define MIN_FLOW_POINTS 5
+
+/**
+ * The number of recent positions kept for each object.
+ */
+#define TRAJECTORY_LENGTH 32
 
 /**
  * @brief Class represent object being tracked
- * 
+ * Each object has a stable identifier and a constant velocity Kalman filter over its center, which predicts
+ * where the object is in the next frame. The prediction is used to match the object with new detections,
+ * and in place of the tracker while the object moves predictably.
  */
 class TrackedObject {
     public:
@@ -31,25 +78,110 @@ class TrackedObject {
             Inside
         };
 
-        TrackedObject(const cv::Mat& frame, const cv::Rect bbox);
+        /**
+         * The side of one counting line the object was last counted on, and the side it crossed to since.
+         * A crossing is only counted once the object is far enough past the line, so it has to be kept until then.
+         */
+        struct LineSide {
+            State counted;
+            State pending;
+        };
+
+        /**
+         * Enumeration used to specify the algorithm following the object between detections.
+         */
+        enum Algorithm {
+            // Kernelized correlation filter, a balance of cost and robustness
+            KcfTracker,
+            // Minimum output sum of squared error filter, several times cheaper but loses objects more easily
+            MosseTracker,
+            // Discriminative correlation filter with channel and spatial reliability, the most robust and the most expensive
+            CsrtTracker,
+            // Sparse Lucas-Kanade optical flow of corners within the object, reusing the frame's shared pyramid
+            OpticalFlowTracker
+        };
+
+        TrackedObject(const FramePyramid& pyramid, const cv::Rect bbox, const int id = 0, const Algorithm algorithm = KcfTracker, const bool gray = false);
         ~TrackedObject();
 
-        void update(cv::Mat& frame);
+        static cv::Ptr<cv::Tracker> createTracker(const Algorithm algorithm);
+        static std::string getAlgorithmName(const Algorithm algorithm);
+        static bool usesGray(const Algorithm algorithm);
+        static bool usesLevels(const Algorithm algorithm);
+
+        Algorithm getAlgorithm() const;
+        bool isGray() const;
+
+        int getId() const;
+
+        void predict();
+        const cv::Rect& getPrediction() const;
+
+        void update(const FramePyramid& previous, const FramePyramid& current);
+        void coast();
+        void reinitialize(const FramePyramid& pyramid, const cv::Rect bbox, const Algorithm algorithm, const bool gray);
+        void miss();
+
+        int getMisses() const;
+        bool isWellConditioned() const;
+
         const cv::Rect& getBBox() const;
 
         cv::Point getPosition() const;
         bool isFound() const;
 
+        void record();
+        int getTrajectorySize() const;
+        const cv::Point2f& getTrajectoryPoint(const int age) const;
+
         State getState() const;
         std::string getStateString() const;
         void setState(const State state);
 
+        int getLineSideCount() const;
+        LineSide& getLineSide(const int line);
+        void resetLineSides(const int lines);
+
     private:
+        void initialize(const FramePyramid& pyramid, const cv::Rect bbox);
+        void updateFlow(const FramePyramid& previous, const FramePyramid& current);
+        void findCorners(const cv::Mat& gray);
+        const cv::Mat& getImage(const FramePyramid& pyramid) const;
+
+        void correct(const cv::Rect& measurement);
+
         cv::Ptr<cv::Tracker> tracker;
+        Algorithm algorithm;
         cv::Rect bbox;
 
+        // Whether the tracker reads the shared grayscale frame instead of the color one
+        bool gray;
+
+        // The corners followed by the optical flow tracker, in the last frame's coordinates
+        std::vector<cv::Point2f> corners;
+
+        cv::KalmanFilter kalman;
+        cv::Rect prediction;
+
+        int id;
+        int hits;
+        int misses;
+        int coasted;
+        double residual;
+
+        // Whether the tracker was left behind by prediction-only updates and must be reinitialized
+        bool stale;
+
         bool found;
         State state;
+
+        // Ring of the most recent positions, written in place so recording never allocates
+        std::array<cv::Point2f, TRAJECTORY_LENGTH> trajectory;
+        int trajectoryHead;
+        int trajectorySize;
+
+        // The side of every counting line, one entry per line
+        std::vector<LineSide> lineSides;
 };
 
 #endif // TRACKEDOBJECT_H
@@ -0,0 +1,117 @@
+/**
+ * @file TrackingTask.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Updates tracked objects of a frame on a worker pool thread
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "TrackingTask.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs a new TrackingTask object. The task deletes itself once it has run.
+ * @param objects the objects of the frame, shared by every task of the frame.
+ * @param previous the pyramid of the frame the objects were last updated in. Only read.
+ * @param current the pyramid of the frame to update the objects in. Only read.
+ * @param predictive whether well-conditioned objects are moved by their prediction instead of the tracker.
+ * @param next the index of the next object to update, shared by every task of the frame.
+ * @param done released once the task has finished.
+ */
+TrackingTask::TrackingTask(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, QAtomicInt& next, QSemaphore& done)
+    : objects(objects), previous(previous), current(current), predictive(predictive), next(next), done(done) {
+    setAutoDelete(true);
+}
+
+/**
+ * @brief Destructs a TrackingTask object.
+ */
+TrackingTask::~TrackingTask() {
+
+}
+
+/**
+ * @brief Updates objects until none are left, then signals that the task has finished.
+ */
+void TrackingTask::run() {
+    updateNext(objects, previous, current, predictive, next);
+    done.release();
+}
+
+/**
+ * @brief Updates every object in a frame, on the tracking pool and the calling thread if requested.
+ * Returns once every object has been updated.
+ * @param objects the objects to update.
+ * @param previous the pyramid of the frame the objects were last updated in.
+ * @param current the pyramid of the frame to update the objects in.
+ * @param predictive whether well-conditioned objects are moved by their prediction instead of the tracker.
+ * @param parallel whether the updates may be spread over the tracking pool.
+ */
+void TrackingTask::updateAll(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, const bool parallel) {
+    QAtomicInt next(0);
+
+    if (!parallel || static_cast<int>(objects.size()) < MIN_PARALLEL_OBJECTS) {
+        updateNext(objects, previous, current, predictive, next);
+        return;
+    }
+
+    QSemaphore done;
+    QThreadPool& pool = getPool();
+
+    // The calling thread takes its share too, so one task fewer than objects is enough
+    const int tasks = std::min(static_cast<int>(objects.size()) - 1, pool.maxThreadCount());
+
+    for (int i = 0; i < tasks; i++) {
+        pool.start(new TrackingTask(objects, previous, current, predictive, next, done));
+    }
+
+    updateNext(objects, previous, current, predictive, next);
+
+    // Tasks only ever wait for objects, never for each other, so they always finish
+    done.acquire(tasks);
+}
+
+/**
+ * @brief Returns the worker pool shared by the object trackers of every stream.
+ * Separate from the global pool, so threads waiting on the global pool never hold up tracking.
+ * @return the tracking pool, with one thread per core by default.
+ */
+QThreadPool& TrackingTask::getPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+/**
+ * @brief Takes objects from the shared index and updates them until none are left.
+ * @param objects the objects to update.
+ * @param previous the pyramid of the frame the objects were last updated in.
+ * @param current the pyramid of the frame to update the objects in.
+ * @param predictive whether well-conditioned objects are moved by their prediction instead of the tracker.
+ * @param next the index of the next object to update.
+ */
+void TrackingTask::updateNext(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, QAtomicInt& next) {
+    const int count = static_cast<int>(objects.size());
+
+    for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1)) {
+        update(objects[i], previous, current, predictive);
+    }
+}
+
+/**
+ * @brief Moves an object to where it is in the frame.
+ * @param object the object to update.
+ * @param previous the pyramid of the frame the object was last updated in.
+ * @param current the pyramid of the frame to update the object in.
+ * @param predictive whether the object is moved by its prediction instead of the tracker if it is well-conditioned.
+ */
+void TrackingTask::update(TrackedObject& object, const FramePyramid& previous, const FramePyramid& current, const bool predictive) {
+    object.predict();
+
+    // Objects moving predictably skip the tracker, it confirms them again after a few frames
+    if (predictive && object.isWellConditioned()) {
+        object.coast();
+    } else {
+        object.update(previous, current);
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file TrackingTask.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Updates tracked objects of a frame on a worker pool thread
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef TRACKINGTASK_H
+#define TRACKINGTASK_H
+
+#include <vector>
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <opencv2/opencv.hpp>
+
+#include "TrackedObject.h"
+
+/**
+ * The minimum number of tracked objects for their updates to be spread over the tracking pool.
+ * Below this, handing the work to other threads costs more than it saves.
+ */
+#define MIN_PARALLEL_OBJECTS 2
+
+/**
+ * @brief Updates tracked objects of a frame on a worker pool thread.
+ * Every task of a frame, and the thread waiting for them, take objects one by one from a shared index until
+ * none are left, so the load balances itself when some objects take longer than others. Each object is only
+ * updated by one thread and only writes its own state, so the result does not depend on how objects were spread.
+ */
+class TrackingTask : public QRunnable {
+    public:
+        TrackingTask(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, QAtomicInt& next, QSemaphore& done);
+
+        ~TrackingTask();
+
+        void run() override;
+
+        static void updateAll(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, const bool parallel);
+
+        static QThreadPool& getPool();
+
+    private:
+        static void updateNext(std::vector<TrackedObject>& objects, const FramePyramid& previous, const FramePyramid& current, const bool predictive, QAtomicInt& next);
+
+        static void update(TrackedObject& object, const FramePyramid& previous, const FramePyramid& current, const bool predictive);
+
+        std::vector<TrackedObject>& objects;
+        const FramePyramid& previous;
+        const FramePyramid& current;
+        bool predictive;
+
+        /**
+         * The index of the next object to update, shared by every task of the frame.
+         */
+        QAtomicInt& next;
+
+        /**
+         * Released once the task has finished.
+         */
+        QSemaphore& done;
+};
+
+#endif // TRACKINGTASK_H
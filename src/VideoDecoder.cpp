@@ -0,0 +1,299 @@
+/**
+ * @file VideoDecoder.cpp
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decodes video files and cameras, with multi-threaded decoding of files and its own throughput counters
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#include "VideoDecoder.h"
+
+#include <QElapsedTimer>
+
+#include "LibavDecoder.h"
+
+/**
+ * @brief Constructs a new VideoDecoder object, decoding files on one thread per core.
+ */
+VideoDecoder::VideoDecoder() {
+    options = { 0, ThreadMode::AutoThreads };
+    decodedFrames = 0;
+    decodeTime = 0;
+}
+
+/**
+ * @brief Destructs a VideoDecoder object, closing whatever is opened.
+ */
+VideoDecoder::~VideoDecoder() {
+    release();
+}
+
+/**
+ * @brief Returns whether files can be decoded with FFmpeg's libraries directly, with a chosen threading mode.
+ * @return true if built with FFmpeg's libraries.
+ */
+bool VideoDecoder::isLibavAvailable() {
+#ifdef HAVE_LIBAV
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the name of a threading mode, for logs and display.
+ * @param mode the threading mode.
+ * @return the name of the threading mode.
+ */
+std::string VideoDecoder::getThreadModeName(const VideoDecoder::ThreadMode mode) {
+    switch (mode) {
+        case FrameThreads:
+            return "Frame";
+        case SliceThreads:
+            return "Slice";
+        default:
+            return "Auto";
+    }
+}
+
+/**
+ * @brief Returns how video files are decoded.
+ * @return the decoding options.
+ */
+VideoDecoder::Options VideoDecoder::getOptions() const {
+    return options;
+}
+
+/**
+ * @brief Sets how video files are decoded. Applies to the next opened file.
+ * @param options the decoding options to set.
+ */
+void VideoDecoder::setOptions(const VideoDecoder::Options& options) {
+    this->options = options;
+}
+
+/**
+ * @brief Opens a video file, with FFmpeg's libraries if available and OpenCV otherwise. Resets the decode counters.
+ * @param filename the path of the video file.
+ * @return true if the file was opened.
+ */
+bool VideoDecoder::open(const std::string& filename) {
+    release();
+    resetCounters();
+
+#ifdef HAVE_LIBAV
+    libav.reset(new LibavDecoder());
+
+    if (libav->open(filename, options)) {
+        return true;
+    }
+
+    // Leave what FFmpeg's libraries cannot open to OpenCV's backends
+    libav.reset();
+#endif
+
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 7)
+    if (capture.open(filename, cv::CAP_FFMPEG, { cv::CAP_PROP_N_THREADS, options.threads })) {
+        return true;
+    }
+#endif
+
+    return capture.open(filename);
+}
+
+/**
+ * @brief Opens a camera through OpenCV. Resets the decode counters.
+ * @param camera the index of the camera.
+ * @return true if the camera was opened.
+ */
+bool VideoDecoder::open(const int camera) {
+    release();
+    resetCounters();
+
+    return capture.open(camera);
+}
+
+/**
+ * @brief Returns whether a file or camera is opened.
+ * @return true if opened.
+ */
+bool VideoDecoder::isOpened() const {
+#ifdef HAVE_LIBAV
+    if (libav) {
+        return libav->isOpened();
+    }
+#endif
+
+    return capture.isOpened();
+}
+
+/**
+ * @brief Closes the opened file or camera.
+ */
+void VideoDecoder::release() {
+#ifdef HAVE_LIBAV
+    libav.reset();
+#endif
+
+    capture.release();
+}
+
+/**
+ * @brief Decodes the next frame and counts the time spent on it.
+ * @param frame receives the frame. A buffer of the right size and type is written in place.
+ * @return false if there are no more frames.
+ */
+bool VideoDecoder::read(cv::Mat& frame) {
+    QElapsedTimer timer;
+    timer.start();
+
+#ifdef HAVE_LIBAV
+    const bool decoded = libav ? libav->read(frame) : capture.read(frame);
+#else
+    const bool decoded = capture.read(frame);
+#endif
+
+    if (decoded) {
+        decodeTime.fetchAndAddRelaxed(static_cast<quint64>(timer.nsecsElapsed()));
+        decodedFrames.fetchAndAddRelaxed(1);
+    }
+
+    return decoded;
+}
+
+/**
+ * @brief Returns a property of the opened file or camera, as cv::VideoCapture::get does.
+ * Files decoded by FFmpeg's libraries report the width, height and OpenCV type frames are delivered in.
+ * @param property the cv::VideoCaptureProperties value.
+ * @return the value of the property, zero if unsupported.
+ */
+double VideoDecoder::get(const int property) const {
+#ifdef HAVE_LIBAV
+    if (!libav) {
+        return capture.get(property);
+    }
+
+    switch (property) {
+        case cv::CAP_PROP_FRAME_WIDTH:
+            return libav->getOutputSize().width;
+        case cv::CAP_PROP_FRAME_HEIGHT:
+            return libav->getOutputSize().height;
+        case cv::CAP_PROP_FPS:
+            return libav->getFps();
+        case cv::CAP_PROP_FRAME_COUNT:
+            return libav->getFrameCount();
+        case cv::CAP_PROP_FORMAT:
+            return libav->getOutputType();
+        default:
+            return 0;
+    }
+#else
+    return capture.get(property);
+#endif
+}
+
+/**
+ * @brief Sets a property of the opened file or camera, as cv::VideoCapture::set does.
+ * Files decoded by FFmpeg's libraries are scaled to any width and height, and converted to CV_8UC1 or CV_8UC3
+ * through CAP_PROP_FORMAT, while decoding. OpenCV's pixel format is left alone, as its raw mode is not a frame.
+ * @param property the cv::VideoCaptureProperties value.
+ * @param value the value to set.
+ * @return true if the property was set.
+ */
+bool VideoDecoder::set(const int property, const double value) {
+#ifdef HAVE_LIBAV
+    if (!libav) {
+        return property != cv::CAP_PROP_FORMAT && capture.set(property, value);
+    }
+
+    const cv::Size size = libav->getOutputSize();
+
+    switch (property) {
+        case cv::CAP_PROP_FRAME_WIDTH:
+            libav->setOutputSize(cv::Size(static_cast<int>(value), size.height));
+            return true;
+        case cv::CAP_PROP_FRAME_HEIGHT:
+            libav->setOutputSize(cv::Size(size.width, static_cast<int>(value)));
+            return true;
+        case cv::CAP_PROP_FORMAT:
+            return libav->setOutputType(static_cast<int>(value));
+        default:
+            return false;
+    }
+#else
+    return property != cv::CAP_PROP_FORMAT && capture.set(property, value);
+#endif
+}
+
+/**
+ * @brief Returns the name of the backend decoding the opened file or camera, for logs and display.
+ * @return the name of the backend, empty if nothing is opened.
+ */
+std::string VideoDecoder::getBackendName() const {
+#ifdef HAVE_LIBAV
+    if (libav) {
+        return "libav (" + getThreadModeName(libav->getThreadMode()) + " threads)";
+    }
+#endif
+
+    if (!capture.isOpened()) {
+        return "";
+    }
+
+    try {
+        return capture.getBackendName();
+    } catch (const cv::Exception&) {
+        return "OpenCV";
+    }
+}
+
+/**
+ * @brief Returns the number of threads decoding the opened file.
+ * @return the number of threads, zero if unknown.
+ */
+int VideoDecoder::getThreadCount() const {
+#ifdef HAVE_LIBAV
+    if (libav) {
+        return libav->getThreadCount();
+    }
+#endif
+
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 7)
+    return static_cast<int>(capture.get(cv::CAP_PROP_N_THREADS));
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Returns the number of frames decoded since the last open or reset. Can be called from any thread.
+ * @return the number of decoded frames.
+ */
+unsigned long long VideoDecoder::getDecodedFrameCount() const {
+    return decodedFrames.loadAcquire();
+}
+
+/**
+ * @brief Returns the time spent decoding since the last open or reset. Can be called from any thread.
+ * @return the decode time, in seconds.
+ */
+double VideoDecoder::getDecodeTime() const {
+    return decodeTime.loadAcquire() / 1e9;
+}
+
+/**
+ * @brief Returns the decoding throughput since the last open or reset, apart from the rest of the processing.
+ * @return the number of frames decoded per second of decoding, zero if nothing was decoded.
+ */
+double VideoDecoder::getDecodeRate() const {
+    const double seconds = getDecodeTime();
+    return seconds > 0 ? getDecodedFrameCount() / seconds : 0.0;
+}
+
+/**
+ * @brief Resets the decoded frame count and decode time.
+ */
+void VideoDecoder::resetCounters() {
+    decodedFrames.storeRelease(0);
+    decodeTime.storeRelease(0);
+}
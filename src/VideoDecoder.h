@@ -0,0 +1,109 @@
+/**
+ * @file VideoDecoder.h
+ * @author Ahmed El Farra , Ahmed Faid , Issar Farid , Ali Ravaee , Muhammad Haris Rafique Zakar
+ * @brief Decodes video files and cameras, with multi-threaded decoding of files and its own throughput counters
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2020
+ */
+#ifndef VIDEODECODER_H
+#define VIDEODECODER_H
+
+#include <memory>
+#include <string>
+
+#include <QAtomicInteger>
+
+#include <opencv2/opencv.hpp>
+
+class LibavDecoder;
+
+/**
+ * @brief Class that decodes frames from a video file or a camera, with the interface of cv::VideoCapture.
+ * Video files are decoded on several threads. When built with FFmpeg's libraries (HAVE_LIBAV), files are decoded
+ * by LibavDecoder, with a chosen number of frame- or slice-level threads, and scaled and converted by the decoder's
+ * scaler. Otherwise, or if that fails, files are decoded by OpenCV, which only takes the number of threads.
+ * Cameras are always captured through OpenCV. The time spent decoding is counted apart from the rest of the
+ * processing, so decoding throughput can be reported on its own.
+ */
+class VideoDecoder {
+    public:
+        /**
+         * Enumeration used to specify how a file's decoding is split between threads.
+         */
+        enum ThreadMode {
+            // Let the decoder choose, frame threads where the codec supports them
+            AutoThreads,
+            // Decode several frames at once, the most throughput for a frame of added latency per thread
+            FrameThreads,
+            // Decode the slices of each frame at once, without added latency but only for codecs and files with slices
+            SliceThreads
+        };
+
+        /**
+         * How video files are decoded. Applies to the next opened file.
+         */
+        struct Options {
+            // The number of decoding threads, zero for one per core
+            int threads;
+            ThreadMode mode;
+        };
+
+        VideoDecoder();
+
+        ~VideoDecoder();
+
+        static bool isLibavAvailable();
+
+        static std::string getThreadModeName(const ThreadMode mode);
+
+        Options getOptions() const;
+
+        void setOptions(const Options& options);
+
+        bool open(const std::string& filename);
+
+        bool open(const int camera);
+
+        bool isOpened() const;
+
+        void release();
+
+        bool read(cv::Mat& frame);
+
+        double get(const int property) const;
+
+        bool set(const int property, const double value);
+
+        std::string getBackendName() const;
+
+        int getThreadCount() const;
+
+        unsigned long long getDecodedFrameCount() const;
+
+        double getDecodeTime() const;
+
+        double getDecodeRate() const;
+
+        void resetCounters();
+
+    private:
+        Options options;
+
+        cv::VideoCapture capture;
+
+#ifdef HAVE_LIBAV
+        /**
+         * Decodes the opened file when built with FFmpeg's libraries, null while OpenCV decodes.
+         */
+        std::unique_ptr<LibavDecoder> libav;
+#endif
+
+        /**
+         * The number of frames decoded and the time spent decoding them in nanoseconds, read from other threads.
+         */
+        QAtomicInteger<quint64> decodedFrames;
+        QAtomicInteger<quint64> decodeTime;
+};
+
+#endif // VIDEODECODER_H
@@ -8,14 +8,30 @@
  */
 #include "VideoSource.h"
 
+#include <algorithm>
+#include <cmath>
+
 /**
  * @brief Constructor for VideoSource object. Sets clock to time video
  * 
  * @param parent 
  */
 VideoSource::VideoSource(QObject *parent) : QObject(parent) {
+    fps = DEFAULT_CAPTURE_FPS;
+    captureMode = CaptureMode::TimerCapture;
+    framesInFlight = 0;
+    maxFramesInFlight = 0;
+
     timer.setTimerType(Qt::PreciseTimer);
     connect(&timer, &QTimer::timeout, this, &VideoSource::captureFrame);
+
+    // The capture thread posts at most one queued delivery at a time, frames are then emitted on our own thread
+    captureThread = new CaptureThread(&capture, &converter, &pool, &queue, this);
+    connect(captureThread, &CaptureThread::frameQueued, this, [this]() {
+        if (deliveryPending.testAndSetOrdered(0, 1)) {
+            QMetaObject::invokeMethod(this, "deliverFrame", Qt::QueuedConnection);
+        }
+    }, Qt::DirectConnection);
 }
 
 /**
@@ -23,17 +39,27 @@ VideoSource::VideoSource(QObject *parent) : QObject(parent) {
  * 
  */
 VideoSource::~VideoSource() {
-
+    // The capture thread refers to our capture, pool and queue, so it has to go before they do
+    stop();
+    delete captureThread;
 }
 
 /**
  * @brief Opens video file and records video fps
- * 
+ * Frames are delivered in the given resolution and pixel format, converted right after decoding.
  * @param filepath 
+ * @param frameSize the resolution frames are processed in, empty for the video's own resolution.
+ * @param format the pixel format frames are processed in.
  */
-bool VideoSource::openFile(const QString filepath) {
+bool VideoSource::openFile(const QString filepath, const cv::Size frameSize, const FrameConverter::PixelFormat format) {
+    // The capture thread must not be decoding while the capture is reopened
+    stop();
+    queue.clear();
+
     if (capture.open(filepath.toStdString())) {
-        fps = capture.get(cv::CAP_PROP_FPS);
+        fps = toCaptureFps(capture.get(cv::CAP_PROP_FPS));
+        converter.configure(capture, frameSize, format);
+        reserveFrames();
         play();
         return true;
     } else {
@@ -44,13 +70,20 @@ bool VideoSource::openFile(const QString filepath) {
 
 /**
  * @brief Starts recording from live camera footage and records footage fps
- * 
+ * The camera is asked to capture in the given resolution, frames are converted right after decoding otherwise.
  * @param camera 
  * @param captureFPS 
+ * @param frameSize the resolution frames are processed in, empty for the camera's default resolution.
+ * @param format the pixel format frames are processed in.
  */
-bool VideoSource::openCamera(const int camera, const int captureFPS) {
+bool VideoSource::openCamera(const int camera, const int captureFPS, const cv::Size frameSize, const FrameConverter::PixelFormat format) {
+    stop();
+    queue.clear();
+
     if (capture.open(camera)) {
-        fps = captureFPS;
+        fps = toCaptureFps(captureFPS);
+        converter.configure(capture, frameSize, format);
+        reserveFrames();
         play();
         return true;
     } else {
@@ -59,12 +92,201 @@ bool VideoSource::openCamera(const int camera, const int captureFPS) {
     }
 }
 
+/**
+ * @brief Converts a reported frame rate to the one frames are paced at.
+ * Files without a rate report zero or NaN, and a bogus rate would pace frames at zero-millisecond intervals.
+ * @param rate the frame rate reported by the capture or requested by the caller.
+ * @return the rounded rate, DEFAULT_CAPTURE_FPS if it is not a finite rate of at least one frame per second.
+ */
+int VideoSource::toCaptureFps(const double rate) {
+    if (!std::isfinite(rate) || rate < 1) {
+        return DEFAULT_CAPTURE_FPS;
+    }
+
+    return static_cast<int>(std::lround(std::min(rate, static_cast<double>(MAX_CAPTURE_FPS))));
+}
+
+/**
+ * @brief Returns the converter frames are decoded through, e.g. to report the resolution and format they are processed in.
+ * @return the frame converter.
+ */
+const FrameConverter& VideoSource::getFrameConverter() const {
+    return converter;
+}
+
+/**
+ * @brief Returns how video files are decoded.
+ * @return the decoding options.
+ */
+VideoDecoder::Options VideoSource::getDecoderOptions() const {
+    return capture.getOptions();
+}
+
+/**
+ * @brief Sets the number of threads video files are decoded on and how decoding is split between them.
+ * Applies to the next opened file.
+ * @param options the decoding options to set.
+ */
+void VideoSource::setDecoderOptions(const VideoDecoder::Options& options) {
+    capture.setOptions(options);
+}
+
+/**
+ * @brief Returns the decoder frames are read from, e.g. to report its backend and decoding throughput.
+ * @return the decoder.
+ */
+const VideoDecoder& VideoSource::getDecoder() const {
+    return capture;
+}
+
+/**
+ * @brief Returns the currently set capture mode.
+ * @return the currently set capture mode.
+ */
+VideoSource::CaptureMode VideoSource::getCaptureMode() const {
+    return captureMode;
+}
+
+/**
+ * @brief Sets where frames are decoded. Playback is restarted in the new mode if it was running.
+ * @param mode the capture mode to set.
+ */
+void VideoSource::setCaptureMode(const VideoSource::CaptureMode mode) {
+    if (mode == captureMode) {
+        return;
+    }
+
+    const bool playing = timer.isActive() || captureThread->isRunning();
+
+    stop();
+    captureMode = mode;
+
+    if (playing) {
+        play();
+    }
+}
+
+/**
+ * @brief Returns the maximum number of decoded frames waiting for delivery in threaded capture mode.
+ * @return the capacity of the frame queue.
+ */
+int VideoSource::getQueueCapacity() const {
+    return queue.getCapacity();
+}
+
+/**
+ * @brief Sets the maximum number of decoded frames waiting for delivery in threaded capture mode.
+ * @param capacity the capacity of the frame queue, one for a latest-frame mailbox.
+ */
+void VideoSource::setQueueCapacity(const int capacity) {
+    queue.setCapacity(capacity);
+}
+
+/**
+ * @brief Returns the policy applied when the frame queue is full.
+ * @return the currently set overflow policy.
+ */
+FrameQueue::OverflowPolicy VideoSource::getOverflowPolicy() const {
+    return queue.getOverflowPolicy();
+}
+
+/**
+ * @brief Sets the policy applied when the capture thread decodes a frame into a full queue.
+ * @param policy the overflow policy to set.
+ */
+void VideoSource::setOverflowPolicy(const FrameQueue::OverflowPolicy policy) {
+    queue.setOverflowPolicy(policy);
+}
+
+/**
+ * @brief Returns the number of decoded frames dropped by the overflow policy.
+ * @return the number of dropped frames.
+ */
+unsigned long long VideoSource::getDroppedFrameCount() const {
+    return queue.getDroppedFrameCount();
+}
+
+/**
+ * @brief Returns the number of times the capture thread had to wait for the consumer (Block policy).
+ * @return the number of blocked pushes.
+ */
+unsigned long long VideoSource::getBlockedPushCount() const {
+    return queue.getBlockedPushCount();
+}
+
+/**
+ * @brief Returns the number of buffers frames are decoded into.
+ * @return the capacity of the frame pool.
+ */
+int VideoSource::getFramePoolCapacity() const {
+    return pool.getCapacity();
+}
+
+/**
+ * @brief Sets the number of buffers frames are decoded into.
+ * Should be at least the queue capacity plus the frames in flight plus one, or capture will wait on the pool.
+ * @param capacity the capacity of the frame pool.
+ */
+void VideoSource::setFramePoolCapacity(const int capacity) {
+    if (capacity == pool.getCapacity()) {
+        return;
+    }
+
+    // The capture thread must not be acquiring from the pool while its buffers are replaced
+    const bool playing = timer.isActive() || captureThread->isRunning();
+
+    stop();
+    pool.setCapacity(capacity);
+    reserveFrames();
+
+    if (playing) {
+        play();
+    }
+}
+
+/**
+ * @brief Returns the frame pool, e.g. to report its occupancy.
+ * @return the frame pool.
+ */
+const FramePool& VideoSource::getFramePool() const {
+    return pool;
+}
+
+/**
+ * @brief Returns the maximum number of frames allowed in flight through the processing chain.
+ * @return the maximum number of frames in flight, zero if unlimited.
+ */
+int VideoSource::getMaxFramesInFlight() const {
+    return maxFramesInFlight;
+}
+
+/**
+ * @brief Limits the number of emitted frames that have not been released yet.
+ * Once the limit is reached, no further frames are emitted until frameReleased() is called, which
+ * propagates backpressure from the last stage of a pipelined processing chain back to the capture.
+ * @param maxFrames the maximum number of frames in flight, zero to disable the limit.
+ */
+void VideoSource::setMaxFramesInFlight(const int maxFrames) {
+    maxFramesInFlight = maxFrames;
+    framesInFlight = 0;
+}
+
 /**
  * @brief plays the video/live video
  * 
  */
 void VideoSource::play() {
-    if (capture.isOpened()) {
+    if (!capture.isOpened()) {
+        return;
+    }
+
+    if (captureMode == CaptureMode::ThreadedCapture) {
+        if (!captureThread->isRunning()) {
+            queue.reopen();
+            captureThread->setFrameInterval(1000 / fps);
+            captureThread->start();
+        }
+    } else {
         timer.start(1000 / fps);
     }
 }
@@ -75,6 +297,13 @@ void VideoSource::play() {
  */
 void VideoSource::stop() {
     timer.stop();
+
+    // Closing the queue releases the capture thread if it is blocked on a full queue
+    if (captureThread->isRunning()) {
+        captureThread->requestInterruption();
+        queue.close();
+        captureThread->wait();
+    }
 }
 
 /**
@@ -82,9 +311,80 @@ void VideoSource::stop() {
  * 
  */
 void VideoSource::captureFrame() {
-    if (capture.read(frame)) {
+    // Hold back while the processing chain is full
+    if (maxFramesInFlight > 0 && framesInFlight >= maxFramesInFlight) {
+        return;
+    }
+
+    // Decode into a free pooled buffer, skip this tick if every buffer is still in use
+    FrameHandle frame = pool.acquire();
+
+    if (frame.isNull()) {
+        return;
+    }
+
+    if (converter.read(capture, frame.mat())) {
+        if (maxFramesInFlight > 0) {
+            framesInFlight++;
+        }
+
         emit frameCaptured(frame);
     } else {
         stop();
     }
 }
+
+/**
+ * @brief delivers the next frame decoded by the capture thread
+ * 
+ */
+void VideoSource::deliverFrame() {
+    deliveryPending.storeRelease(0);
+
+    // Leave the frame queued while the processing chain is full, frameReleased() resumes delivery
+    if (maxFramesInFlight > 0 && framesInFlight >= maxFramesInFlight) {
+        return;
+    }
+
+    FrameHandle queued;
+
+    if (queue.pop(queued)) {
+        if (maxFramesInFlight > 0) {
+            framesInFlight++;
+        }
+
+        emit frameCaptured(queued);
+    }
+
+    // Keep draining while frames are left, one event at a time so the event loop stays responsive
+    if (queue.size() > 0 && deliveryPending.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "deliverFrame", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief notifies the source that the last stage has finished with a frame
+ * 
+ */
+void VideoSource::frameReleased() {
+    if (framesInFlight > 0) {
+        framesInFlight--;
+    }
+
+    // Resume delivery of frames held back by the capture thread
+    if (queue.size() > 0 && deliveryPending.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "deliverFrame", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief allocates the pooled buffers for the size of the opened capture
+ * 
+ */
+void VideoSource::reserveFrames() {
+    const auto size = converter.getFrameSize();
+
+    if (size.width > 0 && size.height > 0) {
+        pool.reserve(size, converter.getFrameType());
+    }
+}
@@ -9,14 +9,26 @@
 #ifndef VIDEOSOURCE_H
 #define VIDEOSOURCE_H
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QString>
 #include <QTimer>
 
 #include <opencv2/opencv.hpp>
 
+#include "CaptureThread.h"
+#include "FrameConverter.h"
+#include "FramePool.h"
+#include "FrameQueue.h"
+#include "VideoDecoder.h"
+
 #define DEFAULT_CAPTURE_FPS 24
 
+/**
+ * The highest frame rate frames are paced at, so the frame interval never rounds down to zero milliseconds.
+ */
+#define MAX_CAPTURE_FPS 1000
+
 /**
  * @brief Class which feeds the video/video frames to the object tracker
  * 
@@ -25,32 +37,118 @@ class VideoSource : public QObject {
     Q_OBJECT
 
     public:
+        /**
+         * Enumeration used to specify where frames are decoded.
+         */
+        enum CaptureMode {
+            // Decode on the thread owning the VideoSource, driven by a timer
+            TimerCapture,
+            // Decode on a dedicated capture thread feeding a bounded frame queue
+            ThreadedCapture
+        };
+
         VideoSource(QObject *parent = 0);
 
         ~VideoSource();
 
-        bool openFile(const QString filepath);
+        bool openFile(const QString filepath, const cv::Size frameSize = cv::Size(), const FrameConverter::PixelFormat format = FrameConverter::BgrFormat);
+
+        bool openCamera(const int camera, const int captureFPS = DEFAULT_CAPTURE_FPS, const cv::Size frameSize = cv::Size(),
+                        const FrameConverter::PixelFormat format = FrameConverter::BgrFormat);
+
+        const FrameConverter& getFrameConverter() const;
+
+        VideoDecoder::Options getDecoderOptions() const;
+
+        void setDecoderOptions(const VideoDecoder::Options& options);
+
+        const VideoDecoder& getDecoder() const;
+
+        CaptureMode getCaptureMode() const;
+
+        void setCaptureMode(const CaptureMode mode);
+
+        int getQueueCapacity() const;
+
+        void setQueueCapacity(const int capacity);
+
+        FrameQueue::OverflowPolicy getOverflowPolicy() const;
+
+        void setOverflowPolicy(const FrameQueue::OverflowPolicy policy);
+
+        unsigned long long getDroppedFrameCount() const;
 
-        bool openCamera(const int camera, const int captureFPS = DEFAULT_CAPTURE_FPS);
+        unsigned long long getBlockedPushCount() const;
+
+        int getFramePoolCapacity() const;
+
+        void setFramePoolCapacity(const int capacity);
+
+        const FramePool& getFramePool() const;
+
+        int getMaxFramesInFlight() const;
+
+        void setMaxFramesInFlight(const int maxFrames);
 
         void play();
 
         void stop();
 
+    public slots:
+        void frameReleased();
+
     signals:
-        void frameCaptured(const cv::Mat& frame);
+        void frameCaptured(FrameHandle frame);
 
     private slots:
         void captureFrame();
 
+        void deliverFrame();
+
     private:
-        cv::VideoCapture capture;
+        static int toCaptureFps(const double rate);
+
+        void reserveFrames();
 
-        cv::Mat frame;
+        VideoDecoder capture;
+
+        /**
+         * Delivers decoded frames in the resolution and pixel format they are processed in, whichever thread decodes them.
+         */
+        FrameConverter converter;
 
         QTimer timer;
 
         int fps;
+
+        CaptureMode captureMode;
+
+        /**
+         * Recycled buffers every frame is decoded into, whichever thread decodes it.
+         */
+        FramePool pool;
+
+        /**
+         * Frames decoded by the capture thread waiting to be delivered.
+         */
+        FrameQueue queue;
+
+        CaptureThread *captureThread;
+
+        /**
+         * Set while a deliverFrame call is queued, so at most one delivery event is pending at a time.
+         */
+        QAtomicInt deliveryPending;
+
+        /**
+         * The number of emitted frames not yet released by the end of the processing chain.
+         */
+        int framesInFlight;
+
+        /**
+         * The maximum number of frames allowed in flight before capture is held back. Zero means no limit.
+         */
+        int maxFramesInFlight;
 };
 
 #endif // VIDEOSOURCE_H
@@ -12,8 +12,10 @@
 #include <iostream>
 
 #include <QObject>
+#include <QSettings>
 #include <QThread>
 
+#include "BatchProcessor.h"
 #include "MainWindow.h"
 #include "ObjectTracker.h"
 #include "VideoSource.h"
@@ -30,14 +32,31 @@ Q_DECLARE_METATYPE(cv::Mat)
 int main(int argc, char *argv[]) {
     // Register necessary OpenCV and custom types to work with Qt
     qRegisterMetaType<cv::Mat>();
+    qRegisterMetaType<FrameHandle>();
+    qRegisterMetaType<std::vector<cv::Rect>>("std::vector<cv::Rect>");
+    qRegisterMetaType<PersonDetector::Options>();
+    qRegisterMetaType<PersonDetector::Tiling>();
 
     qRegisterMetaType<ObjectTracker::DrawFlags>();
     qRegisterMetaTypeStreamOperators<ObjectTracker::DrawFlags>();
+    qRegisterMetaType<ObjectTracker::TrackedFrame>();
 
     // Set the organization and application name for the Qt settings system
     QCoreApplication::setOrganizationName("CS3307Group1");
     QCoreApplication::setApplicationName("Headcount");
 
+    // OpenCV's thread count is shared by the whole process, so it is applied once before anything runs
+    PersonDetector::setOpenCvThreads(QSettings().value("inference/opencvThreads", 0).toInt());
+
+    // Process recorded files from the command line without creating any windows
+    for (int i = 1; i < argc; i++) {
+        if (QString(argv[i]) == "--batch") {
+            QCoreApplication app(argc, argv);
+            BatchProcessor processor;
+            return processor.run(app.arguments());
+        }
+    }
+
     QApplication app(argc, argv);
 
     MainWindow window;